@@ -1,5 +1,7 @@
 // Copyright (C) RenZhai.2020.All Rights Reserved.
 #include "Client/HTTPClient.h"
+#include "Core/SimpleHttpStats.h"
+#include "Core/SimpleHttpTrace.h"
 
 SimpleHTTP::HTTP::FHTTPClient::FHTTPClient()
 {
@@ -13,7 +15,16 @@ SimpleHTTP::HTTP::FHTTPClient::FHTTPClient(TSharedPtr<IHTTPClientRequest> InHTTP
 
 bool SimpleHTTP::HTTP::FHTTPClient::Execute(TSharedRef<IHTTPClientRequest> InHTTPRequest) const
 {
-	return InHTTPRequest->ProcessRequest();
+	SimpleHTTP::Trace::EnterPhase(InHTTPRequest->GetHttpRequest(), SimpleHTTP::Trace::EPhase::ConnectAndFirstByte);
+
+	if (InHTTPRequest->ProcessRequest())
+	{
+		SimpleHTTP::FSimpleHttpStats::Get().RequestStarted();
+		return true;
+	}
+
+	SimpleHTTP::Trace::EndSpan(InHTTPRequest->GetHttpRequest());
+	return false;
 }
 
 void SimpleHTTP::HTTP::FHTTPClient::Cancel(TSharedRef<IHTTPClientRequest> InHTTPRequest)
@@ -1,54 +1,447 @@
 // Copyright (C) RenZhai.2020.All Rights Reserved.
 #include "Core/SimpleHTTPMethod.h"
 
+#if PLATFORM_ENABLE_VECTORINTRINSICS_NEON && PLATFORM_CPU_ARM_FAMILY
+	#include <arm_neon.h>
+	#define SIMPLE_HTTP_URL_NEON 1
+#elif PLATFORM_ENABLE_VECTORINTRINSICS && PLATFORM_CPU_X86_FAMILY
+	#include <emmintrin.h>
+	#define SIMPLE_HTTP_URL_SSE2 1
+#endif
+
+#ifndef SIMPLE_HTTP_URL_NEON
+	#define SIMPLE_HTTP_URL_NEON 0
+#endif
+
+#ifndef SIMPLE_HTTP_URL_SSE2
+	#define SIMPLE_HTTP_URL_SSE2 0
+#endif
+
 namespace SimpleHTTP
 {
-	bool IsLegitimateChar(UTF8CHAR LookupChar)
+	namespace URLEncoding
 	{
-		//Infrastructure construction
-		static int8 TemplateChars[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-+=_.~:/#@?&";
-		static bool LegitimateTable[256] = { 0 };
+		//Built once at compile time, one entry per byte
+		struct FLegitimateTable
+		{
+			bool Chars[256];
+
+			constexpr FLegitimateTable(const char* InLegitimateChars)
+				:Chars{}
+			{
+				for (const char* Char = InLegitimateChars; *Char; ++Char)
+				{
+					Chars[static_cast<uint8>(*Char)] = true;
+				}
+			}
+		};
+
+		static constexpr FLegitimateTable URLTable("ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-+=_.~:/#@?&");
+		static constexpr FLegitimateTable ComponentTable("ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_.~");
+
+		static constexpr ANSICHAR HexChars[] = "0123456789ABCDEF";
+
+		static constexpr int32 BlockSize = 16;
+
+		FORCEINLINE const bool* GetTable(ESimpleURLEncoding Encoding)
+		{
+			return Encoding == ESimpleURLEncoding::URL ? URLTable.Chars : ComponentTable.Chars;
+		}
+
+		FORCEINLINE bool IsHexChar(UTF8CHAR Char)
+		{
+			return (Char >= '0' && Char <= '9') || (Char >= 'A' && Char <= 'F') || (Char >= 'a' && Char <= 'f');
+		}
+
+		FORCEINLINE int32 HexValue(UTF8CHAR Char)
+		{
+			return Char <= '9' ? Char - '0' : (Char | 0x20) - 'a' + 10;
+		}
+
+		//A whole URL may already contain valid escapes, they are kept instead of being escaped twice
+		FORCEINLINE bool IsKeptEscape(const UTF8CHAR* InBytes, int32 Index, int32 InNum, ESimpleURLEncoding Encoding)
+		{
+			return Encoding == ESimpleURLEncoding::URL
+				&& InBytes[Index] == '%'
+				&& Index + 2 < InNum
+				&& IsHexChar(InBytes[Index + 1])
+				&& IsHexChar(InBytes[Index + 2]);
+		}
+
+#if SIMPLE_HTTP_URL_SSE2
+		//Lanes set where Lo <= byte <= Hi. SSE2 only has signed compares, so the range is moved to start at -128.
+		FORCEINLINE __m128i InRange(__m128i Bytes, uint8 Lo, uint8 Hi)
+		{
+			const __m128i Shifted = _mm_add_epi8(Bytes, _mm_set1_epi8((char)(uint8)(0x80 - Lo)));
+			return _mm_cmplt_epi8(Shifted, _mm_set1_epi8((char)(uint8)(0x80 + (Hi - Lo + 1))));
+		}
 
-		bool bTableAlreadyUsed = false;
-		if (!bTableAlreadyUsed)
+		FORCEINLINE __m128i Equal(__m128i Bytes, ANSICHAR Char)
 		{
-			//INDEX_NONE to avoid trailing 0
-			for (int32 i = 0; i < UE_ARRAY_COUNT(TemplateChars) - INDEX_NONE; ++i)	
+			return _mm_cmpeq_epi8(Bytes, _mm_set1_epi8(Char));
+		}
+
+		//True when none of the 16 bytes needs escaping
+		FORCEINLINE bool IsLegitimateBlock(const UTF8CHAR* InBytes, ESimpleURLEncoding Encoding)
+		{
+			const __m128i Bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(InBytes));
+
+			__m128i Mask = _mm_or_si128(InRange(Bytes, 'a', 'z'), Equal(Bytes, '_'));
+			Mask = _mm_or_si128(Mask, Equal(Bytes, '~'));
+			if (Encoding == ESimpleURLEncoding::URL)
 			{
-				uint8 LegitimateTableIndex = static_cast<uint8>(TemplateChars[i]);
-				check(LegitimateTableIndex < UE_ARRAY_COUNT(LegitimateTable));
-				LegitimateTable[LegitimateTableIndex] = true;
+				//- . / 0-9 :    ? @ A-Z    = + # &
+				Mask = _mm_or_si128(Mask, InRange(Bytes, '-', ':'));
+				Mask = _mm_or_si128(Mask, InRange(Bytes, '?', 'Z'));
+				Mask = _mm_or_si128(Mask, Equal(Bytes, '='));
+				Mask = _mm_or_si128(Mask, Equal(Bytes, '+'));
+				Mask = _mm_or_si128(Mask, Equal(Bytes, '#'));
+				Mask = _mm_or_si128(Mask, Equal(Bytes, '&'));
+			}
+			else
+			{
+				Mask = _mm_or_si128(Mask, InRange(Bytes, '-', '.'));
+				Mask = _mm_or_si128(Mask, InRange(Bytes, '0', '9'));
+				Mask = _mm_or_si128(Mask, InRange(Bytes, 'A', 'Z'));
 			}
 
-			bTableAlreadyUsed = true;
+			return _mm_movemask_epi8(Mask) == 0xFFFF;
+		}
+
+		template<typename CharType>
+		FORCEINLINE void CopyBlock(const UTF8CHAR* InBytes, CharType* OutChars)
+		{
+			const __m128i Bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(InBytes));
+			if constexpr (sizeof(CharType) == 1)
+			{
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(OutChars), Bytes);
+			}
+			else if constexpr (sizeof(CharType) == 2)
+			{
+				const __m128i Zero = _mm_setzero_si128();
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(OutChars), _mm_unpacklo_epi8(Bytes, Zero));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(OutChars + 8), _mm_unpackhi_epi8(Bytes, Zero));
+			}
+			else
+			{
+				for (int32 i = 0; i < BlockSize; ++i)
+				{
+					OutChars[i] = static_cast<CharType>(InBytes[i]);
+				}
+			}
+		}
+#elif SIMPLE_HTTP_URL_NEON
+		FORCEINLINE uint8x16_t InRange(uint8x16_t Bytes, uint8 Lo, uint8 Hi)
+		{
+			return vcleq_u8(vsubq_u8(Bytes, vdupq_n_u8(Lo)), vdupq_n_u8(Hi - Lo));
 		}
 
-		return LegitimateTable[LookupChar];
+		FORCEINLINE uint8x16_t Equal(uint8x16_t Bytes, ANSICHAR Char)
+		{
+			return vceqq_u8(Bytes, vdupq_n_u8((uint8)Char));
+		}
+
+		FORCEINLINE bool IsLegitimateBlock(const UTF8CHAR* InBytes, ESimpleURLEncoding Encoding)
+		{
+			const uint8x16_t Bytes = vld1q_u8(reinterpret_cast<const uint8*>(InBytes));
+
+			uint8x16_t Mask = vorrq_u8(InRange(Bytes, 'a', 'z'), Equal(Bytes, '_'));
+			Mask = vorrq_u8(Mask, Equal(Bytes, '~'));
+			if (Encoding == ESimpleURLEncoding::URL)
+			{
+				Mask = vorrq_u8(Mask, InRange(Bytes, '-', ':'));
+				Mask = vorrq_u8(Mask, InRange(Bytes, '?', 'Z'));
+				Mask = vorrq_u8(Mask, Equal(Bytes, '='));
+				Mask = vorrq_u8(Mask, Equal(Bytes, '+'));
+				Mask = vorrq_u8(Mask, Equal(Bytes, '#'));
+				Mask = vorrq_u8(Mask, Equal(Bytes, '&'));
+			}
+			else
+			{
+				Mask = vorrq_u8(Mask, InRange(Bytes, '-', '.'));
+				Mask = vorrq_u8(Mask, InRange(Bytes, '0', '9'));
+				Mask = vorrq_u8(Mask, InRange(Bytes, 'A', 'Z'));
+			}
+
+#if PLATFORM_64BITS
+			return vminvq_u8(Mask) == 0xFF;
+#else
+			//vminvq_u8 is AArch64 only, 32-bit ARM folds the halves with pairwise minimums
+			uint8x8_t Min = vpmin_u8(vget_low_u8(Mask), vget_high_u8(Mask));
+			Min = vpmin_u8(Min, Min);
+			Min = vpmin_u8(Min, Min);
+			Min = vpmin_u8(Min, Min);
+			return vget_lane_u8(Min, 0) == 0xFF;
+#endif
+		}
+
+		template<typename CharType>
+		FORCEINLINE void CopyBlock(const UTF8CHAR* InBytes, CharType* OutChars)
+		{
+			const uint8x16_t Bytes = vld1q_u8(reinterpret_cast<const uint8*>(InBytes));
+			if constexpr (sizeof(CharType) == 1)
+			{
+				vst1q_u8(reinterpret_cast<uint8*>(OutChars), Bytes);
+			}
+			else if constexpr (sizeof(CharType) == 2)
+			{
+				vst1q_u16(reinterpret_cast<uint16*>(OutChars), vmovl_u8(vget_low_u8(Bytes)));
+				vst1q_u16(reinterpret_cast<uint16*>(OutChars + 8), vmovl_u8(vget_high_u8(Bytes)));
+			}
+			else
+			{
+				for (int32 i = 0; i < BlockSize; ++i)
+				{
+					OutChars[i] = static_cast<CharType>(InBytes[i]);
+				}
+			}
+		}
+#endif
+
+		template<typename CharType>
+		int32 Encode(const UTF8CHAR* InBytes, int32 InNum, ESimpleURLEncoding Encoding, CharType* OutChars)
+		{
+			const bool* Table = GetTable(Encoding);
+			CharType* Out = OutChars;
+
+			int32 i = 0;
+			while (i < InNum)
+			{
+#if SIMPLE_HTTP_URL_SSE2 || SIMPLE_HTTP_URL_NEON
+				//Most of a URL needs no escaping, so it is copied 16 bytes at a time
+				if (i + BlockSize <= InNum && IsLegitimateBlock(InBytes + i, Encoding))
+				{
+					CopyBlock(InBytes + i, Out);
+					Out += BlockSize;
+					i += BlockSize;
+					continue;
+				}
+#endif
+				const UTF8CHAR ByteToEncode = InBytes[i];
+				if (Table[ByteToEncode] || IsKeptEscape(InBytes, i, InNum, Encoding))
+				{
+					*Out++ = static_cast<CharType>(ByteToEncode);
+				}
+				else if (ByteToEncode == ' ' && Encoding == ESimpleURLEncoding::Form)
+				{
+					*Out++ = static_cast<CharType>('+');
+				}
+				else if (ByteToEncode != 0)
+				{
+					*Out++ = static_cast<CharType>('%');
+					*Out++ = static_cast<CharType>(HexChars[ByteToEncode >> 4]);
+					*Out++ = static_cast<CharType>(HexChars[ByteToEncode & 0xF]);
+				}
+
+				++i;
+			}
+
+			return static_cast<int32>(Out - OutChars);
+		}
+
+		void AppendEncoded(FString &OutString, const TCHAR* InUnencodedString, ESimpleURLEncoding Encoding)
+		{
+			//URL必须在UTF8上编码
+			FTCHARToUTF8 UTF8Converter(InUnencodedString);
+			const UTF8CHAR* UTF8ByteData = (const UTF8CHAR*)UTF8Converter.Get();
+
+			const int32 EncodedLength = GetURLEncodedLength(UTF8ByteData, UTF8Converter.Length(), Encoding);
+			if (EncodedLength == 0)
+			{
+				return;
+			}
+
+			TArray<TCHAR>& CharArray = OutString.GetCharArray();
+			const int32 OldLength = OutString.Len();
+
+			CharArray.SetNumUninitialized(OldLength + EncodedLength + 1, false);
+			URLEncodeTo(UTF8ByteData, UTF8Converter.Length(), Encoding, CharArray.GetData() + OldLength);
+			CharArray[OldLength + EncodedLength] = TEXT('\0');
+		}
 	}
 
-	FString SimpleURLEncode(const TCHAR* InUnencodedString)
+	int32 GetURLEncodedLength(const UTF8CHAR* InBytes, int32 InNum, ESimpleURLEncoding Encoding)
 	{
-		FString OutEncodedString;
-		TCHAR PreallocationBuffer[2] = { 0 };
+		using namespace URLEncoding;
 
-		//URL必须在UTF8上编码
-		FTCHARToUTF8 UTF8Converter(InUnencodedString);   
-		const UTF8CHAR* UTF8ByteData = (UTF8CHAR*)UTF8Converter.Get();    
+		const bool* Table = GetTable(Encoding);
 
-		for (int32 i = 0; i < UTF8Converter.Length(); ++i)
+		int32 Length = 0;
+		for (int32 i = 0; i < InNum; ++i)
 		{
-			UTF8CHAR ByteToEncode = UTF8ByteData[i];
-			if (IsLegitimateChar(ByteToEncode))
+			const UTF8CHAR ByteToEncode = InBytes[i];
+			if (Table[ByteToEncode] || IsKeptEscape(InBytes, i, InNum, Encoding))
 			{
-				PreallocationBuffer[0] = ByteToEncode;
-				OutEncodedString += FString(PreallocationBuffer);
+				Length += 1;
+			}
+			else if (ByteToEncode == ' ' && Encoding == ESimpleURLEncoding::Form)
+			{
+				Length += 1;
 			}
 			else if (ByteToEncode != 0)
 			{
-				OutEncodedString += (TEXT("%") + FString::Printf(TEXT("%.2X"), ByteToEncode));
+				Length += 3;
 			}
 		}
 
+		return Length;
+	}
+
+	int32 URLEncodeTo(const UTF8CHAR* InBytes, int32 InNum, ESimpleURLEncoding Encoding, TCHAR* OutChars)
+	{
+		return URLEncoding::Encode(InBytes, InNum, Encoding, OutChars);
+	}
+
+	int32 URLEncodeTo(const UTF8CHAR* InBytes, int32 InNum, ESimpleURLEncoding Encoding, ANSICHAR* OutChars)
+	{
+		return URLEncoding::Encode(InBytes, InNum, Encoding, OutChars);
+	}
+
+	FString SimpleURLEncode(const TCHAR* InUnencodedString)
+	{
+		FString OutEncodedString;
+		URLEncoding::AppendEncoded(OutEncodedString, InUnencodedString, ESimpleURLEncoding::URL);
+
 		return OutEncodedString;
 	}
-}
\ No newline at end of file
+
+	FString SimpleURLEncodeComponent(const TCHAR* InUnencodedString)
+	{
+		FString OutEncodedString;
+		URLEncoding::AppendEncoded(OutEncodedString, InUnencodedString, ESimpleURLEncoding::Component);
+
+		return OutEncodedString;
+	}
+
+	FString SimpleURLDecode(const TCHAR* InEncodedString, bool bPlusAsSpace)
+	{
+		using namespace URLEncoding;
+
+		FTCHARToUTF8 UTF8Converter(InEncodedString);
+		const UTF8CHAR* InBytes = (const UTF8CHAR*)UTF8Converter.Get();
+		const int32 InNum = UTF8Converter.Length();
+
+		//Decoding never grows the data
+		TArray<UTF8CHAR, TInlineAllocator<256>> DecodedBytes;
+		DecodedBytes.SetNumUninitialized(InNum);
+
+		int32 DecodedNum = 0;
+		for (int32 i = 0; i < InNum; ++i)
+		{
+			const UTF8CHAR ByteToDecode = InBytes[i];
+			if (ByteToDecode == '%' && i + 2 < InNum && IsHexChar(InBytes[i + 1]) && IsHexChar(InBytes[i + 2]))
+			{
+				DecodedBytes[DecodedNum++] = static_cast<UTF8CHAR>((HexValue(InBytes[i + 1]) << 4) | HexValue(InBytes[i + 2]));
+				i += 2;
+			}
+			else if (ByteToDecode == '+' && bPlusAsSpace)
+			{
+				DecodedBytes[DecodedNum++] = static_cast<UTF8CHAR>(' ');
+			}
+			else
+			{
+				DecodedBytes[DecodedNum++] = ByteToDecode;
+			}
+		}
+
+		FUTF8ToTCHAR TCHARConverter((const ANSICHAR*)DecodedBytes.GetData(), DecodedNum);
+		return FString(TCHARConverter.Length(), TCHARConverter.Get());
+	}
+
+	FSimpleURLBuilder::FSimpleURLBuilder(const FString &InBaseURL)
+		:BaseURL(InBaseURL)
+	{
+	}
+
+	FSimpleURLBuilder &FSimpleURLBuilder::AddPath(const FString &Segment)
+	{
+		PathSegments.Add(Segment);
+		return *this;
+	}
+
+	FSimpleURLBuilder &FSimpleURLBuilder::AddQuery(const FString &Key, const FString &Value)
+	{
+		QueryParams.Emplace(Key, Value);
+		return *this;
+	}
+
+	FSimpleURLBuilder &FSimpleURLBuilder::AddQuery(const TMap<FString, FString> &Params)
+	{
+		QueryParams.Reserve(QueryParams.Num() + Params.Num());
+		for (const auto &Tmp : Params)
+		{
+			QueryParams.Emplace(Tmp.Key, Tmp.Value);
+		}
+
+		return *this;
+	}
+
+	void FSimpleURLBuilder::AppendQueryString(FString &OutString) const
+	{
+		bool bFirstParam = true;
+		for (const auto &Tmp : QueryParams)
+		{
+			if (!bFirstParam)
+			{
+				OutString.AppendChar(TEXT('&'));
+			}
+
+			URLEncoding::AppendEncoded(OutString, *Tmp.Key, ESimpleURLEncoding::Component);
+			OutString.AppendChar(TEXT('='));
+			URLEncoding::AppendEncoded(OutString, *Tmp.Value, ESimpleURLEncoding::Component);
+
+			bFirstParam = false;
+		}
+	}
+
+	int32 FSimpleURLBuilder::GetRawQueryLength() const
+	{
+		int32 RawLength = 0;
+		for (const auto &Tmp : QueryParams)
+		{
+			RawLength += Tmp.Key.Len() + Tmp.Value.Len() + 2;
+		}
+
+		return RawLength;
+	}
+
+	FString FSimpleURLBuilder::ToQueryString() const
+	{
+		FString QueryString;
+		QueryString.Reserve(GetRawQueryLength());
+		AppendQueryString(QueryString);
+
+		return QueryString;
+	}
+
+	FString FSimpleURLBuilder::ToString() const
+	{
+		int32 RawLength = BaseURL.Len() + GetRawQueryLength() + 1;
+		for (const auto &Tmp : PathSegments)
+		{
+			RawLength += Tmp.Len() + 1;
+		}
+
+		FString OutURL;
+		OutURL.Reserve(RawLength);
+		OutURL += BaseURL;
+
+		for (const auto &Tmp : PathSegments)
+		{
+			if (!OutURL.EndsWith(TEXT("/")))
+			{
+				OutURL.AppendChar(TEXT('/'));
+			}
+
+			URLEncoding::AppendEncoded(OutURL, *Tmp, ESimpleURLEncoding::Component);
+		}
+
+		if (QueryParams.Num())
+		{
+			OutURL.AppendChar(OutURL.Contains(TEXT("?")) ? TEXT('&') : TEXT('?'));
+			AppendQueryString(OutURL);
+		}
+
+		return OutURL;
+	}
+}
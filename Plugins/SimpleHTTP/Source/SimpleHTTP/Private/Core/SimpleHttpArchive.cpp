@@ -0,0 +1,907 @@
+// Copyright (C) RenZhai.2020.All Rights Reserved.
+#include "Core/SimpleHttpArchive.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Guid.h"
+#include "Misc/Paths.h"
+#include "Runtime/Launch/Resources/Version.h"
+#include "SimpleHTTPLog.h"
+
+THIRD_PARTY_INCLUDES_START
+#include "zlib.h"
+THIRD_PARTY_INCLUDES_END
+
+namespace SimpleHTTP
+{
+	namespace Archive
+	{
+		static const int32 TarBlockSize = 512;
+
+		/*Long names and pax records are held in memory, real ones are far below this*/
+		static const int64 MaxTarMetaSize = 1024 * 1024;
+
+		static const int32 InflateChunkSize = 64 * 1024;
+
+		static const uint32 ZipLocalHeaderSignature = 0x04034b50;
+		static const uint32 ZipCentralHeaderSignature = 0x02014b50;
+		static const uint32 ZipEndSignature = 0x06054b50;
+		static const int32 ZipEndSize = 22;
+
+		static uint16 ReadU16(TArrayView<const uint8> Data, int64 Offset)
+		{
+			return Data[Offset] | (Data[Offset + 1] << 8);
+		}
+
+		static uint32 ReadU32(TArrayView<const uint8> Data, int64 Offset)
+		{
+			return ReadU16(Data, Offset) | ((uint32)ReadU16(Data, Offset + 2) << 16);
+		}
+
+		/*Fixed width text fields are not always terminated*/
+		static FString ReadField(TArrayView<const uint8> Data, int64 Offset, int32 Size)
+		{
+			int32 Len = 0;
+			while (Len < Size && Data[Offset + Len] != 0)
+			{
+				Len++;
+			}
+
+			FUTF8ToTCHAR Converted((const ANSICHAR*)(Data.GetData() + Offset), Len);
+			return FString(Converted.Length(), Converted.Get());
+		}
+
+		static bool ParseOctal(TArrayView<const uint8> Data, int64 Offset, int32 Size, int64 &OutValue)
+		{
+			OutValue = 0;
+			for (int32 i = 0; i < Size; i++)
+			{
+				const uint8 Char = Data[Offset + i];
+				if (Char >= '0' && Char <= '7')
+				{
+					OutValue = (OutValue << 3) | (Char - '0');
+				}
+				else if (Char != ' ' && Char != 0)
+				{
+					//Base-256 sizes of entries past 8GB
+					return false;
+				}
+			}
+
+			return true;
+		}
+
+		bool IsSafeEntryName(const FString &Name)
+		{
+			const FString Normalized = Name.Replace(TEXT("\\"), TEXT("/"));
+			if (Normalized.IsEmpty() || Normalized.StartsWith(TEXT("/")) || Normalized.Contains(TEXT(":")))
+			{
+				return false;
+			}
+
+			TArray<FString> Parts;
+			Normalized.ParseIntoArray(Parts, TEXT("/"));
+			for (const auto &Tmp : Parts)
+			{
+				if (Tmp == TEXT(".."))
+				{
+					return false;
+				}
+			}
+
+			return true;
+		}
+
+		/**
+		 * A hidden directory beside the target that entries are written to.
+		 * Commit moves its content into the target, otherwise it is removed with the object.
+		 */
+		class FStaging
+		{
+		public:
+			FStaging(const FString &InTargetDir)
+				:TargetDir(InTargetDir)
+				,bCommitted(false)
+			{
+				FPaths::NormalizeDirectoryName(TargetDir);
+
+				//Beside the target so that committing is a rename on the same volume
+				StagingDir = FPaths::GetPath(TargetDir) / FString::Printf(TEXT(".%s.%s.extracting"),
+					*FPaths::GetCleanFilename(TargetDir),
+					*FGuid::NewGuid().ToString());
+			}
+
+			~FStaging()
+			{
+				if (!bCommitted)
+				{
+					IFileManager::Get().DeleteDirectory(*StagingDir, false, true);
+				}
+			}
+
+			/*Where a checked entry goes, empty when the name would leave the target*/
+			FString GetEntryPath(const FString &Name, FString &OutError) const
+			{
+				if (!IsSafeEntryName(Name))
+				{
+					OutError = FString::Printf(TEXT("entry [%s] points outside the target directory"), *Name);
+					return FString();
+				}
+
+				return StagingDir / Name.Replace(TEXT("\\"), TEXT("/"));
+			}
+
+			bool Commit(FString &OutError)
+			{
+				IFileManager &FileManager = IFileManager::Get();
+				const FString Prefix = StagingDir + TEXT("/");
+
+				TArray<FString> Directories;
+				TArray<FString> Files;
+				FileManager.IterateDirectoryStatRecursively(*StagingDir, [&](const TCHAR* FilenameOrDirectory, const FFileStatData &StatData)
+				{
+					FString Path = FilenameOrDirectory;
+					FPaths::NormalizeFilename(Path);
+					if (Path.StartsWith(Prefix))
+					{
+						(StatData.bIsDirectory ? Directories : Files).Add(Path.RightChop(Prefix.Len()));
+					}
+
+					return true;
+				});
+
+				FileManager.MakeDirectory(*TargetDir, true);
+				for (const auto &Tmp : Directories)
+				{
+					FileManager.MakeDirectory(*(TargetDir / Tmp), true);
+				}
+
+				for (const auto &Tmp : Files)
+				{
+					if (!FileManager.Move(*(TargetDir / Tmp), *(StagingDir / Tmp), true, true))
+					{
+						OutError = FString::Printf(TEXT("[%s] could not be moved into place"), *(TargetDir / Tmp));
+						return false;
+					}
+				}
+
+				bCommitted = true;
+				FileManager.DeleteDirectory(*StagingDir, false, true);
+
+				return true;
+			}
+
+		private:
+			FString TargetDir;
+			FString StagingDir;
+			bool bCommitted;
+		};
+
+		/*Opens the file of an entry in the staging directory*/
+		static TUniquePtr<FArchive> CreateEntryWriter(const FStaging &Staging, const FString &Name, FString &OutError)
+		{
+			const FString Path = Staging.GetEntryPath(Name, OutError);
+			if (Path.IsEmpty())
+			{
+				return nullptr;
+			}
+
+			TUniquePtr<FArchive> Writer(IFileManager::Get().CreateFileWriter(*Path));
+			if (!Writer.IsValid())
+			{
+				OutError = FString::Printf(TEXT("[%s] could not be written"), *Path);
+			}
+
+			return Writer;
+		}
+
+		static bool CloseEntryWriter(TUniquePtr<FArchive> &Writer, const FString &Name, FString &OutError)
+		{
+			const bool bWritten = Writer->Close() && !Writer->IsError();
+			Writer.Reset();
+
+			if (!bWritten)
+			{
+				OutError = FString::Printf(TEXT("entry [%s] could not be written"), *Name);
+			}
+
+			return bWritten;
+		}
+
+		/**
+		 * zlib inflate over input that arrives in pieces, output is handed on 64KB at a time.
+		 * Nothing is sized from the headers of the stream, so a forged length can not make it allocate.
+		 */
+		class FInflater
+		{
+		public:
+			/*MAX_WBITS + 16 for gzip, -MAX_WBITS for the raw deflate of zip entries*/
+			FInflater(int32 WindowBits)
+				:bFinished(false)
+			{
+				FMemory::Memzero(Stream);
+				bInitialized = inflateInit2(&Stream, WindowBits) == Z_OK;
+
+				Output.SetNumUninitialized(InflateChunkSize);
+			}
+
+			~FInflater()
+			{
+				if (bInitialized)
+				{
+					inflateEnd(&Stream);
+				}
+			}
+
+			/*False on corrupt data, or when Consume returns false after setting OutError itself. Input past the end of the stream is ignored.*/
+			bool Inflate(const uint8 *Data, int64 Num, TFunctionRef<bool(const uint8*, int64)> Consume, FString &OutError)
+			{
+				if (!bInitialized)
+				{
+					OutError = TEXT("zlib could not be initialized");
+					return false;
+				}
+
+				while (Num > 0 && !bFinished)
+				{
+					Stream.next_in = (Bytef*)Data;
+					Stream.avail_in = (uInt)FMath::Min<int64>(Num, MAX_int32);
+					const uInt InputSize = Stream.avail_in;
+
+					do
+					{
+						Stream.next_out = Output.GetData();
+						Stream.avail_out = (uInt)Output.Num();
+
+						const int32 Result = inflate(&Stream, Z_NO_FLUSH);
+						if (Result == Z_STREAM_END)
+						{
+							bFinished = true;
+						}
+						else if (Result != Z_OK && Result != Z_BUF_ERROR)
+						{
+							OutError = FString::Printf(TEXT("the deflated data is corrupt (%d)"), Result);
+							return false;
+						}
+
+						const int64 Produced = Output.Num() - Stream.avail_out;
+						if (Produced > 0 && !Consume(Output.GetData(), Produced))
+						{
+							return false;
+						}
+
+						if (Result == Z_BUF_ERROR && Produced == 0)
+						{
+							break;
+						}
+					}
+					while (!bFinished && (Stream.avail_in > 0 || Stream.avail_out == 0));
+
+					const int64 Consumed = InputSize - Stream.avail_in;
+					if (Consumed == 0 && !bFinished)
+					{
+						OutError = TEXT("the deflated data makes no progress");
+						return false;
+					}
+
+					Data += Consumed;
+					Num -= Consumed;
+				}
+
+				return true;
+			}
+
+			FORCEINLINE bool IsFinished() const { return bFinished; }
+
+		private:
+			z_stream Stream;
+			TArray<uint8> Output;
+			bool bInitialized;
+			bool bFinished;
+		};
+
+		/**
+		 * ustar reader that takes the archive in pieces of any size.
+		 * A header is gathered block by block, the content of a file goes straight to its writer.
+		 */
+		class FTarReader
+		{
+		public:
+			FTarReader(const FStaging &InStaging)
+				:Staging(InStaging)
+				,State(EState::Header)
+				,HeaderFill(0)
+				,Remaining(0)
+				,PaddingLeft(0)
+				,Type(0)
+				,Entries(0)
+			{}
+
+			bool Append(const uint8 *Data, int64 Num, FString &OutError)
+			{
+				while (Num > 0 && State != EState::End)
+				{
+					int64 ChunkSize = 0;
+					if (State == EState::Header)
+					{
+						ChunkSize = FMath::Min<int64>(Num, TarBlockSize - HeaderFill);
+						FMemory::Memcpy(Header + HeaderFill, Data, ChunkSize);
+						HeaderFill += ChunkSize;
+
+						if (HeaderFill == TarBlockSize)
+						{
+							HeaderFill = 0;
+							if (!ReadHeader(OutError))
+							{
+								return false;
+							}
+						}
+					}
+					else if (State == EState::Content)
+					{
+						ChunkSize = FMath::Min(Num, Remaining);
+						if (Writer.IsValid())
+						{
+							Writer->Serialize((void*)Data, ChunkSize);
+						}
+						else if (Type == 'L' || Type == 'x')
+						{
+							Meta.Append(Data, (int32)ChunkSize);
+						}
+
+						Remaining -= ChunkSize;
+						if (Remaining == 0 && !FinishEntry(OutError))
+						{
+							return false;
+						}
+					}
+					else
+					{
+						ChunkSize = FMath::Min(Num, PaddingLeft);
+						PaddingLeft -= ChunkSize;
+						if (PaddingLeft == 0)
+						{
+							State = EState::Header;
+						}
+					}
+
+					Data += ChunkSize;
+					Num -= ChunkSize;
+				}
+
+				return true;
+			}
+
+			/*Without its end block a tar may have been cut between two entries*/
+			bool Finish(FString &OutError) const
+			{
+				if (State != EState::End)
+				{
+					OutError = TEXT("the tar is truncated");
+					return false;
+				}
+
+				return true;
+			}
+
+			FORCEINLINE int32 GetEntries() const { return Entries; }
+
+		private:
+			bool ReadHeader(FString &OutError)
+			{
+				const TArrayView<const uint8> Block(Header, TarBlockSize);
+
+				//Two zero blocks end the archive, one is enough to stop at
+				if (Header[0] == 0)
+				{
+					State = EState::End;
+					return true;
+				}
+
+				if (FMemory::Memcmp(Header + 257, "ustar", 5) != 0)
+				{
+					OutError = TEXT("a tar header is not ustar, the tar is corrupt");
+					return false;
+				}
+
+				int64 Size = 0;
+				if (!ParseOctal(Block, 124, 12, Size))
+				{
+					OutError = TEXT("a tar entry has an unsupported size field");
+					return false;
+				}
+
+				Type = Header[156];
+				Remaining = Size;
+				PaddingLeft = Align(Size, (int64)TarBlockSize) - Size;
+				State = EState::Content;
+
+				if (Type == 'L' || Type == 'x')
+				{
+					if (Size > MaxTarMetaSize)
+					{
+						OutError = FString::Printf(TEXT("a tar name record of %lld bytes is too long"), Size);
+						return false;
+					}
+
+					Meta.Reset((int32)Size);
+				}
+				else
+				{
+					Name = LongName;
+					LongName.Reset();
+
+					if (Name.IsEmpty())
+					{
+						Name = ReadField(Block, 0, 100);
+
+						const FString Prefix = ReadField(Block, 345, 155);
+						if (!Prefix.IsEmpty())
+						{
+							Name = Prefix / Name;
+						}
+					}
+
+					if (Type == '0' || Type == 0)
+					{
+						Writer = CreateEntryWriter(Staging, Name, OutError);
+						if (!Writer.IsValid())
+						{
+							return false;
+						}
+					}
+					else if (Type == '5')
+					{
+						const FString Path = Staging.GetEntryPath(Name, OutError);
+						if (Path.IsEmpty() || !IFileManager::Get().MakeDirectory(*Path, true))
+						{
+							return false;
+						}
+
+						Entries++;
+					}
+					else if (Type != 'g')
+					{
+						UE_LOG(LogSimpleHTTP, Warning, TEXT("Tar entry [%s] of type '%c' is skipped, only files and directories are extracted."), *Name, (TCHAR)Type);
+					}
+				}
+
+				return Remaining > 0 || FinishEntry(OutError);
+			}
+
+			bool FinishEntry(FString &OutError)
+			{
+				State = PaddingLeft > 0 ? EState::Padding : EState::Header;
+
+				if (Type == 'L')
+				{
+					LongName = ReadField(Meta, 0, Meta.Num());
+				}
+				else if (Type == 'x')
+				{
+					//Records are "<length> <key>=<value>\n", only the path is used
+					const FString Records = ReadField(Meta, 0, Meta.Num());
+					TArray<FString> Lines;
+					Records.ParseIntoArrayLines(Lines);
+					for (const auto &Tmp : Lines)
+					{
+						int32 PathIndex = Tmp.Find(TEXT(" path="));
+						if (PathIndex != INDEX_NONE)
+						{
+							LongName = Tmp.Mid(PathIndex + 6);
+						}
+					}
+				}
+				else if (Writer.IsValid())
+				{
+					if (!CloseEntryWriter(Writer, Name, OutError))
+					{
+						return false;
+					}
+
+					Entries++;
+				}
+
+				return true;
+			}
+
+		private:
+			enum class EState : uint8
+			{
+				Header,
+				Content,
+				Padding,
+				End,
+			};
+
+			const FStaging &Staging;
+			EState State;
+
+			uint8 Header[TarBlockSize];
+			int32 HeaderFill;
+
+			/*Of the entry being read*/
+			int64 Remaining;
+			int64 PaddingLeft;
+			uint8 Type;
+			FString Name;
+			TUniquePtr<FArchive> Writer;
+
+			/*Set by GNU long name and pax headers for the entry after them*/
+			TArray<uint8> Meta;
+			FString LongName;
+
+			int32 Entries;
+		};
+
+		static bool ExtractZip(TArrayView<const uint8> Data, const FStaging &Staging, int32 &OutEntries, FString &OutError)
+		{
+			//The central directory has the sizes, local headers may leave them to a trailing descriptor
+			int64 EndOffset = INDEX_NONE;
+			for (int64 i = Data.Num() - ZipEndSize; i >= 0 && i >= Data.Num() - ZipEndSize - MAX_uint16; i--)
+			{
+				if (ReadU32(Data, i) == ZipEndSignature)
+				{
+					EndOffset = i;
+					break;
+				}
+			}
+
+			if (EndOffset == INDEX_NONE)
+			{
+				OutError = TEXT("the zip has no end of central directory, it is truncated");
+				return false;
+			}
+
+			const uint16 EntryNum = ReadU16(Data, EndOffset + 10);
+			const uint32 DirectoryOffset = ReadU32(Data, EndOffset + 16);
+			if (EntryNum == MAX_uint16 || DirectoryOffset == MAX_uint32)
+			{
+				OutError = TEXT("zip64 archives are not supported");
+				return false;
+			}
+
+			int64 Offset = DirectoryOffset;
+			for (int32 i = 0; i < EntryNum; i++)
+			{
+				if (Offset + 46 > Data.Num() || ReadU32(Data, Offset) != ZipCentralHeaderSignature)
+				{
+					OutError = TEXT("the zip central directory is corrupt");
+					return false;
+				}
+
+				const uint16 Flags = ReadU16(Data, Offset + 8);
+				const uint16 Method = ReadU16(Data, Offset + 10);
+				const uint32 Crc32 = ReadU32(Data, Offset + 16);
+				const uint32 CompressedSize = ReadU32(Data, Offset + 20);
+				const uint32 UncompressedSize = ReadU32(Data, Offset + 24);
+				const uint16 NameLen = ReadU16(Data, Offset + 28);
+				const uint16 ExtraLen = ReadU16(Data, Offset + 30);
+				const uint16 CommentLen = ReadU16(Data, Offset + 32);
+				const uint32 LocalOffset = ReadU32(Data, Offset + 42);
+
+				if (Offset + 46 + NameLen > Data.Num())
+				{
+					OutError = TEXT("the zip central directory is corrupt");
+					return false;
+				}
+
+				const FString Name = ReadField(Data, Offset + 46, NameLen);
+				Offset += 46 + NameLen + ExtraLen + CommentLen;
+
+				if (Flags & 1)
+				{
+					OutError = FString::Printf(TEXT("entry [%s] is encrypted"), *Name);
+					return false;
+				}
+
+				//The sizes come from the archive, nothing larger than a TArray can hold is trusted
+				if (UncompressedSize > (uint32)MAX_int32 || CompressedSize > (uint32)MAX_int32)
+				{
+					OutError = FString::Printf(TEXT("entry [%s] is larger than 2GB"), *Name);
+					return false;
+				}
+
+				if ((int64)LocalOffset + 30 > Data.Num() || ReadU32(Data, LocalOffset) != ZipLocalHeaderSignature)
+				{
+					OutError = FString::Printf(TEXT("entry [%s] has no local header"), *Name);
+					return false;
+				}
+
+				const int64 ContentOffset = (int64)LocalOffset + 30 + ReadU16(Data, LocalOffset + 26) + ReadU16(Data, LocalOffset + 28);
+				if (ContentOffset + CompressedSize > Data.Num())
+				{
+					OutError = FString::Printf(TEXT("entry [%s] is truncated"), *Name);
+					return false;
+				}
+
+				const uint8* Content = Data.GetData() + ContentOffset;
+
+				if (Name.EndsWith(TEXT("/")))
+				{
+					const FString Path = Staging.GetEntryPath(Name, OutError);
+					if (Path.IsEmpty() || !IFileManager::Get().MakeDirectory(*Path, true))
+					{
+						return false;
+					}
+				}
+				else if (Method == 0 || Method == 8)
+				{
+					TUniquePtr<FArchive> Writer = CreateEntryWriter(Staging, Name, OutError);
+					if (!Writer.IsValid())
+					{
+						return false;
+					}
+
+					//Summed over what is written, a body that went bad in transit is refused with its staging
+					uLong Crc = crc32(0L, Z_NULL, 0);
+
+					if (Method == 0)
+					{
+						Crc = crc32(Crc, Content, CompressedSize);
+						Writer->Serialize((void*)Content, CompressedSize);
+					}
+					else
+					{
+						//Inflated into the file a piece at a time and held to the size the directory declares
+						int64 Inflated = 0;
+						FInflater Inflater(-MAX_WBITS);
+						const bool bInflated = Inflater.Inflate(Content, CompressedSize, [&](const uint8 *Output, int64 OutputNum)
+						{
+							Inflated += OutputNum;
+							if (Inflated > UncompressedSize)
+							{
+								OutError = FString::Printf(TEXT("entry [%s] inflates past its declared size"), *Name);
+								return false;
+							}
+
+							Crc = crc32(Crc, Output, (uInt)OutputNum);
+							Writer->Serialize((void*)Output, OutputNum);
+							return true;
+						}, OutError);
+
+						if (!bInflated)
+						{
+							return false;
+						}
+
+						if (!Inflater.IsFinished() || Inflated != UncompressedSize)
+						{
+							OutError = FString::Printf(TEXT("entry [%s] could not be inflated"), *Name);
+							return false;
+						}
+					}
+
+					if (!CloseEntryWriter(Writer, Name, OutError))
+					{
+						return false;
+					}
+
+					if ((uint32)Crc != Crc32)
+					{
+						OutError = FString::Printf(TEXT("entry [%s] fails its CRC-32 check"), *Name);
+						return false;
+					}
+				}
+				else
+				{
+					OutError = FString::Printf(TEXT("entry [%s] uses compression method %d"), *Name, Method);
+					return false;
+				}
+
+				OutEntries++;
+			}
+
+			return true;
+		}
+
+#if (ENGINE_MAJOR_VERSION > 5 || (ENGINE_MAJOR_VERSION == 5 && ENGINE_MINOR_VERSION >= 2))
+		/*What the transport writes the body into, on the HTTP thread*/
+		class FReceiveArchive : public FArchive
+		{
+		public:
+			FReceiveArchive(TSharedRef<FStreamExtractor, ESPMode::ThreadSafe> InExtractor)
+				:Extractor(InExtractor)
+				,Position(0)
+			{
+				SetIsSaving(true);
+				SetIsPersistent(false);
+			}
+
+			virtual void Serialize(void* Data, int64 Num) override
+			{
+				//The transport stops the download once the archive can not be extracted
+				if (!Extractor->Append((const uint8*)Data, Num) && !IsError())
+				{
+					UE_LOG(LogSimpleHTTP, Error, TEXT("The archive stopped extracting while it arrived: %s."), *Extractor->GetError());
+					SetError();
+				}
+
+				Position += Num;
+			}
+
+			virtual int64 Tell() override
+			{
+				return Position;
+			}
+
+			virtual int64 TotalSize() override
+			{
+				return Position;
+			}
+
+			virtual FString GetArchiveName() const override
+			{
+				return TEXT("SimpleHttpArchiveExtractor");
+			}
+
+		private:
+			TSharedRef<FStreamExtractor, ESPMode::ThreadSafe> Extractor;
+			int64 Position;
+		};
+#endif
+
+		FStreamExtractor::FStreamExtractor(const FString &InTargetDir)
+			:Staging(MakeUnique<FStaging>(InTargetDir))
+			,Format(EFormat::Unknown)
+			,bAttached(false)
+			,bFailed(false)
+			,ReceivedBytes(0)
+		{
+		}
+
+		FStreamExtractor::~FStreamExtractor()
+		{
+			//Writers hold files open in the staging directory
+			Tar.Reset();
+			Staging.Reset();
+		}
+
+		bool FStreamExtractor::AttachTo(IHttpRequest &Request)
+		{
+#if (ENGINE_MAJOR_VERSION > 5 || (ENGINE_MAJOR_VERSION == 5 && ENGINE_MINOR_VERSION >= 2))
+			bAttached = Request.SetResponseBodyReceiveStream(MakeShared<FReceiveArchive>(AsShared()));
+#endif
+			return bAttached;
+		}
+
+		bool FStreamExtractor::Append(const uint8 *Data, int64 Num)
+		{
+			if (bFailed)
+			{
+				return false;
+			}
+
+			ReceivedBytes += Num;
+
+			if (Format == EFormat::Unknown || Format == EFormat::Zip)
+			{
+				if (Buffered.Num() + Num > MAX_int32)
+				{
+					Error = TEXT("a zip larger than 2GB can not be extracted");
+					bFailed = true;
+					return false;
+				}
+
+				Buffered.Append(Data, (int32)Num);
+				if (Format == EFormat::Unknown)
+				{
+					DetectFormat(false);
+				}
+			}
+			else if (!Feed(Data, Num))
+			{
+				bFailed = true;
+			}
+
+			return !bFailed;
+		}
+
+		void FStreamExtractor::DetectFormat(bool bFinal)
+		{
+			if (Buffered.Num() >= 4 && (ReadU32(Buffered, 0) == ZipLocalHeaderSignature || ReadU32(Buffered, 0) == ZipEndSignature))
+			{
+				Format = EFormat::Zip;
+				return;
+			}
+
+			if (Buffered.Num() >= 2 && Buffered[0] == 0x1F && Buffered[1] == 0x8B)
+			{
+				Format = EFormat::Gzip;
+				Inflater = MakeUnique<FInflater>(MAX_WBITS + 16);
+			}
+			else if (Buffered.Num() >= TarBlockSize && FMemory::Memcmp(&Buffered[257], "ustar", 5) == 0)
+			{
+				Format = EFormat::Tar;
+			}
+			else if (bFinal || Buffered.Num() >= TarBlockSize)
+			{
+				Error = TEXT("the body is not a zip, tar or gzipped tar");
+				bFailed = true;
+				return;
+			}
+			else
+			{
+				return;
+			}
+
+			//What was gathered to tell the format is the start of the stream
+			Tar = MakeUnique<FTarReader>(*Staging);
+
+			TArray<uint8> Head = MoveTemp(Buffered);
+			Buffered.Empty();
+
+			if (!Feed(Head.GetData(), Head.Num()))
+			{
+				bFailed = true;
+			}
+		}
+
+		bool FStreamExtractor::Feed(const uint8 *Data, int64 Num)
+		{
+			if (Format == EFormat::Gzip)
+			{
+				return Inflater->Inflate(Data, Num, [this](const uint8 *Output, int64 OutputNum)
+				{
+					return Tar->Append(Output, OutputNum, Error);
+				}, Error);
+			}
+
+			return Tar->Append(Data, Num, Error);
+		}
+
+		bool FStreamExtractor::Finish(int32 &OutEntries, FString &OutError)
+		{
+			OutEntries = 0;
+
+			if (!bFailed && Format == EFormat::Unknown)
+			{
+				DetectFormat(true);
+			}
+
+			if (!bFailed)
+			{
+				if (Format == EFormat::Zip)
+				{
+					bFailed = !ExtractZip(Buffered, *Staging, OutEntries, Error);
+					Buffered.Empty();
+				}
+				else if (Format == EFormat::Gzip && !Inflater->IsFinished())
+				{
+					Error = TEXT("the gzip stream is truncated");
+					bFailed = true;
+				}
+				else
+				{
+					bFailed = !Tar->Finish(Error);
+					OutEntries = Tar->GetEntries();
+					Tar.Reset();
+				}
+			}
+
+			if (!bFailed)
+			{
+				bFailed = !Staging->Commit(Error);
+			}
+
+			OutError = Error;
+			return !bFailed;
+		}
+
+		bool Extract(TArrayView<const uint8> Archive, const FString &TargetDir, int32 &OutEntries, FString &OutError)
+		{
+			OutEntries = 0;
+
+			//A zip in memory is read where it is, the stream extractor would copy it
+			if (Archive.Num() >= 4 && (ReadU32(Archive, 0) == ZipLocalHeaderSignature || ReadU32(Archive, 0) == ZipEndSignature))
+			{
+				FStaging Staging(TargetDir);
+				return ExtractZip(Archive, Staging, OutEntries, OutError) && Staging.Commit(OutError);
+			}
+
+			FStreamExtractor Extractor(TargetDir);
+			Extractor.Append(Archive.GetData(), Archive.Num());
+
+			return Extractor.Finish(OutEntries, OutError);
+		}
+	}
+}
@@ -0,0 +1,185 @@
+// Copyright (C) RenZhai.2020.All Rights Reserved.
+#include "Core/SimpleHttpConnectionWarmer.h"
+#include "Core/SimpleHttpMemoryBudget.h"
+#include "HAL/IConsoleManager.h"
+#include "HttpModule.h"
+#include "SimpleHTTPLog.h"
+
+namespace SimpleHTTP
+{
+	namespace ConnectionWarmer
+	{
+		static float TTLSeconds = 0.f;
+		static FAutoConsoleVariableRef CVarTTLSeconds(
+			TEXT("SimpleHTTP.PrewarmTTLSeconds"),
+			TTLSeconds,
+			TEXT("Seconds a prewarmed host stays warm before SimpleHTTP warms it again. 0: warm once (default)"),
+			ECVF_Default);
+
+		static float TimeoutSeconds = 10.f;
+		static FAutoConsoleVariableRef CVarTimeoutSeconds(
+			TEXT("SimpleHTTP.PrewarmTimeoutSeconds"),
+			TimeoutSeconds,
+			TEXT("Seconds SimpleHTTP waits on a warmup request before giving up on the host."),
+			ECVF_Default);
+	}
+
+	FSimpleHttpConnectionWarmer &FSimpleHttpConnectionWarmer::Get()
+	{
+		static FSimpleHttpConnectionWarmer ConnectionWarmer;
+		return ConnectionWarmer;
+	}
+
+	FSimpleHttpConnectionWarmer::FSimpleHttpConnectionWarmer()
+	{
+	}
+
+	FString FSimpleHttpConnectionWarmer::GetOrigin(const FString &URL)
+	{
+		const int32 SchemeEnd = URL.Find(TEXT("://"));
+		if (SchemeEnd == INDEX_NONE)
+		{
+			return FString();
+		}
+
+		const int32 AuthorityStart = SchemeEnd + 3;
+		int32 AuthorityEnd = URL.Len();
+		for (int32 i = AuthorityStart; i < URL.Len(); ++i)
+		{
+			if (URL[i] == TEXT('/') || URL[i] == TEXT('?') || URL[i] == TEXT('#'))
+			{
+				AuthorityEnd = i;
+				break;
+			}
+		}
+
+		if (AuthorityEnd == AuthorityStart)
+		{
+			return FString();
+		}
+
+		return URL.Left(AuthorityEnd).ToLower();
+	}
+
+	void FSimpleHttpConnectionWarmer::Prewarm(const TArray<FString> &URL)
+	{
+		LLM_SCOPE_BYTAG(SimpleHTTP);
+
+		for (const auto &Tmp : URL)
+		{
+			const FString Origin = GetOrigin(Tmp);
+			if (Origin.IsEmpty())
+			{
+				UE_LOG(LogSimpleHTTP, Warning, TEXT("Cannot prewarm [%s], the URL has no scheme."), *Tmp);
+				continue;
+			}
+
+			const FHost* Host = Hosts.Find(Origin);
+			if (!Host || (!Host->Request.IsValid() && !Host->bWarm))
+			{
+				StartWarmup(Origin);
+			}
+		}
+	}
+
+	void FSimpleHttpConnectionWarmer::Cancel()
+	{
+		TArray<FHttpRequestPtr> RunningRequests;
+		for (auto &Tmp : Hosts)
+		{
+			if (Tmp.Value.Request.IsValid())
+			{
+				RunningRequests.Add(Tmp.Value.Request);
+			}
+		}
+
+		Hosts.Reset();
+
+		for (auto &Tmp : RunningRequests)
+		{
+			Tmp->OnProcessRequestComplete().Unbind();
+			Tmp->CancelRequest();
+		}
+	}
+
+	bool FSimpleHttpConnectionWarmer::IsWarm(const FString &URL) const
+	{
+		const FHost* Host = Hosts.Find(GetOrigin(URL));
+		if (!Host || !Host->bWarm)
+		{
+			return false;
+		}
+
+		return ConnectionWarmer::TTLSeconds <= 0.f || FPlatformTime::Seconds() - Host->LastWarmTime < ConnectionWarmer::TTLSeconds;
+	}
+
+	void FSimpleHttpConnectionWarmer::Tick()
+	{
+		if (ConnectionWarmer::TTLSeconds <= 0.f || !Hosts.Num())
+		{
+			return;
+		}
+
+		const double CurrentTime = FPlatformTime::Seconds();
+
+		TArray<FString> ExpiredOrigins;
+		for (const auto &Tmp : Hosts)
+		{
+			if (Tmp.Value.bWarm && !Tmp.Value.Request.IsValid() && CurrentTime - Tmp.Value.LastWarmTime >= ConnectionWarmer::TTLSeconds)
+			{
+				ExpiredOrigins.Add(Tmp.Key);
+			}
+		}
+
+		for (const auto &Tmp : ExpiredOrigins)
+		{
+			UE_LOG(LogSimpleHTTP, Verbose, TEXT("[%s] expired, warming it again."), *Tmp);
+			StartWarmup(Tmp);
+		}
+	}
+
+	void FSimpleHttpConnectionWarmer::StartWarmup(const FString &Origin)
+	{
+		FHttpRequestRef Request = FHttpModule::Get().CreateRequest();
+		Request->SetURL(Origin + TEXT("/"));
+		Request->SetVerb(TEXT("HEAD"));
+		Request->SetTimeout(ConnectionWarmer::TimeoutSeconds);
+		Request->OnProcessRequestComplete().BindRaw(this, &FSimpleHttpConnectionWarmer::HttpRequestComplete, Origin);
+
+		FHost &Host = Hosts.FindOrAdd(Origin);
+		Host.Request = Request;
+
+		if (!Request->ProcessRequest())
+		{
+			UE_LOG(LogSimpleHTTP, Warning, TEXT("Warmup of [%s] failed to start."), *Origin);
+
+			Request->OnProcessRequestComplete().Unbind();
+			Hosts.Remove(Origin);
+		}
+	}
+
+	void FSimpleHttpConnectionWarmer::HttpRequestComplete(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bConnectedSuccessfully, FString Origin)
+	{
+		FHost* Host = Hosts.Find(Origin);
+		if (!Host)
+		{
+			return;
+		}
+
+		Host->Request.Reset();
+
+		//Any answer means the connection is up, the status of the origin does not matter
+		if (bConnectedSuccessfully && Response.IsValid())
+		{
+			Host->bWarm = true;
+			Host->LastWarmTime = FPlatformTime::Seconds();
+
+			UE_LOG(LogSimpleHTTP, Log, TEXT("[%s] is warm, %.1f ms."), *Origin, Request.IsValid() ? Request->GetElapsedTime() * 1000.f : 0.f);
+		}
+		else
+		{
+			UE_LOG(LogSimpleHTTP, Warning, TEXT("Warmup of [%s] could not connect."), *Origin);
+			Hosts.Remove(Origin);
+		}
+	}
+}
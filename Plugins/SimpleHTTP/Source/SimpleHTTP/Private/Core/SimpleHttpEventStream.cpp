@@ -0,0 +1,239 @@
+// Copyright (C) RenZhai.2020.All Rights Reserved.
+#include "Core/SimpleHttpEventStream.h"
+#include "Runtime/Launch/Resources/Version.h"
+#include "SimpleHTTPLog.h"
+
+namespace SimpleHTTP
+{
+	namespace EventStream
+	{
+#if (ENGINE_MAJOR_VERSION > 5 || (ENGINE_MAJOR_VERSION == 5 && ENGINE_MINOR_VERSION >= 2))
+		/*What the transport writes the body into, on the HTTP thread*/
+		class FReceiveArchive : public FArchive
+		{
+		public:
+			FReceiveArchive(TSharedRef<FSimpleHttpEventStream, ESPMode::ThreadSafe> InStream)
+				:Stream(InStream)
+				,Position(0)
+			{
+				SetIsSaving(true);
+				SetIsPersistent(false);
+			}
+
+			virtual void Serialize(void* Data, int64 Num) override
+			{
+				Stream->Append((const uint8*)Data, Num);
+				Position += Num;
+			}
+
+			virtual int64 Tell() override
+			{
+				return Position;
+			}
+
+			virtual int64 TotalSize() override
+			{
+				return Position;
+			}
+
+			virtual FString GetArchiveName() const override
+			{
+				return TEXT("SimpleHttpEventStreamArchive");
+			}
+
+		private:
+			TSharedRef<FSimpleHttpEventStream, ESPMode::ThreadSafe> Stream;
+			int64 Position;
+		};
+#endif
+
+		static FString UTF8ToString(const uint8 *Data, int32 Num)
+		{
+			FUTF8ToTCHAR Converted((const ANSICHAR*)Data, Num);
+			return FString(Converted.Length(), Converted.Get());
+		}
+
+		static int64 GetEventSize(const FSimpleHttpStreamEvent &Event)
+		{
+			return Event.Chunk.Num() + (Event.Event.Len() + Event.Id.Len() + Event.Data.Len()) * sizeof(TCHAR);
+		}
+	}
+
+	FSimpleHttpEventStream::FSimpleHttpEventStream(bool bInServerSentEvents, int64 InMaxBufferedBytes)
+		:bServerSentEvents(bInServerSentEvents)
+		,MaxBufferedBytes(FMath::Max<int64>(InMaxBufferedBytes, 1024))
+		,bAttached(false)
+		,bKeepAll(false)
+		,BufferedBytes(0)
+		,bLastWasCR(false)
+		,bSkippingLine(false)
+	{
+	}
+
+	bool FSimpleHttpEventStream::AttachTo(IHttpRequest &Request)
+	{
+#if (ENGINE_MAJOR_VERSION > 5 || (ENGINE_MAJOR_VERSION == 5 && ENGINE_MINOR_VERSION >= 2))
+		bAttached = Request.SetResponseBodyReceiveStream(MakeShared<EventStream::FReceiveArchive>(AsShared()));
+#endif
+		return bAttached;
+	}
+
+	void FSimpleHttpEventStream::Append(const uint8 *Data, int64 Num)
+	{
+		FScopeLock ScopeLock(&Mutex);
+
+		if (!bServerSentEvents)
+		{
+			FSimpleHttpStreamEvent Event;
+			Event.Chunk.Append(Data, Num);
+
+			Enqueue(MoveTemp(Event));
+			return;
+		}
+
+		//Lines end with CRLF, LF or CR, a CRLF may be split across two appends
+		for (int64 i = 0; i < Num; i++)
+		{
+			const uint8 Char = Data[i];
+			if (Char == '\n' && bLastWasCR)
+			{
+				bLastWasCR = false;
+				continue;
+			}
+
+			bLastWasCR = Char == '\r';
+			if (Char == '\r' || Char == '\n')
+			{
+				ParseLine();
+			}
+			else if (!bSkippingLine)
+			{
+				if (Line.Num() >= MaxBufferedBytes)
+				{
+					UE_LOG(LogSimpleHTTP, Warning, TEXT("An event stream line is longer than %lld bytes, it is skipped."), MaxBufferedBytes);
+
+					Line.Reset();
+					bSkippingLine = true;
+				}
+				else
+				{
+					Line.Add(Char);
+				}
+			}
+		}
+	}
+
+	void FSimpleHttpEventStream::AppendWhole(const uint8 *Data, int64 Num)
+	{
+		FScopeLock ScopeLock(&Mutex);
+
+		bKeepAll = true;
+		Append(Data, Num);
+	}
+
+	void FSimpleHttpEventStream::Dequeue(TArray<FSimpleHttpStreamEvent> &OutEvents)
+	{
+		FScopeLock ScopeLock(&Mutex);
+
+		OutEvents = MoveTemp(Events);
+		Events.Reset();
+		BufferedBytes = 0;
+	}
+
+	void FSimpleHttpEventStream::ParseLine()
+	{
+		if (bSkippingLine)
+		{
+			bSkippingLine = false;
+			return;
+		}
+
+		if (Line.Num() == 0)
+		{
+			DispatchEvent();
+			return;
+		}
+
+		//Comments keep the connection alive
+		if (Line[0] == ':')
+		{
+			Line.Reset();
+			return;
+		}
+
+		const int32 Colon = Line.Find((uint8)':');
+		const FString Field = EventStream::UTF8ToString(Line.GetData(), Colon == INDEX_NONE ? Line.Num() : Colon);
+
+		FString Value;
+		if (Colon != INDEX_NONE)
+		{
+			int32 ValueStart = Colon + 1;
+			if (ValueStart < Line.Num() && Line[ValueStart] == ' ')
+			{
+				ValueStart++;
+			}
+
+			Value = EventStream::UTF8ToString(Line.GetData() + ValueStart, Line.Num() - ValueStart);
+		}
+
+		if (Field == TEXT("data"))
+		{
+			EventData += Value;
+			EventData += TEXT("\n");
+		}
+		else if (Field == TEXT("event"))
+		{
+			EventType = Value;
+		}
+		else if (Field == TEXT("id"))
+		{
+			EventId = Value;
+		}
+
+		Line.Reset();
+	}
+
+	void FSimpleHttpEventStream::DispatchEvent()
+	{
+		//An event without data is not dispatched, the id it carried stays for the next one
+		if (EventData.IsEmpty())
+		{
+			EventType.Reset();
+			return;
+		}
+
+		FSimpleHttpStreamEvent Event;
+		Event.Event = EventType.IsEmpty() ? TEXT("message") : MoveTemp(EventType);
+		Event.Id = EventId;
+		Event.Data = MoveTemp(EventData);
+		Event.Data.RemoveFromEnd(TEXT("\n"));
+
+		EventType.Reset();
+		EventData.Reset();
+
+		Enqueue(MoveTemp(Event));
+	}
+
+	void FSimpleHttpEventStream::Enqueue(FSimpleHttpStreamEvent &&Event)
+	{
+		const int64 EventSize = EventStream::GetEventSize(Event);
+
+		int32 DropNum = 0;
+		while (!bKeepAll && DropNum < Events.Num() && BufferedBytes + EventSize > MaxBufferedBytes)
+		{
+			BufferedBytes -= EventStream::GetEventSize(Events[DropNum++]);
+		}
+
+		if (DropNum > 0)
+		{
+			Events.RemoveAt(0, DropNum, false);
+
+			UE_LOG(LogSimpleHTTP, Warning, TEXT("%d stream events were dropped, they were not taken in time."), DropNum);
+		}
+
+		Event.Dropped = DropNum;
+
+		BufferedBytes += EventSize;
+		Events.Add(MoveTemp(Event));
+	}
+}
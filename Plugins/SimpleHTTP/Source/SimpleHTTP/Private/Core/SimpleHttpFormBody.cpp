@@ -0,0 +1,312 @@
+// Copyright (C) RenZhai.2020.All Rights Reserved.
+#include "Core/SimpleHttpFormBody.h"
+#include "Core/SimpleHTTPMethod.h"
+#include "HAL/FileManager.h"
+#include "Misc/Paths.h"
+#include "Algo/BinarySearch.h"
+#include "SimpleHTTPLog.h"
+
+namespace SimpleHTTP
+{
+	namespace FormBody
+	{
+		template<typename FieldsType>
+		TArray<uint8> BuildFormURLEncodedBody(const FieldsType &Fields)
+		{
+			//The converters live on the stack, a field is converted again for the second pass instead of kept
+			int32 BodySize = 0;
+			for (const auto &Tmp : Fields)
+			{
+				FTCHARToUTF8 Key(*Tmp.Key);
+				FTCHARToUTF8 Value(*Tmp.Value);
+
+				BodySize += BodySize > 0 ? 1 : 0;
+				BodySize += GetURLEncodedLength((const UTF8CHAR*)Key.Get(), Key.Length(), ESimpleURLEncoding::Form);
+				BodySize += 1;
+				BodySize += GetURLEncodedLength((const UTF8CHAR*)Value.Get(), Value.Length(), ESimpleURLEncoding::Form);
+			}
+
+			//The only allocation of the body, every field is encoded straight into it
+			TArray<uint8> Body;
+			Body.AddUninitialized(BodySize);
+
+			ANSICHAR* Out = (ANSICHAR*)Body.GetData();
+			for (const auto &Tmp : Fields)
+			{
+				if (Out != (ANSICHAR*)Body.GetData())
+				{
+					*Out++ = '&';
+				}
+
+				FTCHARToUTF8 Key(*Tmp.Key);
+				FTCHARToUTF8 Value(*Tmp.Value);
+
+				Out += URLEncodeTo((const UTF8CHAR*)Key.Get(), Key.Length(), ESimpleURLEncoding::Form, Out);
+				*Out++ = '=';
+				Out += URLEncodeTo((const UTF8CHAR*)Value.Get(), Value.Length(), ESimpleURLEncoding::Form, Out);
+			}
+
+			check(Out == (ANSICHAR*)Body.GetData() + BodySize);
+			return Body;
+		}
+
+		//Quotes inside a name would end the header value early, line breaks would start a new header
+		FString EscapeHeaderValue(const FString &InValue)
+		{
+			return InValue.Replace(TEXT("\""), TEXT("%22")).Replace(TEXT("\r"), TEXT("%0D")).Replace(TEXT("\n"), TEXT("%0A"));
+		}
+
+		void AppendUTF8(TArray<uint8> &OutBytes, const FString &InString)
+		{
+			FTCHARToUTF8 UTF8Converter(*InString);
+			OutBytes.Append((const uint8*)UTF8Converter.Get(), UTF8Converter.Length());
+		}
+
+		/**
+		 * Reads a list of memory and file segments as one continuous body.
+		 * Files are opened when the transport reaches them and closed as soon as it moves on.
+		 */
+		class FMultipartArchive : public FArchive
+		{
+		public:
+			FMultipartArchive(TArray<FSimpleHttpMultipartForm::FSegment> &&InSegments)
+				:Segments(MoveTemp(InSegments))
+				,Position(0)
+				,TotalBytes(0)
+				,ReaderSegment(INDEX_NONE)
+			{
+				SetIsLoading(true);
+				SetIsPersistent(false);
+
+				SegmentOffsets.Reserve(Segments.Num());
+				for (const auto &Tmp : Segments)
+				{
+					SegmentOffsets.Add(TotalBytes);
+					TotalBytes += Tmp.Size;
+				}
+			}
+
+			virtual void Serialize(void* Data, int64 Num) override
+			{
+				uint8* Dest = (uint8*)Data;
+				while (Num > 0)
+				{
+					if (Position >= TotalBytes)
+					{
+						UE_LOG(LogSimpleHTTP, Error, TEXT("Multipart body read past its end."));
+						FMemory::Memzero(Dest, Num);
+						SetError();
+						return;
+					}
+
+					const int32 SegmentIndex = Algo::UpperBound(SegmentOffsets, Position) - 1;
+					const FSimpleHttpMultipartForm::FSegment &Segment = Segments[SegmentIndex];
+
+					const int64 SegmentPosition = Position - SegmentOffsets[SegmentIndex];
+					const int64 ChunkSize = FMath::Min(Num, Segment.Size - SegmentPosition);
+
+					if (Segment.Data.IsValid())
+					{
+						FMemory::Memcpy(Dest, Segment.Data->GetData() + SegmentPosition, ChunkSize);
+					}
+					else if (!ReadFile(SegmentIndex, SegmentPosition, Dest, ChunkSize))
+					{
+						FMemory::Memzero(Dest, Num);
+						SetError();
+						return;
+					}
+
+					Position += ChunkSize;
+					Dest += ChunkSize;
+					Num -= ChunkSize;
+				}
+			}
+
+			virtual void Seek(int64 InPos) override
+			{
+				Position = FMath::Clamp<int64>(InPos, 0, TotalBytes);
+			}
+
+			virtual int64 Tell() override
+			{
+				return Position;
+			}
+
+			virtual int64 TotalSize() override
+			{
+				return TotalBytes;
+			}
+
+			virtual bool AtEnd() override
+			{
+				return Position >= TotalBytes;
+			}
+
+			virtual bool Close() override
+			{
+				Reader.Reset();
+				ReaderSegment = INDEX_NONE;
+
+				return !IsError();
+			}
+
+			virtual FString GetArchiveName() const override
+			{
+				return TEXT("SimpleHttpMultipartArchive");
+			}
+
+		private:
+			bool ReadFile(int32 SegmentIndex, int64 SegmentPosition, uint8* Dest, int64 ChunkSize)
+			{
+				const FSimpleHttpMultipartForm::FSegment &Segment = Segments[SegmentIndex];
+				if (ReaderSegment != SegmentIndex)
+				{
+					Reader.Reset(IFileManager::Get().CreateFileReader(*Segment.FilePath));
+					ReaderSegment = SegmentIndex;
+				}
+
+				if (!Reader.IsValid() || Reader->TotalSize() != Segment.Size)
+				{
+					UE_LOG(LogSimpleHTTP, Error, TEXT("Multipart file [%s] is missing or changed size."), *Segment.FilePath);
+					return false;
+				}
+
+				if (Reader->Tell() != SegmentPosition)
+				{
+					Reader->Seek(SegmentPosition);
+				}
+
+				Reader->Serialize(Dest, ChunkSize);
+				return !Reader->IsError();
+			}
+
+		private:
+			TArray<FSimpleHttpMultipartForm::FSegment> Segments;
+			TArray<int64> SegmentOffsets;
+
+			int64 Position;
+			int64 TotalBytes;
+
+			TUniquePtr<FArchive> Reader;
+			int32 ReaderSegment;
+		};
+	}
+
+	TArray<uint8> BuildFormURLEncodedBody(const TMap<FString, FString> &Fields)
+	{
+		return FormBody::BuildFormURLEncodedBody(Fields);
+	}
+
+	TArray<uint8> BuildFormURLEncodedBody(const TArray<TPair<FString, FString>> &Fields)
+	{
+		return FormBody::BuildFormURLEncodedBody(Fields);
+	}
+
+	FSimpleHttpMultipartForm::FSimpleHttpMultipartForm()
+		:Boundary(TEXT("----SimpleHTTPBoundary") + FGuid::NewGuid().ToString(EGuidFormats::Digits))
+	{
+	}
+
+	void FSimpleHttpMultipartForm::AddField(const FString &Name, const FString &Value)
+	{
+		AddPartHeader(Name, nullptr, nullptr);
+
+		TArray<uint8> Body;
+		FormBody::AppendUTF8(Body, Value);
+		Body.Append((const uint8*)"\r\n", 2);
+
+		AddMemorySegment(MoveTemp(Body));
+	}
+
+	bool FSimpleHttpMultipartForm::AddFile(const FString &Name, const FString &LocalPath, const FString &ContentType)
+	{
+		const int64 FileSize = IFileManager::Get().FileSize(*LocalPath);
+		if (FileSize < 0)
+		{
+			UE_LOG(LogSimpleHTTP, Error, TEXT("Multipart file [%s] does not exist."), *LocalPath);
+			return false;
+		}
+
+		const FString FileName = FPaths::GetCleanFilename(LocalPath);
+		AddPartHeader(Name, &FileName, &ContentType);
+
+		FSegment &FileSegment = Parts.AddDefaulted_GetRef();
+		FileSegment.FilePath = LocalPath;
+		FileSegment.Size = FileSize;
+
+		AddMemorySegment(TArray<uint8>((const uint8*)"\r\n", 2));
+
+		return true;
+	}
+
+	void FSimpleHttpMultipartForm::AddBuffer(const FString &Name, const FString &FileName, TSharedRef<const TArray<uint8>, ESPMode::ThreadSafe> Data, const FString &ContentType)
+	{
+		AddPartHeader(Name, &FileName, &ContentType);
+
+		FSegment &DataSegment = Parts.AddDefaulted_GetRef();
+		DataSegment.Data = Data;
+		DataSegment.Size = Data->Num();
+
+		AddMemorySegment(TArray<uint8>((const uint8*)"\r\n", 2));
+	}
+
+	FString FSimpleHttpMultipartForm::GetContentType() const
+	{
+		return FString::Printf(TEXT("multipart/form-data; boundary=%s"), *Boundary);
+	}
+
+	int64 FSimpleHttpMultipartForm::GetTotalSize() const
+	{
+		int64 TotalSize = Boundary.Len() + 6;
+		for (const auto &Tmp : Parts)
+		{
+			TotalSize += Tmp.Size;
+		}
+
+		return TotalSize;
+	}
+
+	TSharedRef<FArchive, ESPMode::ThreadSafe> FSimpleHttpMultipartForm::CreateStream() const
+	{
+		TArray<FSegment> Segments;
+		Segments.Reserve(Parts.Num() + 1);
+		Segments.Append(Parts);
+
+		TArray<uint8> Closing;
+		FormBody::AppendUTF8(Closing, FString::Printf(TEXT("--%s--\r\n"), *Boundary));
+
+		FSegment &ClosingSegment = Segments.AddDefaulted_GetRef();
+		ClosingSegment.Size = Closing.Num();
+		ClosingSegment.Data = MakeShared<const TArray<uint8>, ESPMode::ThreadSafe>(MoveTemp(Closing));
+
+		return MakeShared<FormBody::FMultipartArchive, ESPMode::ThreadSafe>(MoveTemp(Segments));
+	}
+
+	void FSimpleHttpMultipartForm::AddPartHeader(const FString &Name, const FString *FileName, const FString *ContentType)
+	{
+		FString Header = FString::Printf(TEXT("--%s\r\nContent-Disposition: form-data; name=\"%s\""), *Boundary, *FormBody::EscapeHeaderValue(Name));
+		if (FileName)
+		{
+			Header += FString::Printf(TEXT("; filename=\"%s\""), *FormBody::EscapeHeaderValue(*FileName));
+		}
+
+		if (ContentType)
+		{
+			Header += FString::Printf(TEXT("\r\nContent-Type: %s"), **ContentType);
+		}
+
+		Header += TEXT("\r\n\r\n");
+
+		TArray<uint8> HeaderBytes;
+		FormBody::AppendUTF8(HeaderBytes, Header);
+
+		AddMemorySegment(MoveTemp(HeaderBytes));
+	}
+
+	void FSimpleHttpMultipartForm::AddMemorySegment(TArray<uint8> &&Data)
+	{
+		FSegment &Segment = Parts.AddDefaulted_GetRef();
+		Segment.Size = Data.Num();
+		Segment.Data = MakeShared<const TArray<uint8>, ESPMode::ThreadSafe>(MoveTemp(Data));
+	}
+}
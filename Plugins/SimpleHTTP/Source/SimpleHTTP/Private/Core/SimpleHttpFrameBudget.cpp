@@ -0,0 +1,68 @@
+// Copyright (C) RenZhai.2020.All Rights Reserved.
+#include "Core/SimpleHttpFrameBudget.h"
+#include "HAL/IConsoleManager.h"
+#include "CoreGlobals.h"
+
+namespace SimpleHTTP
+{
+	namespace FrameBudget
+	{
+		static float BudgetMs = 0.f;
+		static FAutoConsoleVariableRef CVarBudgetMs(
+			TEXT("SimpleHTTP.FrameBudgetMs"),
+			BudgetMs,
+			TEXT("Game thread milliseconds SimpleHTTP may spend per frame starting queued transfers and firing completion agents.\n")
+			TEXT("The rest waits for the next frame, interactive handles are exempt. 0: unlimited (default)"),
+			ECVF_Default);
+	}
+
+	FSimpleHttpFrameBudget::FScope::FScope()
+		:StartTime(FPlatformTime::Seconds())
+	{
+	}
+
+	FSimpleHttpFrameBudget::FScope::~FScope()
+	{
+		FSimpleHttpFrameBudget::Get().Spend(FPlatformTime::Seconds() - StartTime);
+	}
+
+	FSimpleHttpFrameBudget &FSimpleHttpFrameBudget::Get()
+	{
+		static FSimpleHttpFrameBudget FrameBudget;
+		return FrameBudget;
+	}
+
+	FSimpleHttpFrameBudget::FSimpleHttpFrameBudget()
+		:Frame(0)
+		,SpentSeconds(0.0)
+	{
+	}
+
+	bool FSimpleHttpFrameBudget::IsExhausted()
+	{
+		check(IsInGameThread());
+
+		if (FrameBudget::BudgetMs <= 0.f)
+		{
+			return false;
+		}
+
+		UpdateFrame();
+		return SpentSeconds * 1000.0 >= FrameBudget::BudgetMs;
+	}
+
+	void FSimpleHttpFrameBudget::Spend(double Seconds)
+	{
+		UpdateFrame();
+		SpentSeconds += Seconds;
+	}
+
+	void FSimpleHttpFrameBudget::UpdateFrame()
+	{
+		if (Frame != GFrameCounter)
+		{
+			Frame = GFrameCounter;
+			SpentSeconds = 0.0;
+		}
+	}
+}
@@ -0,0 +1,139 @@
+// Copyright (C) RenZhai.2020.All Rights Reserved.
+#include "Core/SimpleHttpIntegrity.h"
+#include "Misc/SecureHash.h"
+#include "Misc/Base64.h"
+#include "Hash/Blake3.h"
+#include "Hash/xxhash.h"
+
+namespace SimpleHTTP
+{
+	namespace Integrity
+	{
+		static FString Base64ToHex(const FString &InBase64)
+		{
+			TArray<uint8> Bytes;
+			if (!FBase64::Decode(InBase64, Bytes))
+			{
+				return FString();
+			}
+
+			return BytesToHex(Bytes.GetData(), Bytes.Num());
+		}
+
+		FString HashContent(TArrayView<const uint8> Content, const FString &Algorithm)
+		{
+			if (Algorithm == TEXT("md5"))
+			{
+				uint8 Digest[16];
+
+				FMD5 MD5;
+				MD5.Update(Content.GetData(), Content.Num());
+				MD5.Final(Digest);
+
+				return BytesToHex(Digest, UE_ARRAY_COUNT(Digest));
+			}
+			else if (Algorithm == TEXT("sha1"))
+			{
+				uint8 Digest[20];
+				FSHA1::HashBuffer(Content.GetData(), Content.Num(), Digest);
+
+				return BytesToHex(Digest, UE_ARRAY_COUNT(Digest));
+			}
+			else if (Algorithm == TEXT("blake3"))
+			{
+				return LexToString(FBlake3::HashBuffer(Content.GetData(), Content.Num()));
+			}
+			else if (Algorithm == TEXT("xxhash64"))
+			{
+				return FString::Printf(TEXT("%016llx"), FXxHash64::HashBuffer(Content.GetData(), Content.Num()).Hash);
+			}
+
+			return FString();
+		}
+
+		bool VerifyHash(TArrayView<const uint8> Content, const FString &ExpectedHash, FString &OutError)
+		{
+			FString Algorithm;
+			FString ExpectedHex;
+			if (!ExpectedHash.Split(TEXT(":"), &Algorithm, &ExpectedHex))
+			{
+				OutError = FString::Printf(TEXT("expected hash [%s] is not \"algorithm:hex\""), *ExpectedHash);
+				return false;
+			}
+
+			Algorithm = Algorithm.TrimStartAndEnd().ToLower();
+			ExpectedHex.TrimStartAndEndInline();
+
+			const FString ActualHex = HashContent(Content, Algorithm);
+			if (ActualHex.IsEmpty())
+			{
+				OutError = FString::Printf(TEXT("unknown hash algorithm [%s]"), *Algorithm);
+				return false;
+			}
+
+			if (!ActualHex.Equals(ExpectedHex, ESearchCase::IgnoreCase))
+			{
+				OutError = FString::Printf(TEXT("%s is %s, expected %s"), *Algorithm, *ActualHex, *ExpectedHex);
+				return false;
+			}
+
+			return true;
+		}
+
+		FString GetHashFromHeaders(const FHttpResponsePtr &Response)
+		{
+			if (!Response.IsValid())
+			{
+				return FString();
+			}
+
+			const FString ContentMD5 = Response->GetHeader(TEXT("Content-MD5"));
+			if (!ContentMD5.IsEmpty())
+			{
+				const FString Hex = Base64ToHex(ContentMD5.TrimStartAndEnd());
+				return Hex.IsEmpty() ? FString() : TEXT("md5:") + Hex;
+			}
+
+			//RFC 3230, "Digest: md5=<base64>,sha=<base64>"
+			TArray<FString> Digests;
+			Response->GetHeader(TEXT("Digest")).ParseIntoArray(Digests, TEXT(","));
+			for (const auto &Tmp : Digests)
+			{
+				FString Algorithm;
+				FString Value;
+				if (!Tmp.Split(TEXT("="), &Algorithm, &Value))
+				{
+					continue;
+				}
+
+				Algorithm = Algorithm.TrimStartAndEnd().ToLower();
+				if (Algorithm == TEXT("md5") || Algorithm == TEXT("sha"))
+				{
+					const FString Hex = Base64ToHex(Value.TrimStartAndEnd());
+					if (!Hex.IsEmpty())
+					{
+						return (Algorithm == TEXT("sha") ? TEXT("sha1:") : TEXT("md5:")) + Hex;
+					}
+				}
+			}
+
+			return FString();
+		}
+
+		bool FContentCheck::Run(TArrayView<const uint8> Content, FString &OutError) const
+		{
+			if (Size > 0 && Size != Content.Num())
+			{
+				OutError = FString::Printf(TEXT("size is %d, expected %lld"), Content.Num(), Size);
+				return false;
+			}
+
+			if (!Hash.IsEmpty() && !VerifyHash(Content, Hash, OutError))
+			{
+				return false;
+			}
+
+			return HeaderHash.IsEmpty() || VerifyHash(Content, HeaderHash, OutError);
+		}
+	}
+}
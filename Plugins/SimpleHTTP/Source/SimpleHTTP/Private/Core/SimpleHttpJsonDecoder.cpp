@@ -0,0 +1,325 @@
+// Copyright (C) RenZhai.2020.All Rights Reserved.
+#include "Core/SimpleHttpJsonDecoder.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+#include "JsonObjectConverter.h"
+#include "SimpleHTTPLog.h"
+
+namespace SimpleHTTP
+{
+	namespace JsonDecoder
+	{
+		/**
+		 * Presents UTF-8 bytes as a stream of TCHAR to the JSON reader.
+		 * Characters are decoded as the reader asks for them, invalid sequences become the engine's bogus character.
+		 */
+		class FUTF8ToTCHARArchive : public FArchive
+		{
+		public:
+			FUTF8ToTCHARArchive(TArrayView<const uint8> InBytes)
+				:Bytes(InBytes)
+				,Position(0)
+				,PendingLowSurrogate(0)
+			{
+				SetIsLoading(true);
+				SetIsPersistent(false);
+
+				//Skip the BOM, the reader does not expect it
+				if (Bytes.Num() >= 3 && Bytes[0] == 0xEF && Bytes[1] == 0xBB && Bytes[2] == 0xBF)
+				{
+					Position = 3;
+				}
+			}
+
+			virtual void Serialize(void* Data, int64 Num) override
+			{
+				check(Num % sizeof(TCHAR) == 0);
+
+				TCHAR* Dest = (TCHAR*)Data;
+				for (int64 i = 0; i < Num / (int64)sizeof(TCHAR); ++i)
+				{
+					if (AtEnd())
+					{
+						FMemory::Memzero(Dest + i, Num - i * sizeof(TCHAR));
+						SetError();
+						return;
+					}
+
+					Dest[i] = NextChar();
+				}
+			}
+
+			virtual int64 Tell() override
+			{
+				return Position;
+			}
+
+			virtual int64 TotalSize() override
+			{
+				return Bytes.Num();
+			}
+
+			virtual bool AtEnd() override
+			{
+				return Position >= Bytes.Num() && PendingLowSurrogate == 0;
+			}
+
+			virtual FString GetArchiveName() const override
+			{
+				return TEXT("SimpleHttpUTF8ToTCHARArchive");
+			}
+
+		private:
+			TCHAR NextChar()
+			{
+				if (PendingLowSurrogate)
+				{
+					const TCHAR Char = (TCHAR)PendingLowSurrogate;
+					PendingLowSurrogate = 0;
+					return Char;
+				}
+
+				const uint32 CodePoint = NextCodePoint();
+				if (sizeof(TCHAR) == 2 && CodePoint > 0xFFFF)
+				{
+					PendingLowSurrogate = 0xDC00 + ((CodePoint - 0x10000) & 0x3FF);
+					return (TCHAR)(0xD800 + ((CodePoint - 0x10000) >> 10));
+				}
+
+				return (TCHAR)CodePoint;
+			}
+
+			uint32 NextCodePoint()
+			{
+				const uint8 Lead = Bytes[Position++];
+				if (Lead < 0x80)
+				{
+					return Lead;
+				}
+
+				int32 TrailCount;
+				uint32 CodePoint;
+				uint32 MinCodePoint;
+				if ((Lead & 0xE0) == 0xC0)
+				{
+					TrailCount = 1;
+					CodePoint = Lead & 0x1F;
+					MinCodePoint = 0x80;
+				}
+				else if ((Lead & 0xF0) == 0xE0)
+				{
+					TrailCount = 2;
+					CodePoint = Lead & 0x0F;
+					MinCodePoint = 0x800;
+				}
+				else if ((Lead & 0xF8) == 0xF0)
+				{
+					TrailCount = 3;
+					CodePoint = Lead & 0x07;
+					MinCodePoint = 0x10000;
+				}
+				else
+				{
+					return UNICODE_BOGUS_CHAR_CODEPOINT;
+				}
+
+				for (int32 i = 0; i < TrailCount; ++i)
+				{
+					if (Position >= Bytes.Num() || (Bytes[Position] & 0xC0) != 0x80)
+					{
+						return UNICODE_BOGUS_CHAR_CODEPOINT;
+					}
+
+					CodePoint = (CodePoint << 6) | (Bytes[Position++] & 0x3F);
+				}
+
+				//Overlong forms, surrogates and values past the last plane are not characters
+				if (CodePoint < MinCodePoint || CodePoint > 0x10FFFF || (CodePoint >= 0xD800 && CodePoint <= 0xDFFF))
+				{
+					return UNICODE_BOGUS_CHAR_CODEPOINT;
+				}
+
+				return CodePoint;
+			}
+
+		private:
+			TArrayView<const uint8> Bytes;
+			int64 Position;
+			uint32 PendingLowSurrogate;
+		};
+	}
+
+	namespace JsonDecoder
+	{
+		/*Looks at the first character that is not white space or the BOM*/
+		bool IsJsonArray(TArrayView<const uint8> UTF8Json)
+		{
+			int32 Index = UTF8Json.Num() >= 3 && UTF8Json[0] == 0xEF && UTF8Json[1] == 0xBB && UTF8Json[2] == 0xBF ? 3 : 0;
+			while (Index < UTF8Json.Num() && FChar::IsWhitespace((TCHAR)UTF8Json[Index]))
+			{
+				++Index;
+			}
+
+			return Index < UTF8Json.Num() && UTF8Json[Index] == '[';
+		}
+
+		/*The property a top level array is decoded into, only when there is exactly one*/
+		const FArrayProperty* FindOnlyArrayProperty(const UStruct* Struct)
+		{
+			const FArrayProperty* Result = nullptr;
+			for (TFieldIterator<FProperty> It(Struct); It; ++It)
+			{
+				if (const FArrayProperty* ArrayProperty = CastField<FArrayProperty>(*It))
+				{
+					if (Result)
+					{
+						return nullptr;
+					}
+
+					Result = ArrayProperty;
+				}
+			}
+
+			return Result;
+		}
+
+		bool CanDecodeProperty(const FProperty* Property, TSet<const UStruct*> &Visited);
+
+		bool CanDecodeStruct(const UStruct* Struct, TSet<const UStruct*> &Visited)
+		{
+			bool bAlreadyVisited = false;
+			Visited.Add(Struct, &bAlreadyVisited);
+			if (bAlreadyVisited)
+			{
+				return true;
+			}
+
+			for (TFieldIterator<FProperty> It(Struct); It; ++It)
+			{
+				if (!CanDecodeProperty(*It, Visited))
+				{
+					return false;
+				}
+			}
+
+			return true;
+		}
+
+		bool CanDecodeProperty(const FProperty* Property, TSet<const UStruct*> &Visited)
+		{
+			if (Property->IsA<FObjectPropertyBase>() || Property->IsA<FInterfaceProperty>()
+				|| Property->IsA<FDelegateProperty>() || Property->IsA<FMulticastDelegateProperty>())
+			{
+				return false;
+			}
+
+			if (const FStructProperty* StructProperty = CastField<FStructProperty>(Property))
+			{
+				return CanDecodeStruct(StructProperty->Struct, Visited);
+			}
+
+			if (const FArrayProperty* ArrayProperty = CastField<FArrayProperty>(Property))
+			{
+				return CanDecodeProperty(ArrayProperty->Inner, Visited);
+			}
+
+			if (const FSetProperty* SetProperty = CastField<FSetProperty>(Property))
+			{
+				return CanDecodeProperty(SetProperty->ElementProp, Visited);
+			}
+
+			if (const FMapProperty* MapProperty = CastField<FMapProperty>(Property))
+			{
+				return CanDecodeProperty(MapProperty->KeyProp, Visited) && CanDecodeProperty(MapProperty->ValueProp, Visited);
+			}
+
+			return true;
+		}
+	}
+
+	bool CanDecodeOffGameThread(const UStruct* Struct)
+	{
+		TSet<const UStruct*> Visited;
+		return Struct && JsonDecoder::CanDecodeStruct(Struct, Visited);
+	}
+
+	TSharedPtr<FJsonObject> DecodeJsonObject(TArrayView<const uint8> UTF8Json)
+	{
+		JsonDecoder::FUTF8ToTCHARArchive Stream(UTF8Json);
+		TSharedRef<TJsonReader<TCHAR>> JsonReader = TJsonReaderFactory<TCHAR>::Create(&Stream);
+
+		TSharedPtr<FJsonObject> JsonObject;
+		if (!FJsonSerializer::Deserialize(JsonReader, JsonObject) || !JsonObject.IsValid())
+		{
+			UE_LOG(LogSimpleHTTP, Warning, TEXT("Response is not a JSON object [%s]."), *JsonReader->GetErrorMessage());
+			return nullptr;
+		}
+
+		return JsonObject;
+	}
+
+	bool DecodeJsonToStruct(TArrayView<const uint8> UTF8Json, const UScriptStruct* Struct, void* OutStructMemory)
+	{
+		if (!Struct || !OutStructMemory)
+		{
+			return false;
+		}
+
+		TSharedPtr<FJsonObject> JsonObject;
+		if (JsonDecoder::IsJsonArray(UTF8Json))
+		{
+			const FArrayProperty* ArrayProperty = JsonDecoder::FindOnlyArrayProperty(Struct);
+			if (!ArrayProperty)
+			{
+				UE_LOG(LogSimpleHTTP, Warning, TEXT("Response is a JSON array, struct [%s] needs exactly one array property to take it."), *Struct->GetName());
+				return false;
+			}
+
+			JsonDecoder::FUTF8ToTCHARArchive Stream(UTF8Json);
+			TSharedRef<TJsonReader<TCHAR>> JsonReader = TJsonReaderFactory<TCHAR>::Create(&Stream);
+
+			TArray<TSharedPtr<FJsonValue>> JsonArray;
+			if (!FJsonSerializer::Deserialize(JsonReader, JsonArray))
+			{
+				UE_LOG(LogSimpleHTTP, Warning, TEXT("Response is not a JSON array [%s]."), *JsonReader->GetErrorMessage());
+				return false;
+			}
+
+			//Read as if the array were the only field of an object
+			JsonObject = MakeShared<FJsonObject>();
+			JsonObject->SetArrayField(ArrayProperty->GetName(), JsonArray);
+		}
+		else
+		{
+			JsonObject = DecodeJsonObject(UTF8Json);
+			if (!JsonObject.IsValid())
+			{
+				return false;
+			}
+		}
+
+		if (!FJsonObjectConverter::JsonObjectToUStruct(JsonObject.ToSharedRef(), Struct, OutStructMemory))
+		{
+			UE_LOG(LogSimpleHTTP, Warning, TEXT("Response does not match struct [%s]."), *Struct->GetName());
+			return false;
+		}
+
+		return true;
+	}
+
+	TSharedPtr<FStructOnScope, ESPMode::ThreadSafe> DecodeJsonToStruct(TArrayView<const uint8> UTF8Json, const UScriptStruct* Struct)
+	{
+		if (!Struct)
+		{
+			return nullptr;
+		}
+
+		TSharedPtr<FStructOnScope, ESPMode::ThreadSafe> StructOnScope = MakeShared<FStructOnScope, ESPMode::ThreadSafe>(Struct);
+		if (!DecodeJsonToStruct(UTF8Json, Struct, StructOnScope->GetStructMemory()))
+		{
+			return nullptr;
+		}
+
+		return StructOnScope;
+	}
+}
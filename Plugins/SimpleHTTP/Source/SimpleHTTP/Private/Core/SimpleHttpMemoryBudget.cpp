@@ -0,0 +1,62 @@
+// Copyright (C) RenZhai.2020.All Rights Reserved.
+#include "Core/SimpleHttpMemoryBudget.h"
+#include "Core/SimpleHttpStats.h"
+#include "HAL/IConsoleManager.h"
+
+LLM_DEFINE_TAG(SimpleHTTP);
+
+DECLARE_MEMORY_STAT(TEXT("Buffered Body Bytes"), STAT_SimpleHttpBufferedBytes, STATGROUP_SimpleHTTP);
+
+namespace SimpleHTTP
+{
+	namespace MemoryBudget
+	{
+		static int32 BudgetMB = 0;
+		static FAutoConsoleVariableRef CVarBudgetMB(
+			TEXT("SimpleHTTP.MemoryBudgetMB"),
+			BudgetMB,
+			TEXT("Response bodies SimpleHTTP may hold in memory, in MB. Handles stop starting queued transfers past it.\n")
+			TEXT("0: unlimited (default)"),
+			ECVF_Default);
+	}
+
+	FSimpleHttpMemoryBudget &FSimpleHttpMemoryBudget::Get()
+	{
+		static FSimpleHttpMemoryBudget MemoryBudget;
+		return MemoryBudget;
+	}
+
+	FSimpleHttpMemoryBudget::FSimpleHttpMemoryBudget()
+		:BufferedBytes(0)
+	{
+	}
+
+	void FSimpleHttpMemoryBudget::Charge(int64 Bytes)
+	{
+		if (Bytes > 0)
+		{
+			BufferedBytes += Bytes;
+			INC_MEMORY_STAT_BY(STAT_SimpleHttpBufferedBytes, Bytes);
+		}
+	}
+
+	void FSimpleHttpMemoryBudget::Release(int64 Bytes)
+	{
+		if (Bytes > 0)
+		{
+			BufferedBytes -= Bytes;
+			DEC_MEMORY_STAT_BY(STAT_SimpleHttpBufferedBytes, Bytes);
+		}
+	}
+
+	int64 FSimpleHttpMemoryBudget::GetBudgetBytes() const
+	{
+		return (int64)FMath::Max(MemoryBudget::BudgetMB, 0) * 1024 * 1024;
+	}
+
+	bool FSimpleHttpMemoryBudget::IsExceeded() const
+	{
+		const int64 BudgetBytes = GetBudgetBytes();
+		return BudgetBytes > 0 && BufferedBytes >= BudgetBytes;
+	}
+}
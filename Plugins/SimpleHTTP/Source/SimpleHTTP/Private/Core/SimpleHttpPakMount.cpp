@@ -0,0 +1,114 @@
+// Copyright (C) RenZhai.2020.All Rights Reserved.
+#include "Core/SimpleHttpPakMount.h"
+#include "HAL/FileManager.h"
+#include "Misc/CoreDelegates.h"
+#include "Misc/Paths.h"
+#include "SimpleHTTPLog.h"
+
+namespace SimpleHTTP
+{
+	namespace PakMount
+	{
+		/*FPakInfo::PakFile_Magic, the footer is smaller than the tail searched for it*/
+		static const uint32 PakMagic = 0x5A6F12E1;
+		static const int64 PakFooterSearchSize = 512;
+
+		/*FIoStoreTocHeader::TocMagicImg*/
+		static const ANSICHAR TocMagic[] = "-==--==--==--==-";
+
+		static bool ReadBytes(const FString &Filename, int64 Offset, int64 Size, TArray<uint8> &OutBytes)
+		{
+			TUniquePtr<FArchive> Reader(IFileManager::Get().CreateFileReader(*Filename));
+			if (!Reader.IsValid() || Offset < 0 || Offset + Size > Reader->TotalSize())
+			{
+				return false;
+			}
+
+			OutBytes.SetNumUninitialized(Size);
+			Reader->Seek(Offset);
+			Reader->Serialize(OutBytes.GetData(), Size);
+
+			return !Reader->IsError();
+		}
+
+		bool IsContainerPart(const FString &Filename)
+		{
+			const FString Extension = FPaths::GetExtension(Filename);
+			return Extension == TEXT("pak") || Extension == TEXT("utoc") || Extension == TEXT("ucas");
+		}
+
+		FString GetPakFilename(const FString &Filename)
+		{
+			return FPaths::ChangeExtension(Filename, TEXT("pak"));
+		}
+
+		bool VerifyContainer(const FString &PakFile, FString &OutError)
+		{
+			const int64 PakSize = IFileManager::Get().FileSize(*PakFile);
+			if (PakSize <= 0)
+			{
+				OutError = TEXT("the .pak is missing or empty");
+				return false;
+			}
+
+			TArray<uint8> Tail;
+			const int64 TailSize = FMath::Min(PakSize, PakFooterSearchSize);
+			if (!ReadBytes(PakFile, PakSize - TailSize, TailSize, Tail))
+			{
+				OutError = TEXT("the .pak could not be read");
+				return false;
+			}
+
+			bool bFoundMagic = false;
+			for (int32 i = 0; i + (int32)sizeof(uint32) <= Tail.Num() && !bFoundMagic; i++)
+			{
+				bFoundMagic = FMemory::Memcmp(&Tail[i], &PakMagic, sizeof(uint32)) == 0;
+			}
+
+			if (!bFoundMagic)
+			{
+				OutError = TEXT("the .pak has no footer, it is truncated or not a pak");
+				return false;
+			}
+
+			//The IoStore part is optional, but when there is a table of contents it has to be one
+			const FString TocFile = FPaths::ChangeExtension(PakFile, TEXT("utoc"));
+			if (IFileManager::Get().FileExists(*TocFile))
+			{
+				TArray<uint8> Header;
+				if (!ReadBytes(TocFile, 0, sizeof(TocMagic) - 1, Header) || FMemory::Memcmp(Header.GetData(), TocMagic, sizeof(TocMagic) - 1) != 0)
+				{
+					OutError = TEXT("the .utoc is not an IoStore table of contents");
+					return false;
+				}
+
+				if (!IFileManager::Get().FileExists(*FPaths::ChangeExtension(PakFile, TEXT("ucas"))))
+				{
+					OutError = TEXT("the .utoc has no .ucas");
+					return false;
+				}
+			}
+
+			return true;
+		}
+
+		bool Mount(const FString &PakFile, int32 Order, FString &OutError)
+		{
+			if (!FCoreDelegates::MountPak.IsBound())
+			{
+				OutError = TEXT("no pak platform file is in use, mounting needs a packaged build or -pak");
+				return false;
+			}
+
+			if (!FCoreDelegates::MountPak.Execute(PakFile, Order))
+			{
+				OutError = TEXT("the pak platform file refused it");
+				return false;
+			}
+
+			UE_LOG(LogSimpleHTTP, Log, TEXT("Mounted [%s] with order %d."), *PakFile, Order);
+
+			return true;
+		}
+	}
+}
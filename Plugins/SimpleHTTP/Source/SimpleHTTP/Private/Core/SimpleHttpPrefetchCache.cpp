@@ -0,0 +1,361 @@
+// Copyright (C) RenZhai.2020.All Rights Reserved.
+#include "Core/SimpleHttpPrefetchCache.h"
+#include "Core/SimpleHttpSyntheticResponse.h"
+#include "Core/SimpleHTTPMethod.h"
+#include "Core/SimpleHttpStats.h"
+#include "Core/SimpleHttpMemoryBudget.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/DateTime.h"
+#include "HttpModule.h"
+#include "SimpleHTTPLog.h"
+
+namespace SimpleHTTP
+{
+	namespace PrefetchCache
+	{
+		static int32 CacheMB = 64;
+		static FAutoConsoleVariableRef CVarCacheMB(
+			TEXT("SimpleHTTP.PrefetchCacheMB"),
+			CacheMB,
+			TEXT("Prefetched bodies SimpleHTTP keeps in memory, in MB. The least recently used go first."),
+			ECVF_Default);
+
+		static int32 MaxInFlight = 2;
+		static FAutoConsoleVariableRef CVarMaxInFlight(
+			TEXT("SimpleHTTP.PrefetchMaxInFlight"),
+			MaxInFlight,
+			TEXT("Prefetches SimpleHTTP runs at once while there is no other traffic."),
+			ECVF_Default);
+
+		static int32 TTLSeconds = 300;
+		static FAutoConsoleVariableRef CVarTTLSeconds(
+			TEXT("SimpleHTTP.PrefetchTTLSeconds"),
+			TTLSeconds,
+			TEXT("Longest time SimpleHTTP keeps a prefetched body, shorter when its Cache-Control or Expires header says so."),
+			ECVF_Default);
+
+		static FAutoConsoleCommand EmptyCommand(
+			TEXT("SimpleHTTP.Prefetch.Empty"),
+			TEXT("Cancels the SimpleHTTP prefetches and drops the cached bodies."),
+			FConsoleCommandDelegate::CreateStatic([]()
+			{
+				FSimpleHttpPrefetchCache::Get().CancelPrefetch();
+				FSimpleHttpPrefetchCache::Get().Empty();
+			}));
+
+		FORCEINLINE int64 GetMaxBytes()
+		{
+			return (int64)FMath::Max(CacheMB, 0) * 1024 * 1024;
+		}
+
+		/**
+		 * How long the response may be served from the cache, from Cache-Control, then Expires, capped by TTLSeconds.
+		 * @Return		False when the response must not be kept at all.
+		 */
+		bool GetFreshLifetime(FHttpResponsePtr Response, double &OutSeconds)
+		{
+			OutSeconds = FMath::Max(TTLSeconds, 0);
+
+			const FString CacheControl = Response->GetHeader(TEXT("Cache-Control"));
+			if (!CacheControl.IsEmpty())
+			{
+				TArray<FString> Directives;
+				CacheControl.ParseIntoArray(Directives, TEXT(","));
+				for (auto &Tmp : Directives)
+				{
+					Tmp.TrimStartAndEndInline();
+					if (Tmp.Equals(TEXT("no-store"), ESearchCase::IgnoreCase) || Tmp.Equals(TEXT("no-cache"), ESearchCase::IgnoreCase))
+					{
+						return false;
+					}
+
+					FString Name;
+					FString Value;
+					if (Tmp.Split(TEXT("="), &Name, &Value) && Name.TrimEnd().Equals(TEXT("max-age"), ESearchCase::IgnoreCase))
+					{
+						//Time the response already spent in caches on the way counts against it
+						const double Age = FCString::Atod(*Response->GetHeader(TEXT("Age")));
+						OutSeconds = FMath::Min(OutSeconds, FCString::Atod(*Value.TrimStart()) - FMath::Max(Age, 0.0));
+						return OutSeconds > 0.0;
+					}
+				}
+			}
+
+			const FString Expires = Response->GetHeader(TEXT("Expires"));
+			if (!Expires.IsEmpty())
+			{
+				//A date that does not parse, usually "0", means already expired
+				FDateTime ExpireDate;
+				if (!FDateTime::ParseHttpDate(Expires, ExpireDate))
+				{
+					return false;
+				}
+
+				FDateTime ResponseDate;
+				if (!FDateTime::ParseHttpDate(Response->GetHeader(TEXT("Date")), ResponseDate))
+				{
+					ResponseDate = FDateTime::UtcNow();
+				}
+
+				OutSeconds = FMath::Min(OutSeconds, (ExpireDate - ResponseDate).GetTotalSeconds());
+			}
+
+			return OutSeconds > 0.0;
+		}
+	}
+
+	FSimpleHttpPrefetchCache &FSimpleHttpPrefetchCache::Get()
+	{
+		static FSimpleHttpPrefetchCache PrefetchCache;
+		return PrefetchCache;
+	}
+
+	FSimpleHttpPrefetchCache::FSimpleHttpPrefetchCache()
+		:CachedBytes(0)
+		,UseCounter(0)
+		,NextExpireCheckTime(0.0)
+	{
+	}
+
+	void FSimpleHttpPrefetchCache::Prefetch(const TArray<FString> &URL)
+	{
+		RemoveExpired();
+
+		for (const auto &Tmp : URL)
+		{
+			if (!Entries.Contains(Tmp) && !Running.Contains(Tmp) && !Queue.Contains(Tmp))
+			{
+				Queue.Add(Tmp);
+			}
+		}
+
+		UE_LOG(LogSimpleHTTP, Log, TEXT("%d prefetches queued."), Queue.Num());
+	}
+
+	void FSimpleHttpPrefetchCache::CancelPrefetch()
+	{
+		Queue.Reset();
+
+		TArray<FHttpRequestPtr> RunningRequests;
+		Running.GenerateValueArray(RunningRequests);
+		Running.Reset();
+
+		for (auto &Tmp : RunningRequests)
+		{
+			Tmp->OnProcessRequestComplete().Unbind();
+			Tmp->CancelRequest();
+		}
+	}
+
+	void FSimpleHttpPrefetchCache::Empty()
+	{
+		FSimpleHttpMemoryBudget::Get().Release(CachedBytes);
+
+		Entries.Reset();
+		CachedBytes = 0;
+	}
+
+	FHttpResponsePtr FSimpleHttpPrefetchCache::Find(const FString &URL)
+	{
+		FEntry* Entry = Entries.Find(URL);
+		if (!Entry)
+		{
+			return nullptr;
+		}
+
+		//Handed out once, a later request for the URL goes to the server and sees any change
+		FHttpResponsePtr Response = Entry->ExpireTime > FPlatformTime::Seconds() ? Entry->Response : nullptr;
+		RemoveEntry(URL);
+
+		if (Response.IsValid())
+		{
+			FSimpleHttpStats::Get().RecordCacheHit();
+		}
+
+		return Response;
+	}
+
+	void FSimpleHttpPrefetchCache::Tick()
+	{
+		if (Entries.Num() && FPlatformTime::Seconds() >= NextExpireCheckTime)
+		{
+			NextExpireCheckTime = FPlatformTime::Seconds() + 1.0;
+			RemoveExpired();
+		}
+
+		if (!Queue.Num() && !Running.Num())
+		{
+			return;
+		}
+
+		LLM_SCOPE_BYTAG(SimpleHTTP);
+
+		if (HasForegroundTraffic())
+		{
+			RequeueRunning();
+			return;
+		}
+
+		while (Queue.Num() && Running.Num() < FMath::Max(PrefetchCache::MaxInFlight, 1))
+		{
+			const FString URL = Queue[0];
+			Queue.RemoveAt(0, 1, false);
+
+			if (!Entries.Contains(URL))
+			{
+				StartPrefetch(URL);
+			}
+		}
+	}
+
+	bool FSimpleHttpPrefetchCache::HasForegroundTraffic() const
+	{
+		//Prefetches stay out of the stats, so everything counted there is someone else's.
+		//An open stream may never end, it would hold prefetching off for good.
+		const FSimpleHttpStats &Stats = FSimpleHttpStats::Get();
+		return Stats.GetInFlight() - Stats.GetOpenStreams() > 0 || Stats.GetQueued() > 0;
+	}
+
+	void FSimpleHttpPrefetchCache::StartPrefetch(const FString &URL)
+	{
+		FHttpRequestRef Request = FHttpModule::Get().CreateRequest();
+		Request->SetURL(SimpleHTTP::SimpleURLEncode(*URL));
+		Request->SetVerb(TEXT("GET"));
+		Request->OnProcessRequestComplete().BindRaw(this, &FSimpleHttpPrefetchCache::HttpRequestComplete, URL);
+
+		Running.Add(URL, Request);
+
+		if (!Request->ProcessRequest())
+		{
+			UE_LOG(LogSimpleHTTP, Warning, TEXT("Prefetch of [%s] failed to start."), *URL);
+
+			Request->OnProcessRequestComplete().Unbind();
+			Running.Remove(URL);
+		}
+	}
+
+	void FSimpleHttpPrefetchCache::RequeueRunning()
+	{
+		if (!Running.Num())
+		{
+			return;
+		}
+
+		UE_LOG(LogSimpleHTTP, Verbose, TEXT("Foreground traffic, %d prefetches go back to the queue."), Running.Num());
+
+		TArray<FString> RunningURL;
+		TArray<FHttpRequestPtr> RunningRequests;
+		Running.GenerateKeyArray(RunningURL);
+		Running.GenerateValueArray(RunningRequests);
+		Running.Reset();
+
+		Queue.Insert(RunningURL, 0);
+
+		for (auto &Tmp : RunningRequests)
+		{
+			Tmp->OnProcessRequestComplete().Unbind();
+			Tmp->CancelRequest();
+		}
+	}
+
+	void FSimpleHttpPrefetchCache::HttpRequestComplete(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bConnectedSuccessfully, FString URL)
+	{
+		LLM_SCOPE_BYTAG(SimpleHTTP);
+
+		Running.Remove(URL);
+
+		if (!bConnectedSuccessfully || !Response.IsValid() || !EHttpResponseCodes::IsOk(Response->GetResponseCode()))
+		{
+			UE_LOG(LogSimpleHTTP, Warning, TEXT("Prefetch of [%s] failed, code [%d]."), *URL, Response.IsValid() ? Response->GetResponseCode() : 0);
+			return;
+		}
+
+		AddEntry(URL, Response);
+	}
+
+	void FSimpleHttpPrefetchCache::AddEntry(const FString &URL, FHttpResponsePtr Response)
+	{
+		double FreshLifetime = 0.0;
+		if (!PrefetchCache::GetFreshLifetime(Response, FreshLifetime))
+		{
+			UE_LOG(LogSimpleHTTP, Log, TEXT("Prefetch of [%s] may not be cached, it is not kept."), *URL);
+			return;
+		}
+
+		const int64 MaxBytes = PrefetchCache::GetMaxBytes();
+		const int64 Size = Response->GetContent().Num();
+		if (Size > MaxBytes)
+		{
+			UE_LOG(LogSimpleHTTP, Warning, TEXT("Prefetch of [%s] is larger than SimpleHTTP.PrefetchCacheMB, it is not kept."), *URL);
+			return;
+		}
+
+		TrimTo(MaxBytes - Size);
+
+		//The engine response reads through its request, the copy keeps the cache independent of both
+		TMap<FString, FString> Headers;
+		for (const auto &Tmp : Response->GetAllHeaders())
+		{
+			FString Name;
+			FString Value;
+			if (Tmp.Split(TEXT(":"), &Name, &Value))
+			{
+				Headers.Add(Name.TrimStartAndEnd(), Value.TrimStartAndEnd());
+			}
+		}
+
+		FEntry &Entry = Entries.Add(URL);
+		Entry.Response = MakeShared<FSimpleHttpSyntheticResponse, ESPMode::ThreadSafe>(Response->GetURL(), Response->GetResponseCode(), MoveTemp(Headers), TArray<uint8>(Response->GetContent()));
+		Entry.Size = Size;
+		Entry.LastUse = ++UseCounter;
+		Entry.ExpireTime = FPlatformTime::Seconds() + FreshLifetime;
+
+		CachedBytes += Size;
+		FSimpleHttpMemoryBudget::Get().Charge(Size);
+
+		UE_LOG(LogSimpleHTTP, Log, TEXT("Prefetched [%s], %lld bytes, %lld cached."), *URL, Size, CachedBytes);
+	}
+
+	void FSimpleHttpPrefetchCache::TrimTo(int64 MaxBytes)
+	{
+		while (CachedBytes > MaxBytes && Entries.Num())
+		{
+			const FString* LeastRecentlyUsed = nullptr;
+			uint64 LeastUse = MAX_uint64;
+			for (const auto &Tmp : Entries)
+			{
+				if (Tmp.Value.LastUse < LeastUse)
+				{
+					LeastUse = Tmp.Value.LastUse;
+					LeastRecentlyUsed = &Tmp.Key;
+				}
+			}
+
+			RemoveEntry(FString(*LeastRecentlyUsed));
+		}
+	}
+
+	void FSimpleHttpPrefetchCache::RemoveEntry(const FString &URL)
+	{
+		FEntry Entry;
+		if (Entries.RemoveAndCopyValue(URL, Entry))
+		{
+			CachedBytes -= Entry.Size;
+			FSimpleHttpMemoryBudget::Get().Release(Entry.Size);
+		}
+	}
+
+	void FSimpleHttpPrefetchCache::RemoveExpired()
+	{
+		const double CurrentTime = FPlatformTime::Seconds();
+		for (auto It = Entries.CreateIterator(); It; ++It)
+		{
+			if (It.Value().ExpireTime <= CurrentTime)
+			{
+				CachedBytes -= It.Value().Size;
+				FSimpleHttpMemoryBudget::Get().Release(It.Value().Size);
+				It.RemoveCurrent();
+			}
+		}
+	}
+}
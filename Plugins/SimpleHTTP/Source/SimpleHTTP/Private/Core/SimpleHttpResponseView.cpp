@@ -0,0 +1,95 @@
+// Copyright (C) RenZhai.2020.All Rights Reserved.
+#include "Core/SimpleHttpResponseView.h"
+
+namespace SimpleHTTP
+{
+	static const TArray<uint8> EmptyContent;
+	static const TArray<FString> EmptyHeaders;
+	static const FString EmptyString;
+}
+
+FSimpleHttpResponseView::FSimpleHttpResponseView()
+	:Response(nullptr)
+{
+}
+
+FSimpleHttpResponseView::FSimpleHttpResponseView(FHttpResponsePtr InResponse)
+	:Response(InResponse)
+{
+}
+
+int32 FSimpleHttpResponseView::GetResponseCode() const
+{
+	return Response.IsValid() ? Response->GetResponseCode() : INDEX_NONE;
+}
+
+FString FSimpleHttpResponseView::GetURL() const
+{
+	return Response.IsValid() ? Response->GetURL() : FString();
+}
+
+FString FSimpleHttpResponseView::GetContentType() const
+{
+	return Response.IsValid() ? Response->GetContentType() : FString();
+}
+
+int32 FSimpleHttpResponseView::GetContentLength() const
+{
+	return Response.IsValid() ? Response->GetContentLength() : INDEX_NONE;
+}
+
+FString FSimpleHttpResponseView::GetHeader(const FString& HeaderName) const
+{
+	return Response.IsValid() ? Response->GetHeader(HeaderName) : FString();
+}
+
+TArrayView<const uint8> FSimpleHttpResponseView::GetContent() const
+{
+	if (Response.IsValid())
+	{
+		return Response->GetContent();
+	}
+
+	return SimpleHTTP::EmptyContent;
+}
+
+TSharedPtr<const TArray<uint8>, ESPMode::ThreadSafe> FSimpleHttpResponseView::GetSharedContent() const
+{
+	if (Response.IsValid())
+	{
+		//Shares the reference count of the response, the array itself is never copied
+		return TSharedPtr<const TArray<uint8>, ESPMode::ThreadSafe>(Response, &Response->GetContent());
+	}
+
+	return nullptr;
+}
+
+const FString& FSimpleHttpResponseView::GetContentAsString() const
+{
+	if (!Response.IsValid())
+	{
+		return SimpleHTTP::EmptyString;
+	}
+
+	if (!CachedContentAsString.IsSet())
+	{
+		CachedContentAsString.Emplace(Response->GetContentAsString());
+	}
+
+	return CachedContentAsString.GetValue();
+}
+
+const TArray<FString>& FSimpleHttpResponseView::GetAllHeaders() const
+{
+	if (!Response.IsValid())
+	{
+		return SimpleHTTP::EmptyHeaders;
+	}
+
+	if (!CachedAllHeaders.IsSet())
+	{
+		CachedAllHeaders.Emplace(Response->GetAllHeaders());
+	}
+
+	return CachedAllHeaders.GetValue();
+}
@@ -0,0 +1,319 @@
+// Copyright (C) RenZhai.2020.All Rights Reserved.
+#include "Core/SimpleHttpStats.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/OutputDevice.h"
+#include "SimpleHTTPLog.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Requests In Flight"), STAT_SimpleHttpInFlight, STATGROUP_SimpleHTTP);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Requests Queued"), STAT_SimpleHttpQueued, STATGROUP_SimpleHTTP);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Streams Open"), STAT_SimpleHttpOpenStreams, STATGROUP_SimpleHTTP);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Requests Completed"), STAT_SimpleHttpCompleted, STATGROUP_SimpleHTTP);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Request Errors"), STAT_SimpleHttpErrors, STATGROUP_SimpleHTTP);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Request Retries"), STAT_SimpleHttpRetries, STATGROUP_SimpleHTTP);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Cache Hits"), STAT_SimpleHttpCacheHits, STATGROUP_SimpleHTTP);
+DECLARE_MEMORY_STAT(TEXT("Bytes Sent"), STAT_SimpleHttpBytesSent, STATGROUP_SimpleHTTP);
+DECLARE_MEMORY_STAT(TEXT("Bytes Received"), STAT_SimpleHttpBytesReceived, STATGROUP_SimpleHTTP);
+
+namespace SimpleHTTP
+{
+	namespace Stats
+	{
+		/*Distinct endpoints tracked before new paths are folded into their host*/
+		static const int32 MaxEndpoints = 256;
+
+		static FAutoConsoleCommandWithOutputDevice DumpCommand(
+			TEXT("SimpleHTTP.Stats"),
+			TEXT("Prints request counters and per-endpoint latency percentiles of SimpleHTTP."),
+			FConsoleCommandWithOutputDeviceDelegate::CreateStatic([](FOutputDevice &Ar)
+			{
+				FSimpleHttpStats::Get().Dump(Ar);
+			}));
+
+		static FAutoConsoleCommand ResetCommand(
+			TEXT("SimpleHTTP.Stats.Reset"),
+			TEXT("Clears the SimpleHTTP totals and latency histograms."),
+			FConsoleCommandDelegate::CreateStatic([]()
+			{
+				FSimpleHttpStats::Get().Reset();
+			}));
+	}
+
+	FSimpleHttpLatencyHistogram::FSimpleHttpLatencyHistogram()
+	{
+		Reset();
+	}
+
+	void FSimpleHttpLatencyHistogram::Reset()
+	{
+		FMemory::Memzero(Buckets, sizeof(Buckets));
+		Count = 0;
+		MinSeconds = 0.0;
+		MaxSeconds = 0.0;
+		TotalSeconds = 0.0;
+	}
+
+	void FSimpleHttpLatencyHistogram::Add(double Seconds)
+	{
+		Seconds = FMath::Max(Seconds, 0.0);
+
+		const uint64 Microseconds = FMath::Max<uint64>((uint64)(Seconds * 1000000.0), 1);
+		const uint32 Exponent = FPlatformMath::FloorLog2_64(Microseconds);
+
+		int32 Index = BucketCount - 1;
+		if (Exponent < MaxExponent)
+		{
+			const uint32 SubBucket = Exponent >= SubBucketBits ?
+				(uint32)(Microseconds >> (Exponent - SubBucketBits)) & (SubBucketCount - 1) :
+				(uint32)(Microseconds << (SubBucketBits - Exponent)) & (SubBucketCount - 1);
+
+			Index = Exponent * SubBucketCount + SubBucket;
+		}
+
+		Buckets[Index]++;
+
+		MinSeconds = Count ? FMath::Min(MinSeconds, Seconds) : Seconds;
+		MaxSeconds = FMath::Max(MaxSeconds, Seconds);
+		TotalSeconds += Seconds;
+		Count++;
+	}
+
+	void FSimpleHttpLatencyHistogram::Merge(const FSimpleHttpLatencyHistogram &Other)
+	{
+		if (!Other.Count)
+		{
+			return;
+		}
+
+		for (int32 i = 0; i < BucketCount; ++i)
+		{
+			Buckets[i] += Other.Buckets[i];
+		}
+
+		MinSeconds = Count ? FMath::Min(MinSeconds, Other.MinSeconds) : Other.MinSeconds;
+		MaxSeconds = FMath::Max(MaxSeconds, Other.MaxSeconds);
+		TotalSeconds += Other.TotalSeconds;
+		Count += Other.Count;
+	}
+
+	double FSimpleHttpLatencyHistogram::GetPercentile(double Percentile) const
+	{
+		if (!Count)
+		{
+			return 0.0;
+		}
+
+		const uint64 Target = FMath::Max<uint64>((uint64)FMath::CeilToDouble(FMath::Clamp(Percentile, 0.0, 100.0) / 100.0 * Count), 1);
+
+		uint64 Cumulative = 0;
+		for (int32 i = 0; i < BucketCount; ++i)
+		{
+			Cumulative += Buckets[i];
+			if (Cumulative >= Target)
+			{
+				const int32 Exponent = i / SubBucketCount;
+				const int32 SubBucket = i % SubBucketCount;
+				const double UpperMicroseconds = (double)(SubBucketCount + SubBucket + 1) * (double)(1ull << Exponent) / SubBucketCount;
+
+				//The bucket edge can overshoot what was actually seen
+				return FMath::Min(UpperMicroseconds / 1000000.0, MaxSeconds);
+			}
+		}
+
+		return MaxSeconds;
+	}
+
+	FSimpleHttpStats &FSimpleHttpStats::Get()
+	{
+		static FSimpleHttpStats Stats;
+		return Stats;
+	}
+
+	FSimpleHttpStats::FSimpleHttpStats()
+		:InFlight(0)
+		,Queued(0)
+		,OpenStreams(0)
+		,Completed(0)
+		,Errors(0)
+		,Retries(0)
+		,CacheHits(0)
+		,BytesSent(0)
+		,BytesReceived(0)
+	{
+	}
+
+	void FSimpleHttpStats::RequestQueued()
+	{
+		Queued++;
+		INC_DWORD_STAT(STAT_SimpleHttpQueued);
+	}
+
+	void FSimpleHttpStats::RequestDequeued()
+	{
+		Queued--;
+		DEC_DWORD_STAT(STAT_SimpleHttpQueued);
+	}
+
+	void FSimpleHttpStats::RequestStarted()
+	{
+		InFlight++;
+		INC_DWORD_STAT(STAT_SimpleHttpInFlight);
+	}
+
+	void FSimpleHttpStats::RequestFinished(const FString &Verb, const FString &URL, double ElapsedSeconds, int64 InBytesSent, int64 InBytesReceived, bool bSucceeded)
+	{
+		InFlight--;
+		Completed++;
+		BytesSent += (uint64)FMath::Max<int64>(InBytesSent, 0);
+		BytesReceived += (uint64)FMath::Max<int64>(InBytesReceived, 0);
+
+		DEC_DWORD_STAT(STAT_SimpleHttpInFlight);
+		INC_DWORD_STAT(STAT_SimpleHttpCompleted);
+		INC_MEMORY_STAT_BY(STAT_SimpleHttpBytesSent, FMath::Max<int64>(InBytesSent, 0));
+		INC_MEMORY_STAT_BY(STAT_SimpleHttpBytesReceived, FMath::Max<int64>(InBytesReceived, 0));
+
+		if (!bSucceeded)
+		{
+			Errors++;
+			INC_DWORD_STAT(STAT_SimpleHttpErrors);
+		}
+
+		FScopeLock ScopeLock(&Mutex);
+
+		TotalLatency.Add(ElapsedSeconds);
+		EndpointLatencies.FindOrAdd(GetEndpoint(Verb, URL)).Add(ElapsedSeconds);
+	}
+
+	void FSimpleHttpStats::RequestFinished(const FHttpRequestPtr &Request, const FHttpResponsePtr &Response, bool bConnectedSuccessfully)
+	{
+		if (!Request.IsValid())
+		{
+			return;
+		}
+
+		RequestFinished(
+			Request->GetVerb(),
+			Request->GetURL(),
+			Request->GetElapsedTime(),
+			Request->GetContentLength(),
+			Response.IsValid() ? Response->GetContent().Num() : 0,
+			bConnectedSuccessfully && Response.IsValid() && EHttpResponseCodes::IsOk(Response->GetResponseCode()));
+	}
+
+	void FSimpleHttpStats::StreamOpened()
+	{
+		OpenStreams++;
+		INC_DWORD_STAT(STAT_SimpleHttpOpenStreams);
+	}
+
+	void FSimpleHttpStats::StreamClosed()
+	{
+		OpenStreams--;
+		DEC_DWORD_STAT(STAT_SimpleHttpOpenStreams);
+	}
+
+	void FSimpleHttpStats::RecordRetry()
+	{
+		Retries++;
+		INC_DWORD_STAT(STAT_SimpleHttpRetries);
+	}
+
+	void FSimpleHttpStats::RecordCacheHit()
+	{
+		CacheHits++;
+		INC_DWORD_STAT(STAT_SimpleHttpCacheHits);
+	}
+
+	FString FSimpleHttpStats::GetEndpoint(const FString &Verb, const FString &URL) const
+	{
+		int32 Start = URL.Find(TEXT("://"));
+		Start = Start == INDEX_NONE ? 0 : Start + 3;
+
+		int32 End = URL.Len();
+		int32 QueryStart = INDEX_NONE;
+		if (URL.FindChar(TEXT('?'), QueryStart))
+		{
+			End = QueryStart;
+		}
+
+		int32 FragmentStart = INDEX_NONE;
+		if (URL.FindChar(TEXT('#'), FragmentStart))
+		{
+			End = FMath::Min(End, FragmentStart);
+		}
+
+		FString Endpoint = Verb + TEXT(" ") + URL.Mid(Start, FMath::Max(End - Start, 0));
+		if (EndpointLatencies.Contains(Endpoint) || EndpointLatencies.Num() < Stats::MaxEndpoints)
+		{
+			return Endpoint;
+		}
+
+		const int32 PathStart = URL.Find(TEXT("/"), ESearchCase::CaseSensitive, ESearchDir::FromStart, Start);
+		const int32 HostEnd = PathStart == INDEX_NONE ? End : FMath::Min(PathStart, End);
+
+		return Verb + TEXT(" ") + URL.Mid(Start, FMath::Max(HostEnd - Start, 0)) + TEXT("/*");
+	}
+
+	void FSimpleHttpStats::GetLatencies(TMap<FString, FSimpleHttpLatencyHistogram> &OutLatencies) const
+	{
+		FScopeLock ScopeLock(&Mutex);
+
+		OutLatencies = EndpointLatencies;
+		OutLatencies.Add(FString(), TotalLatency);
+	}
+
+	void FSimpleHttpStats::Reset()
+	{
+		Completed = 0;
+		Errors = 0;
+		Retries = 0;
+		CacheHits = 0;
+		BytesSent = 0;
+		BytesReceived = 0;
+
+		SET_DWORD_STAT(STAT_SimpleHttpCompleted, 0);
+		SET_DWORD_STAT(STAT_SimpleHttpErrors, 0);
+		SET_DWORD_STAT(STAT_SimpleHttpRetries, 0);
+		SET_DWORD_STAT(STAT_SimpleHttpCacheHits, 0);
+		SET_MEMORY_STAT(STAT_SimpleHttpBytesSent, 0);
+		SET_MEMORY_STAT(STAT_SimpleHttpBytesReceived, 0);
+
+		FScopeLock ScopeLock(&Mutex);
+
+		TotalLatency.Reset();
+		EndpointLatencies.Reset();
+	}
+
+	void FSimpleHttpStats::Dump(FOutputDevice &Ar) const
+	{
+		Ar.Logf(TEXT("SimpleHTTP: %d in flight (%d streams), %d queued, %llu completed, %llu errors, %llu retries, %llu cache hits."),
+			GetInFlight(), GetOpenStreams(), GetQueued(), GetCompleted(), GetErrors(), GetRetries(), GetCacheHits());
+		Ar.Logf(TEXT("SimpleHTTP: %.2f MB sent, %.2f MB received."),
+			GetBytesSent() / (1024.0 * 1024.0), GetBytesReceived() / (1024.0 * 1024.0));
+
+		TMap<FString, FSimpleHttpLatencyHistogram> Latencies;
+		GetLatencies(Latencies);
+
+		//Busiest endpoints first, the total leads
+		Latencies.ValueSort([](const FSimpleHttpLatencyHistogram &A, const FSimpleHttpLatencyHistogram &B)
+		{
+			return A.Num() > B.Num();
+		});
+
+		Ar.Logf(TEXT("%10s %10s %10s %10s %10s  %s"), TEXT("Count"), TEXT("p50 ms"), TEXT("p95 ms"), TEXT("p99 ms"), TEXT("Max ms"), TEXT("Endpoint"));
+		for (const auto &Tmp : Latencies)
+		{
+			if (!Tmp.Value.Num())
+			{
+				continue;
+			}
+
+			Ar.Logf(TEXT("%10llu %10.1f %10.1f %10.1f %10.1f  %s"),
+				Tmp.Value.Num(),
+				Tmp.Value.GetPercentile(50.0) * 1000.0,
+				Tmp.Value.GetPercentile(95.0) * 1000.0,
+				Tmp.Value.GetPercentile(99.0) * 1000.0,
+				Tmp.Value.GetMax() * 1000.0,
+				Tmp.Key.IsEmpty() ? TEXT("(all)") : *Tmp.Key);
+		}
+	}
+}
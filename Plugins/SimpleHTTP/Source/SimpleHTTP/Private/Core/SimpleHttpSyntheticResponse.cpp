@@ -0,0 +1,88 @@
+// Copyright (C) RenZhai.2020.All Rights Reserved.
+#include "Core/SimpleHttpSyntheticResponse.h"
+#include "Core/SimpleHTTPMethod.h"
+
+FSimpleHttpSyntheticResponse::FSimpleHttpSyntheticResponse(const FString &InURL, int32 InResponseCode, TMap<FString, FString> &&InHeaders, TArray<uint8> &&InContent)
+	:URL(InURL)
+	,ResponseCode(InResponseCode)
+	,Headers(MoveTemp(InHeaders))
+	,Content(MoveTemp(InContent))
+{
+}
+
+FString FSimpleHttpSyntheticResponse::GetURL() const
+{
+	return URL;
+}
+
+FString FSimpleHttpSyntheticResponse::GetURLParameter(const FString& ParameterName) const
+{
+	int32 QueryStart = INDEX_NONE;
+	if (!URL.FindChar(TEXT('?'), QueryStart))
+	{
+		return FString();
+	}
+
+	TArray<FString> Params;
+	URL.RightChop(QueryStart + 1).ParseIntoArray(Params, TEXT("&"));
+	for (const auto &Tmp : Params)
+	{
+		FString Key;
+		FString Value;
+		if (!Tmp.Split(TEXT("="), &Key, &Value))
+		{
+			Key = Tmp;
+		}
+
+		if (SimpleHTTP::SimpleURLDecode(*Key, true) == ParameterName)
+		{
+			return SimpleHTTP::SimpleURLDecode(*Value, true);
+		}
+	}
+
+	return FString();
+}
+
+FString FSimpleHttpSyntheticResponse::GetHeader(const FString& HeaderName) const
+{
+	const FString* Value = Headers.Find(HeaderName);
+	return Value ? *Value : FString();
+}
+
+TArray<FString> FSimpleHttpSyntheticResponse::GetAllHeaders() const
+{
+	TArray<FString> AllHeaders;
+	AllHeaders.Reserve(Headers.Num());
+	for (const auto &Tmp : Headers)
+	{
+		AllHeaders.Add(Tmp.Key + TEXT(": ") + Tmp.Value);
+	}
+
+	return AllHeaders;
+}
+
+FString FSimpleHttpSyntheticResponse::GetContentType() const
+{
+	return GetHeader(TEXT("Content-Type"));
+}
+
+int32 FSimpleHttpSyntheticResponse::GetContentLength() const
+{
+	return Content.Num();
+}
+
+const TArray<uint8>& FSimpleHttpSyntheticResponse::GetContent() const
+{
+	return Content;
+}
+
+int32 FSimpleHttpSyntheticResponse::GetResponseCode() const
+{
+	return ResponseCode;
+}
+
+FString FSimpleHttpSyntheticResponse::GetContentAsString() const
+{
+	FUTF8ToTCHAR TCHARData((const ANSICHAR*)Content.GetData(), Content.Num());
+	return FString(TCHARData.Length(), TCHARData.Get());
+}
@@ -0,0 +1,541 @@
+// Copyright (C) RenZhai.2020.All Rights Reserved.
+#include "Core/SimpleHttpTarStream.h"
+#include "HAL/FileManager.h"
+#include "Misc/Paths.h"
+#include "Algo/BinarySearch.h"
+#include "SimpleHTTPLog.h"
+
+THIRD_PARTY_INCLUDES_START
+#include "zlib.h"
+THIRD_PARTY_INCLUDES_END
+
+namespace SimpleHTTP
+{
+	namespace TarStream
+	{
+		static const int64 BlockSize = 512;
+
+		/*11 octal digits in a ustar size field*/
+		static const int64 MaxEntrySize = (1ll << 33) - 1;
+
+		static const int64 DeflateChunkSize = 64 * 1024;
+
+		struct FEntry
+		{
+			FString FilePath;
+
+			/*UTF-8, directories end with a slash*/
+			TArray<uint8> Name;
+
+			int64 Size;
+			int64 ModificationTime;
+			bool bDirectory;
+
+			/*GNU long name block ahead of the ustar header*/
+			FORCEINLINE bool HasLongName() const { return Name.Num() > 100; }
+
+			FORCEINLINE int64 GetHeaderSize() const
+			{
+				return HasLongName() ? BlockSize * 2 + Align((int64)Name.Num() + 1, BlockSize) : BlockSize;
+			}
+
+			FORCEINLINE int64 GetTotalSize() const
+			{
+				return GetHeaderSize() + Align(Size, BlockSize);
+			}
+		};
+
+		static void WriteOctal(uint8* Field, int32 FieldSize, int64 Value)
+		{
+			for (int32 i = FieldSize - 2; i >= 0; i--)
+			{
+				Field[i] = '0' + (Value & 7);
+				Value >>= 3;
+			}
+
+			Field[FieldSize - 1] = 0;
+		}
+
+		static void WriteHeaderBlock(uint8* Block, const uint8* Name, int32 NameLen, int64 Size, int64 ModificationTime, uint8 Type)
+		{
+			FMemory::Memzero(Block, BlockSize);
+
+			FMemory::Memcpy(Block, Name, FMath::Min(NameLen, 100));
+			WriteOctal(Block + 100, 8, Type == '5' ? 0755 : 0644);
+			WriteOctal(Block + 108, 8, 0);
+			WriteOctal(Block + 116, 8, 0);
+			WriteOctal(Block + 124, 12, Size);
+			WriteOctal(Block + 136, 12, ModificationTime);
+			Block[156] = Type;
+			FMemory::Memcpy(Block + 257, "ustar", 6);
+			FMemory::Memcpy(Block + 263, "00", 2);
+
+			//The checksum is taken with its own field set to spaces
+			FMemory::Memset(Block + 148, ' ', 8);
+
+			uint32 Checksum = 0;
+			for (int64 i = 0; i < BlockSize; i++)
+			{
+				Checksum += Block[i];
+			}
+
+			WriteOctal(Block + 148, 7, Checksum);
+			Block[155] = ' ';
+		}
+
+		static bool GatherEntries(const FString &Directory, TArray<FEntry> &OutEntries)
+		{
+			FString Root = Directory;
+			FPaths::NormalizeDirectoryName(Root);
+			const FString Prefix = Root + TEXT("/");
+
+			bool bSucceeded = true;
+			IFileManager::Get().IterateDirectoryStatRecursively(*Root, [&](const TCHAR* FilenameOrDirectory, const FFileStatData &StatData)
+			{
+				FString Path = FilenameOrDirectory;
+				FPaths::NormalizeFilename(Path);
+				if (!Path.StartsWith(Prefix))
+				{
+					return true;
+				}
+
+				if (StatData.FileSize > MaxEntrySize)
+				{
+					UE_LOG(LogSimpleHTTP, Error, TEXT("[%s] is too large for a tar entry."), *Path);
+					bSucceeded = false;
+					return false;
+				}
+
+				FString Name = Path.RightChop(Prefix.Len());
+				if (StatData.bIsDirectory)
+				{
+					Name += TEXT("/");
+				}
+
+				FTCHARToUTF8 NameUTF8(*Name);
+
+				FEntry &Entry = OutEntries.AddDefaulted_GetRef();
+				Entry.FilePath = MoveTemp(Path);
+				Entry.Name.Append((const uint8*)NameUTF8.Get(), NameUTF8.Length());
+				Entry.Size = StatData.bIsDirectory ? 0 : StatData.FileSize;
+				Entry.ModificationTime = FMath::Max<int64>(StatData.ModificationTime.ToUnixTimestamp(), 0);
+				Entry.bDirectory = StatData.bIsDirectory;
+
+				return true;
+			});
+
+			//A parent always comes before what is inside it
+			OutEntries.Sort([](const FEntry &A, const FEntry &B) { return A.FilePath < B.FilePath; });
+
+			return bSucceeded;
+		}
+
+		/**
+		 * Reads the entry list as one continuous tar.
+		 * Headers are made for the entry the transport is in, files are opened when it reaches them.
+		 */
+		class FTarArchive : public FArchive
+		{
+		public:
+			FTarArchive(TArray<FEntry> &&InEntries)
+				:Entries(MoveTemp(InEntries))
+				,Position(0)
+				,TotalBytes(0)
+				,HeaderEntry(INDEX_NONE)
+				,ReaderEntry(INDEX_NONE)
+			{
+				SetIsLoading(true);
+				SetIsPersistent(false);
+
+				EntryOffsets.Reserve(Entries.Num());
+				for (const auto &Tmp : Entries)
+				{
+					EntryOffsets.Add(TotalBytes);
+					TotalBytes += Tmp.GetTotalSize();
+				}
+
+				//Two zero blocks end the archive
+				TotalBytes += BlockSize * 2;
+			}
+
+			virtual void Serialize(void* Data, int64 Num) override
+			{
+				uint8* Dest = (uint8*)Data;
+				while (Num > 0)
+				{
+					if (Position >= TotalBytes)
+					{
+						UE_LOG(LogSimpleHTTP, Error, TEXT("Tar body read past its end."));
+						FMemory::Memzero(Dest, Num);
+						SetError();
+						return;
+					}
+
+					const int32 EntryIndex = Algo::UpperBound(EntryOffsets, Position) - 1;
+					int64 ChunkSize = 0;
+
+					if (EntryIndex < 0 || Position >= EntryOffsets[EntryIndex] + Entries[EntryIndex].GetTotalSize())
+					{
+						//End of archive blocks
+						ChunkSize = FMath::Min(Num, TotalBytes - Position);
+						FMemory::Memzero(Dest, ChunkSize);
+					}
+					else
+					{
+						const FEntry &Entry = Entries[EntryIndex];
+						const int64 EntryPosition = Position - EntryOffsets[EntryIndex];
+						const int64 HeaderSize = Entry.GetHeaderSize();
+
+						if (EntryPosition < HeaderSize)
+						{
+							MakeHeader(EntryIndex);
+
+							ChunkSize = FMath::Min(Num, HeaderSize - EntryPosition);
+							FMemory::Memcpy(Dest, Header.GetData() + EntryPosition, ChunkSize);
+						}
+						else if (EntryPosition < HeaderSize + Entry.Size)
+						{
+							ChunkSize = FMath::Min(Num, HeaderSize + Entry.Size - EntryPosition);
+							ReadFile(EntryIndex, EntryPosition - HeaderSize, Dest, ChunkSize);
+						}
+						else
+						{
+							//Padding of the content to a whole block
+							ChunkSize = FMath::Min(Num, Entry.GetTotalSize() - EntryPosition);
+							FMemory::Memzero(Dest, ChunkSize);
+						}
+					}
+
+					Position += ChunkSize;
+					Dest += ChunkSize;
+					Num -= ChunkSize;
+				}
+			}
+
+			virtual void Seek(int64 InPos) override
+			{
+				Position = FMath::Clamp<int64>(InPos, 0, TotalBytes);
+			}
+
+			virtual int64 Tell() override
+			{
+				return Position;
+			}
+
+			virtual int64 TotalSize() override
+			{
+				return TotalBytes;
+			}
+
+			virtual bool AtEnd() override
+			{
+				return Position >= TotalBytes;
+			}
+
+			virtual bool Close() override
+			{
+				Reader.Reset();
+				ReaderEntry = INDEX_NONE;
+
+				return !IsError();
+			}
+
+			virtual FString GetArchiveName() const override
+			{
+				return TEXT("SimpleHttpTarArchive");
+			}
+
+		private:
+			void MakeHeader(int32 EntryIndex)
+			{
+				if (HeaderEntry == EntryIndex)
+				{
+					return;
+				}
+
+				const FEntry &Entry = Entries[EntryIndex];
+				Header.SetNumZeroed(Entry.GetHeaderSize());
+
+				uint8* Block = Header.GetData();
+				if (Entry.HasLongName())
+				{
+					static const ANSICHAR LongLink[] = "././@LongLink";
+					WriteHeaderBlock(Block, (const uint8*)LongLink, sizeof(LongLink) - 1, Entry.Name.Num() + 1, 0, 'L');
+					FMemory::Memcpy(Block + BlockSize, Entry.Name.GetData(), Entry.Name.Num());
+
+					Block += Header.Num() - BlockSize;
+				}
+
+				WriteHeaderBlock(Block, Entry.Name.GetData(), Entry.Name.Num(), Entry.Size, Entry.ModificationTime, Entry.bDirectory ? '5' : '0');
+				HeaderEntry = EntryIndex;
+			}
+
+			/**
+			 * The header already promised the size the walk saw, so content is held to it whatever the file does now:
+			 * missing bytes are zeros and extra bytes are left out. The tar stays whole and the error tells the sender.
+			 */
+			void ReadFile(int32 EntryIndex, int64 EntryPosition, uint8* Dest, int64 ChunkSize)
+			{
+				const FEntry &Entry = Entries[EntryIndex];
+				if (ReaderEntry != EntryIndex)
+				{
+					Reader.Reset(IFileManager::Get().CreateFileReader(*Entry.FilePath));
+					ReaderEntry = EntryIndex;
+
+					if (!Reader.IsValid() || Reader->TotalSize() != Entry.Size)
+					{
+						UE_LOG(LogSimpleHTTP, Error, TEXT("Tar file [%s] went missing or changed size while it was sent."), *Entry.FilePath);
+						SetError();
+					}
+				}
+
+				const int64 Available = Reader.IsValid() ? FMath::Clamp<int64>(Reader->TotalSize() - EntryPosition, 0, ChunkSize) : 0;
+				if (Available > 0)
+				{
+					if (Reader->Tell() != EntryPosition)
+					{
+						Reader->Seek(EntryPosition);
+					}
+
+					Reader->Serialize(Dest, Available);
+					if (Reader->IsError())
+					{
+						UE_LOG(LogSimpleHTTP, Error, TEXT("Tar file [%s] could not be read."), *Entry.FilePath);
+						SetError();
+
+						Reader.Reset();
+						FMemory::Memzero(Dest, Available);
+					}
+				}
+
+				FMemory::Memzero(Dest + Available, ChunkSize - Available);
+			}
+
+		private:
+			TArray<FEntry> Entries;
+			TArray<int64> EntryOffsets;
+
+			int64 Position;
+			int64 TotalBytes;
+
+			TArray<uint8> Header;
+			int32 HeaderEntry;
+
+			TUniquePtr<FArchive> Reader;
+			int32 ReaderEntry;
+		};
+
+		/**
+		 * Deflates an inner archive into a gzip stream as it is read.
+		 * Deflate output can only be produced in order, seeking back starts over from the beginning.
+		 */
+		class FGzipArchive : public FArchive
+		{
+		public:
+			FGzipArchive(TSharedRef<FArchive, ESPMode::ThreadSafe> InInner)
+				:Inner(InInner)
+				,Position(0)
+				,TotalBytes(0)
+				,OutputOffset(0)
+				,bFinished(false)
+			{
+				SetIsLoading(true);
+				SetIsPersistent(false);
+
+				FMemory::Memzero(Stream);
+				Input.SetNumUninitialized(DeflateChunkSize);
+
+				//Window bits above 15 make zlib write the gzip header and trailer
+				deflateInit2(&Stream, Z_BEST_SPEED, Z_DEFLATED, MAX_WBITS + 16, 8, Z_DEFAULT_STRATEGY);
+
+				//The transport needs the size before the first byte, same input and settings give the same output
+				while (!bFinished && !IsError())
+				{
+					TotalBytes += Output.Num();
+					Deflate();
+				}
+				TotalBytes += Output.Num();
+
+				Restart();
+			}
+
+			virtual ~FGzipArchive()
+			{
+				deflateEnd(&Stream);
+			}
+
+			virtual void Serialize(void* Data, int64 Num) override
+			{
+				uint8* Dest = (uint8*)Data;
+				while (Num > 0)
+				{
+					if (OutputOffset >= Output.Num())
+					{
+						if (bFinished)
+						{
+							UE_LOG(LogSimpleHTTP, Error, TEXT("Gzip body read past its end."));
+							FMemory::Memzero(Dest, Num);
+							SetError();
+							return;
+						}
+
+						Deflate();
+						continue;
+					}
+
+					const int64 ChunkSize = FMath::Min<int64>(Num, Output.Num() - OutputOffset);
+					if (Dest)
+					{
+						FMemory::Memcpy(Dest, Output.GetData() + OutputOffset, ChunkSize);
+						Dest += ChunkSize;
+					}
+
+					OutputOffset += ChunkSize;
+					Position += ChunkSize;
+					Num -= ChunkSize;
+				}
+			}
+
+			virtual void Seek(int64 InPos) override
+			{
+				InPos = FMath::Clamp<int64>(InPos, 0, TotalBytes);
+				if (InPos < Position)
+				{
+					Restart();
+				}
+
+				//Skipped output is produced and dropped
+				Serialize(nullptr, InPos - Position);
+			}
+
+			virtual int64 Tell() override
+			{
+				return Position;
+			}
+
+			virtual int64 TotalSize() override
+			{
+				return TotalBytes;
+			}
+
+			virtual bool AtEnd() override
+			{
+				return Position >= TotalBytes;
+			}
+
+			virtual bool Close() override
+			{
+				Inner->Close();
+
+				return !IsError();
+			}
+
+			virtual FString GetArchiveName() const override
+			{
+				return TEXT("SimpleHttpGzipArchive");
+			}
+
+		private:
+			void Restart()
+			{
+				deflateReset(&Stream);
+				Inner->Seek(0);
+
+				Output.Reset();
+				OutputOffset = 0;
+				Position = 0;
+				bFinished = false;
+			}
+
+			/*Replaces Output with the next piece of the stream, which may be empty while zlib gathers input*/
+			void Deflate()
+			{
+				Output.SetNumUninitialized(DeflateChunkSize, false);
+				OutputOffset = 0;
+
+				Stream.next_out = Output.GetData();
+				Stream.avail_out = (uInt)Output.Num();
+
+				while (Stream.avail_out > 0 && !bFinished)
+				{
+					if (Stream.avail_in == 0 && !Inner->AtEnd())
+					{
+						const int64 ReadSize = FMath::Min<int64>(Input.Num(), Inner->TotalSize() - Inner->Tell());
+						Inner->Serialize(Input.GetData(), ReadSize);
+
+						//The tar pads what it could not read and keeps its length, the error is passed on for the sender
+						if (Inner->IsError())
+						{
+							SetError();
+						}
+
+						Stream.next_in = Input.GetData();
+						Stream.avail_in = (uInt)ReadSize;
+					}
+
+					const int32 Result = deflate(&Stream, Inner->AtEnd() ? Z_FINISH : Z_NO_FLUSH);
+					if (Result == Z_STREAM_END)
+					{
+						bFinished = true;
+					}
+					else if (Result != Z_OK && Result != Z_BUF_ERROR)
+					{
+						UE_LOG(LogSimpleHTTP, Error, TEXT("Gzip body could not be deflated (%d)."), Result);
+						SetError();
+
+						//Nothing more can come out of the stream
+						bFinished = true;
+						break;
+					}
+				}
+
+				Output.SetNum(Output.Num() - Stream.avail_out, false);
+			}
+
+		private:
+			TSharedRef<FArchive, ESPMode::ThreadSafe> Inner;
+			z_stream Stream;
+
+			TArray<uint8> Input;
+			TArray<uint8> Output;
+
+			int64 Position;
+			int64 TotalBytes;
+			int64 OutputOffset;
+			bool bFinished;
+		};
+	}
+
+	TSharedPtr<FArchive, ESPMode::ThreadSafe> CreateDirectoryTarStream(const FString &Directory, bool bGzip)
+	{
+		if (!IFileManager::Get().DirectoryExists(*Directory))
+		{
+			UE_LOG(LogSimpleHTTP, Error, TEXT("Directory [%s] does not exist."), *Directory);
+			return nullptr;
+		}
+
+		TArray<TarStream::FEntry> Entries;
+		if (!TarStream::GatherEntries(Directory, Entries))
+		{
+			return nullptr;
+		}
+
+		TSharedRef<FArchive, ESPMode::ThreadSafe> Tar = MakeShared<TarStream::FTarArchive, ESPMode::ThreadSafe>(MoveTemp(Entries));
+		UE_LOG(LogSimpleHTTP, Log, TEXT("Directory [%s] is sent as a %lld byte tar."), *Directory, Tar->TotalSize());
+
+		if (!bGzip)
+		{
+			return Tar;
+		}
+
+		TSharedRef<FArchive, ESPMode::ThreadSafe> Gzip = MakeShared<TarStream::FGzipArchive, ESPMode::ThreadSafe>(Tar);
+		if (Gzip->IsError())
+		{
+			return nullptr;
+		}
+
+		UE_LOG(LogSimpleHTTP, Log, TEXT("The tar is deflated to %lld bytes."), Gzip->TotalSize());
+
+		return Gzip;
+	}
+}
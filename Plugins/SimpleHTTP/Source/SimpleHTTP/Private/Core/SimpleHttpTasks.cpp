@@ -0,0 +1,276 @@
+// Copyright (C) RenZhai.2020.All Rights Reserved.
+#include "Core/SimpleHttpTasks.h"
+#include "Core/SimpleHTTPMethod.h"
+#include "Core/SimpleHttpMacro.h"
+#include "HttpModule.h"
+#include "Interfaces/IHttpResponse.h"
+#include "SimpleHTTPLog.h"
+#include "Core/SimpleHttpStats.h"
+#include "Core/SimpleHttpTrace.h"
+
+namespace SimpleHTTP
+{
+	bool FSimpleHttpResult::IsOk() const
+	{
+		return bConnectedSuccessfully && !bCancelled && Response.IsValid() && EHttpResponseCodes::IsOk(Response->GetResponseCode());
+	}
+
+	TSharedRef<FSimpleHttpCancellationToken, ESPMode::ThreadSafe> FSimpleHttpCancellationToken::Create()
+	{
+		return MakeShareable(new FSimpleHttpCancellationToken());
+	}
+
+	FSimpleHttpCancellationToken::FSimpleHttpCancellationToken()
+		:bCancelled(false)
+	{
+	}
+
+	void FSimpleHttpCancellationToken::Cancel()
+	{
+		TArray<FHttpRequestPtr> RequestsToCancel;
+		{
+			FScopeLock ScopeLock(&Mutex);
+			bCancelled = true;
+			RequestsToCancel = MoveTemp(Requests);
+		}
+
+		//Outside the lock, the completion of a cancelled request unregisters itself
+		for (auto &Tmp : RequestsToCancel)
+		{
+			Tmp->CancelRequest();
+		}
+	}
+
+	bool FSimpleHttpCancellationToken::Register(const FHttpRequestRef &Request)
+	{
+		{
+			FScopeLock ScopeLock(&Mutex);
+			if (!bCancelled)
+			{
+				Requests.Add(Request);
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	void FSimpleHttpCancellationToken::Unregister(const FHttpRequestRef &Request)
+	{
+		FScopeLock ScopeLock(&Mutex);
+		Requests.RemoveSingleSwap(Request);
+	}
+
+	namespace Tasks
+	{
+		FHttpRequestRef CreateRequest(const FString &Verb, const FString &URL)
+		{
+			FHttpRequestRef Request = FHttpModule::Get().CreateRequest();
+			Request->SetVerb(Verb);
+			Request->SetURL(SimpleURLEncode(*URL));
+
+			return Request;
+		}
+
+		FSimpleHttpResult MakeResult(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bConnectedSuccessfully, bool bCancelled)
+		{
+			FSimpleHttpResult Result;
+			RequestPtrToSimpleRequest(Request, Result.Request);
+			Result.Response = Response;
+			Result.bConnectedSuccessfully = bConnectedSuccessfully;
+			Result.bCancelled = bCancelled;
+
+			return Result;
+		}
+	}
+
+	TFuture<FSimpleHttpResult> FSimpleHttpTasks::Execute(const FHttpRequestRef &Request, const FSimpleHttpTaskOptions &TaskOptions)
+	{
+		LLM_SCOPE_BYTAG(SimpleHTTP);
+
+		//The engine may complete a request that failed to start a second time, only the first result counts
+		struct FTaskState
+		{
+			FTaskState()
+				:bResolved(false)
+				,bStarted(false)
+			{}
+
+			void Resolve(const FHttpRequestPtr &Request, FSimpleHttpResult &&Result)
+			{
+				if (!bResolved.exchange(true))
+				{
+					if (bStarted)
+					{
+						FSimpleHttpStats::Get().RequestFinished(Request, Result.Response, Result.bConnectedSuccessfully);
+						Trace::EndSpan(Request.Get(),
+							Result.Response.IsValid() ? Result.Response->GetResponseCode() : 0,
+							Result.Response.IsValid() ? Result.Response->GetContent().Num() : 0);
+					}
+
+					Promise.SetValue(MoveTemp(Result));
+				}
+			}
+
+			TPromise<FSimpleHttpResult> Promise;
+			std::atomic<bool> bResolved;
+
+			/*Set before the request is processed, so the stats count it in flight*/
+			bool bStarted;
+		};
+
+		TSharedRef<FTaskState, ESPMode::ThreadSafe> State = MakeShared<FTaskState, ESPMode::ThreadSafe>();
+		TFuture<FSimpleHttpResult> Future = State->Promise.GetFuture();
+
+		for (const auto &Tmp : TaskOptions.Headers)
+		{
+			Request->SetHeader(Tmp.Key, Tmp.Value);
+		}
+
+		if (TaskOptions.TimeoutSeconds > 0.f)
+		{
+			Request->SetTimeout(TaskOptions.TimeoutSeconds);
+		}
+
+		if (TaskOptions.bCompleteOnHttpThread)
+		{
+			Request->SetDelegateThreadPolicy(EHttpRequestDelegateThreadPolicy::CompleteOnHttpThread);
+		}
+
+		TSharedPtr<FSimpleHttpCancellationToken, ESPMode::ThreadSafe> CancellationToken = TaskOptions.CancellationToken;
+		if (CancellationToken.IsValid() && !CancellationToken->Register(Request))
+		{
+			State->Resolve(Request, Tasks::MakeResult(Request, nullptr, false, true));
+			return Future;
+		}
+
+		Request->OnProcessRequestComplete().BindLambda([State, CancellationToken](FHttpRequestPtr InRequest, FHttpResponsePtr Response, bool bConnectedSuccessfully)
+		{
+			LLM_SCOPE_BYTAG(SimpleHTTP);
+
+			const bool bCancelled = CancellationToken.IsValid() && CancellationToken->IsCancelled();
+			if (CancellationToken.IsValid() && InRequest.IsValid())
+			{
+				CancellationToken->Unregister(InRequest.ToSharedRef());
+			}
+
+			State->Resolve(InRequest, Tasks::MakeResult(InRequest, Response, bConnectedSuccessfully, bCancelled));
+		});
+
+		State->bStarted = true;
+		FSimpleHttpStats::Get().RequestStarted();
+		Trace::BeginSpan(&Request.Get(), Trace::EPhase::ConnectAndFirstByte, Request->GetVerb(), Request->GetURL());
+
+		if (!Request->ProcessRequest())
+		{
+			UE_LOG(LogSimpleHTTP, Warning, TEXT("Task request could not start [%s]."), *Request->GetURL());
+
+			if (CancellationToken.IsValid())
+			{
+				CancellationToken->Unregister(Request);
+			}
+
+			State->Resolve(Request, Tasks::MakeResult(Request, nullptr, false, false));
+		}
+
+		return Future;
+	}
+
+	TFuture<FSimpleHttpResult> FSimpleHttpTasks::Get(const FString &URL, const FSimpleHttpTaskOptions &TaskOptions)
+	{
+		return Execute(Tasks::CreateRequest(TEXT("GET"), URL), TaskOptions);
+	}
+
+	TFuture<FSimpleHttpResult> FSimpleHttpTasks::Delete(const FString &URL, const FSimpleHttpTaskOptions &TaskOptions)
+	{
+		return Execute(Tasks::CreateRequest(TEXT("DELETE"), URL), TaskOptions);
+	}
+
+	TFuture<FSimpleHttpResult> FSimpleHttpTasks::Post(const FString &URL, TArray<uint8> &&Body, const FString &ContentType, const FSimpleHttpTaskOptions &TaskOptions)
+	{
+		FHttpRequestRef Request = Tasks::CreateRequest(TEXT("POST"), URL);
+		Request->SetHeader(TEXT("Content-Type"), ContentType);
+		Request->SetContent(MoveTemp(Body));
+
+		return Execute(Request, TaskOptions);
+	}
+
+	TFuture<FSimpleHttpResult> FSimpleHttpTasks::Put(const FString &URL, TArray<uint8> &&Body, const FString &ContentType, const FSimpleHttpTaskOptions &TaskOptions)
+	{
+		FHttpRequestRef Request = Tasks::CreateRequest(TEXT("PUT"), URL);
+		Request->SetHeader(TEXT("Content-Type"), ContentType);
+		Request->SetContent(MoveTemp(Body));
+
+		return Execute(Request, TaskOptions);
+	}
+
+	TFuture<TArray<FSimpleHttpResult>> FSimpleHttpTasks::WhenAll(TArray<TFuture<FSimpleHttpResult>> &&Futures)
+	{
+		struct FWhenAllState
+		{
+			TPromise<TArray<FSimpleHttpResult>> Promise;
+			TArray<FSimpleHttpResult> Results;
+			std::atomic<int32> Remaining;
+		};
+
+		if (Futures.Num() == 0)
+		{
+			return MakeFulfilledPromise<TArray<FSimpleHttpResult>>().GetFuture();
+		}
+
+		TSharedRef<FWhenAllState, ESPMode::ThreadSafe> State = MakeShared<FWhenAllState, ESPMode::ThreadSafe>();
+		State->Results.SetNum(Futures.Num());
+		State->Remaining = Futures.Num();
+
+		TFuture<TArray<FSimpleHttpResult>> Future = State->Promise.GetFuture();
+		for (int32 i = 0; i < Futures.Num(); ++i)
+		{
+			//Every slot is written by one continuation only, the last one to finish publishes them
+			Futures[i].Next([State, i](FSimpleHttpResult Result)
+			{
+				State->Results[i] = MoveTemp(Result);
+				if (--State->Remaining == 0)
+				{
+					State->Promise.SetValue(MoveTemp(State->Results));
+				}
+			});
+		}
+
+		return Future;
+	}
+
+	TFuture<FSimpleHttpAnyResult> FSimpleHttpTasks::WhenAny(TArray<TFuture<FSimpleHttpResult>> &&Futures)
+	{
+		struct FWhenAnyState
+		{
+			TPromise<FSimpleHttpAnyResult> Promise;
+			std::atomic<bool> bResolved;
+		};
+
+		if (Futures.Num() == 0)
+		{
+			return MakeFulfilledPromise<FSimpleHttpAnyResult>().GetFuture();
+		}
+
+		TSharedRef<FWhenAnyState, ESPMode::ThreadSafe> State = MakeShared<FWhenAnyState, ESPMode::ThreadSafe>();
+		State->bResolved = false;
+
+		TFuture<FSimpleHttpAnyResult> Future = State->Promise.GetFuture();
+		for (int32 i = 0; i < Futures.Num(); ++i)
+		{
+			Futures[i].Next([State, i](FSimpleHttpResult Result)
+			{
+				if (!State->bResolved.exchange(true))
+				{
+					FSimpleHttpAnyResult AnyResult;
+					AnyResult.Index = i;
+					AnyResult.Result = MoveTemp(Result);
+
+					State->Promise.SetValue(MoveTemp(AnyResult));
+				}
+			});
+		}
+
+		return Future;
+	}
+}
@@ -0,0 +1,196 @@
+// Copyright (C) RenZhai.2020.All Rights Reserved.
+#include "Core/SimpleHttpTrace.h"
+
+#if SIMPLEHTTP_TRACE_ENABLED
+#include "ProfilingDebugging/MiscTrace.h"
+#include "PlatformHttp.h"
+#include "Misc/ScopeLock.h"
+#include <atomic>
+
+UE_TRACE_CHANNEL_DEFINE(SimpleHTTPChannel)
+
+UE_TRACE_EVENT_BEGIN(SimpleHTTP, RequestPhase)
+	UE_TRACE_EVENT_FIELD(uint64, Id)
+	UE_TRACE_EVENT_FIELD(uint64, StartCycle)
+	UE_TRACE_EVENT_FIELD(uint64, EndCycle)
+	UE_TRACE_EVENT_FIELD(uint8, Phase)
+	UE_TRACE_EVENT_FIELD(int32, Status)
+	UE_TRACE_EVENT_FIELD(int64, Size)
+	UE_TRACE_EVENT_FIELD(UE::Trace::WideString, Verb)
+	UE_TRACE_EVENT_FIELD(UE::Trace::WideString, Host)
+UE_TRACE_EVENT_END()
+
+namespace SimpleHTTP
+{
+	namespace Trace
+	{
+		struct FSpan
+		{
+			uint64 Id;
+			EPhase Phase;
+			uint64 StartCycle;
+			FString Verb;
+			FString Host;
+			FString RegionName;
+		};
+
+		struct FSpans
+		{
+			FSpans()
+				:NextId(1)
+				,Num(0)
+			{}
+
+			FCriticalSection Mutex;
+			TMap<const void*, FSpan> Spans;
+			uint64 NextId;
+
+			/*Lets the hooks skip the lock once the channel is off and the last span is gone*/
+			std::atomic<int32> Num;
+		};
+
+		static FSpans &GetSpans()
+		{
+			static FSpans Spans;
+			return Spans;
+		}
+
+		static const TCHAR* GetPhaseName(EPhase Phase)
+		{
+			switch (Phase)
+			{
+			case EPhase::Registration:			return TEXT("Registration");
+			case EPhase::QueueWait:				return TEXT("QueueWait");
+			case EPhase::ConnectAndFirstByte:	return TEXT("ConnectAndFirstByte");
+			case EPhase::BodyTransfer:			return TEXT("BodyTransfer");
+			case EPhase::PostProcess:			return TEXT("PostProcess");
+			case EPhase::Dispatch:				return TEXT("Dispatch");
+			case EPhase::Active:				return TEXT("Active");
+			}
+
+			return TEXT("Unknown");
+		}
+
+		static void OpenPhase(FSpan &Span, EPhase Phase)
+		{
+			Span.Phase = Phase;
+			Span.StartCycle = FPlatformTime::Cycles64();
+			Span.RegionName = FString::Printf(TEXT("SimpleHTTP %s %s #%llu %s"), *Span.Verb, *Span.Host, Span.Id, GetPhaseName(Phase));
+
+			TRACE_BEGIN_REGION(*Span.RegionName);
+		}
+
+		static void ClosePhase(const FSpan &Span, int32 Status, int64 Size)
+		{
+			TRACE_END_REGION(*Span.RegionName);
+
+			UE_TRACE_LOG(SimpleHTTP, RequestPhase, SimpleHTTPChannel)
+				<< RequestPhase.Id(Span.Id)
+				<< RequestPhase.StartCycle(Span.StartCycle)
+				<< RequestPhase.EndCycle(FPlatformTime::Cycles64())
+				<< RequestPhase.Phase((uint8)Span.Phase)
+				<< RequestPhase.Status(Status)
+				<< RequestPhase.Size(Size)
+				<< RequestPhase.Verb(*Span.Verb, Span.Verb.Len())
+				<< RequestPhase.Host(*Span.Host, Span.Host.Len());
+		}
+
+		bool IsEnabled()
+		{
+			return UE_TRACE_CHANNELEXPR_IS_ENABLED(SimpleHTTPChannel);
+		}
+
+		void BeginSpan(const void *Key, EPhase Phase, const FString &Verb, const FString &URL)
+		{
+			if (!Key || !IsEnabled())
+			{
+				return;
+			}
+
+			FSpans &Spans = GetSpans();
+			FScopeLock ScopeLock(&Spans.Mutex);
+
+			if (FSpan *Previous = Spans.Spans.Find(Key))
+			{
+				ClosePhase(*Previous, 0, 0);
+				Spans.Spans.Remove(Key);
+				Spans.Num--;
+			}
+
+			FSpan &Span = Spans.Spans.Add(Key);
+			Span.Id = Spans.NextId++;
+			Span.Verb = Verb;
+			Span.Host = FPlatformHttp::GetUrlDomain(URL);
+			OpenPhase(Span, Phase);
+
+			Spans.Num++;
+		}
+
+		void EnterPhase(const void *Key, EPhase Phase)
+		{
+			FSpans &Spans = GetSpans();
+			if (!Key || Spans.Num == 0)
+			{
+				return;
+			}
+
+			FScopeLock ScopeLock(&Spans.Mutex);
+
+			FSpan *Span = Spans.Spans.Find(Key);
+			if (Span && Phase > Span->Phase)
+			{
+				ClosePhase(*Span, 0, 0);
+				OpenPhase(*Span, Phase);
+			}
+		}
+
+		void EndSpan(const void *Key, int32 Status, int64 Size)
+		{
+			FSpans &Spans = GetSpans();
+			if (!Key || Spans.Num == 0)
+			{
+				return;
+			}
+
+			FScopeLock ScopeLock(&Spans.Mutex);
+
+			FSpan Span;
+			if (Spans.Spans.RemoveAndCopyValue(Key, Span))
+			{
+				ClosePhase(Span, Status, Size);
+				Spans.Num--;
+			}
+		}
+
+		void RequestCreated(const void *Owner, const IHttpRequest *Request)
+		{
+			if (!IsEnabled())
+			{
+				return;
+			}
+
+			EnterPhase(Owner, EPhase::Active);
+
+			if (Request)
+			{
+				BeginSpan(Request, EPhase::QueueWait, Request->GetVerb(), Request->GetURL());
+			}
+		}
+	}
+}
+
+#else
+
+namespace SimpleHTTP
+{
+	namespace Trace
+	{
+		bool IsEnabled() { return false; }
+		void BeginSpan(const void *Key, EPhase Phase, const FString &Verb, const FString &URL) {}
+		void EnterPhase(const void *Key, EPhase Phase) {}
+		void EndSpan(const void *Key, int32 Status, int64 Size) {}
+		void RequestCreated(const void *Owner, const IHttpRequest *Request) {}
+	}
+}
+
+#endif
@@ -0,0 +1,138 @@
+// Copyright (C) RenZhai.2020.All Rights Reserved.
+#include "Core/SimpleHttpUploadSource.h"
+#include "HAL/PlatformFileManager.h"
+#include "HAL/FileManager.h"
+#include "Async/MappedFileHandle.h"
+#include "SimpleHTTPLog.h"
+
+namespace SimpleHTTP
+{
+	namespace UploadSource
+	{
+		/*Reads a fixed block of memory, the owner of the block is kept alive by the archive*/
+		class FMemoryViewArchive : public FArchive
+		{
+		public:
+			FMemoryViewArchive(const uint8* InData, int64 InSize)
+				:Data(InData)
+				,Size(InSize)
+				,Position(0)
+			{
+				SetIsLoading(true);
+				SetIsPersistent(false);
+			}
+
+			virtual void Serialize(void* V, int64 Length) override
+			{
+				if (Length > Size - Position)
+				{
+					UE_LOG(LogSimpleHTTP, Error, TEXT("Upload body read past its end."));
+					FMemory::Memzero(V, Length);
+					SetError();
+					return;
+				}
+
+				FMemory::Memcpy(V, Data + Position, Length);
+				Position += Length;
+			}
+
+			virtual void Seek(int64 InPos) override
+			{
+				Position = FMath::Clamp<int64>(InPos, 0, Size);
+			}
+
+			virtual int64 Tell() override
+			{
+				return Position;
+			}
+
+			virtual int64 TotalSize() override
+			{
+				return Size;
+			}
+
+			virtual bool AtEnd() override
+			{
+				return Position >= Size;
+			}
+
+		protected:
+			const uint8* Data;
+			int64 Size;
+			int64 Position;
+		};
+
+		class FMappedFileArchive : public FMemoryViewArchive
+		{
+		public:
+			FMappedFileArchive(TUniquePtr<IMappedFileHandle> &&InHandle, TUniquePtr<IMappedFileRegion> &&InRegion, const FString &InFilename)
+				:FMemoryViewArchive(InRegion->GetMappedPtr(), InRegion->GetMappedSize())
+				,Handle(MoveTemp(InHandle))
+				,Region(MoveTemp(InRegion))
+				,Filename(InFilename)
+			{
+			}
+
+			virtual FString GetArchiveName() const override
+			{
+				return Filename;
+			}
+
+		private:
+			//Declared in this order so the region is unmapped before its file handle closes
+			TUniquePtr<IMappedFileHandle> Handle;
+			TUniquePtr<IMappedFileRegion> Region;
+			FString Filename;
+		};
+
+		class FSharedBufferArchive : public FMemoryViewArchive
+		{
+		public:
+			FSharedBufferArchive(TSharedRef<const TArray<uint8>, ESPMode::ThreadSafe> InBuffer)
+				:FMemoryViewArchive(InBuffer->GetData(), InBuffer->Num())
+				,Buffer(InBuffer)
+			{
+			}
+
+			virtual FString GetArchiveName() const override
+			{
+				return TEXT("SimpleHttpSharedBufferArchive");
+			}
+
+		private:
+			TSharedRef<const TArray<uint8>, ESPMode::ThreadSafe> Buffer;
+		};
+	}
+
+	TSharedPtr<FArchive, ESPMode::ThreadSafe> CreateMappedFileStream(const FString &LocalPath)
+	{
+		if (FPlatformProperties::SupportsMemoryMappedFiles())
+		{
+			TUniquePtr<IMappedFileHandle> Handle(FPlatformFileManager::Get().GetPlatformFile().OpenMapped(*LocalPath));
+			if (Handle.IsValid() && Handle->GetFileSize() > 0)
+			{
+				TUniquePtr<IMappedFileRegion> Region(Handle->MapRegion(0, Handle->GetFileSize()));
+				if (Region.IsValid())
+				{
+					UE_LOG(LogSimpleHTTP, Log, TEXT("Upload [%s] from a mapping of %lld bytes."), *LocalPath, Region->GetMappedSize());
+
+					return MakeShared<UploadSource::FMappedFileArchive, ESPMode::ThreadSafe>(MoveTemp(Handle), MoveTemp(Region), LocalPath);
+				}
+			}
+		}
+
+		//Empty files can not be mapped, and some platforms can not map at all
+		TSharedPtr<FArchive, ESPMode::ThreadSafe> Reader(IFileManager::Get().CreateFileReader(*LocalPath));
+		if (!Reader.IsValid())
+		{
+			UE_LOG(LogSimpleHTTP, Error, TEXT("Upload file [%s] can not be opened."), *LocalPath);
+		}
+
+		return Reader;
+	}
+
+	TSharedRef<FArchive, ESPMode::ThreadSafe> CreateSharedBufferStream(TSharedRef<const TArray<uint8>, ESPMode::ThreadSafe> Buffer)
+	{
+		return MakeShared<UploadSource::FSharedBufferArchive, ESPMode::ThreadSafe>(Buffer);
+	}
+}
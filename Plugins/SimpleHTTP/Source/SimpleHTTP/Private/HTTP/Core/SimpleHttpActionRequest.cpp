@@ -8,17 +8,49 @@
 #include "Misc/Paths.h"
 #include "Math/UnrealMathUtility.h"
 #include "Misc/FileHelper.h"
+#include "Core/SimpleHttpJsonDecoder.h"
+#include "Async/Async.h"
+#include "UObject/GarbageCollection.h"
+#include "Core/SimpleHttpStats.h"
+#include "Core/SimpleHttpTrace.h"
+#include "Core/SimpleHttpMemoryBudget.h"
+#include "Core/SimpleHttpFrameBudget.h"
+#include "Core/SimpleHttpIntegrity.h"
+#include "Core/SimpleHttpPakMount.h"
+#include "Core/SimpleHttpArchive.h"
+#include "Core/SimpleHttpEventStream.h"
+#include "Core/SimpleHTTPMethod.h"
 //#include "GenericPlatform/GenericPlatformHttp.h"
 
 FSimpleHttpActionRequest::FSimpleHttpActionRequest()
 	:bRequestComplete(false)
 	,bSaveDisk(true)
+	,bExtractArchive(false)
+	,Handle(NAME_None)
+	,PendingWorkers(0)
 {
 }
 
 FSimpleHttpActionRequest::~FSimpleHttpActionRequest()
 {
+	for (const auto &Tmp : BufferedBodies)
+	{
+		SimpleHTTP::FSimpleHttpMemoryBudget::Get().Release(Tmp.Value);
+	}
+}
+
+void FSimpleHttpActionRequest::SetOptions(const FSimpleHttpRequestOptions &NewOptions)
+{
+	Options = NewOptions;
+
+	HeaderFilter.Reset();
+	HeaderFilter.Append(Options.HeaderFilter);
 
+	ExpectedContents.Reset();
+	for (const auto &Tmp : Options.ExpectedContents)
+	{
+		ExpectedContents.Add(SimpleHTTP::SimpleURLEncode(*Tmp.Key), Tmp.Value);
+	}
 }
 
 bool FSimpleHttpActionRequest::Suspend()
@@ -33,6 +65,38 @@ bool FSimpleHttpActionRequest::Cancel()
 	return false;
 }
 
+void FSimpleHttpActionRequest::Tick(float DeltaTime)
+{
+	if (EventStream.IsValid())
+	{
+		DeliverStreamEvents();
+	}
+
+	int32 DeliveredNum = 0;
+	while (DeliveredNum < DeferredDeliveries.Num() && !SimpleHTTP::FSimpleHttpFrameBudget::Get().IsExhausted())
+	{
+		TUniqueFunction<void()> Delivery = MoveTemp(DeferredDeliveries[DeliveredNum++]);
+
+		SimpleHTTP::FSimpleHttpFrameBudget::FScope FrameBudgetScope;
+		Delivery();
+	}
+
+	DeferredDeliveries.RemoveAt(0, DeliveredNum, false);
+}
+
+void FSimpleHttpActionRequest::DeliverWithinFrameBudget(TUniqueFunction<void()> &&Delivery)
+{
+	//Behind deferred deliveries the agents would see the requests out of order
+	if (!Options.bInteractive && (DeferredDeliveries.Num() || SimpleHTTP::FSimpleHttpFrameBudget::Get().IsExhausted()))
+	{
+		DeferredDeliveries.Add(MoveTemp(Delivery));
+		return;
+	}
+
+	SimpleHTTP::FSimpleHttpFrameBudget::FScope FrameBudgetScope;
+	Delivery();
+}
+
 void FSimpleHttpActionRequest::GetObjects(const TArray<FString> &URL, const FString &SavePaths)
 {
 
@@ -49,6 +113,25 @@ void FSimpleHttpActionRequest::DeleteObjects(const TArray<FString> &URL)
 }
 
 void FSimpleHttpActionRequest::HttpRequestComplete(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bConnectedSuccessfully)
+{
+	LLM_SCOPE_BYTAG(SimpleHTTP);
+
+	FlushProgress(Request, Response, bConnectedSuccessfully);
+	ChargeBufferedBody(Request.Get(), Response.IsValid() ? Response->GetContent().Num() : 0);
+	SimpleHTTP::FSimpleHttpStats::Get().RequestFinished(Request, Response, bConnectedSuccessfully);
+	if (EventStream.IsValid())
+	{
+		SimpleHTTP::FSimpleHttpStats::Get().StreamClosed();
+	}
+	SimpleHTTP::Trace::EnterPhase(Request.Get(), SimpleHTTP::Trace::EPhase::PostProcess);
+
+	DeliverWithinFrameBudget([this, Request, Response, bConnectedSuccessfully]()
+	{
+		CompleteRequest(Request, Response, bConnectedSuccessfully);
+	});
+}
+
+void FSimpleHttpActionRequest::CompleteRequest(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bConnectedSuccessfully)
 {
 	FString DebugPram;
 	Request->GetURLParameter(DebugPram);
@@ -57,6 +140,30 @@ void FSimpleHttpActionRequest::HttpRequestComplete(FHttpRequestPtr Request, FHtt
 		*Request->GetURL(),
 		*DebugPram);
 
+	//Stream events always come before the completion of their request
+	if (EventStream.IsValid())
+	{
+		//Engines that can not read a body while it arrives hand it over here, in one piece
+		if (!EventStream->IsAttached() && Response.IsValid())
+		{
+			EventStream->AppendWhole(Response->GetContent().GetData(), Response->GetContent().Num());
+		}
+
+		DeliverStreamEvents();
+	}
+
+	//A part that came back without a body fails its container before the part completes
+	if (bSaveDisk && Request.IsValid() && !(bConnectedSuccessfully && Response.IsValid() && EHttpResponseCodes::IsOk(Response->GetResponseCode())))
+	{
+		PakPartFinished(Request->GetURL(), false);
+	}
+
+	//What a failed archive download staged is removed with the extractor
+	if (ArchiveExtractor.IsValid() && !(bConnectedSuccessfully && Response.IsValid() && EHttpResponseCodes::IsOk(Response->GetResponseCode())))
+	{
+		ArchiveExtractor.Reset();
+	}
+
 	//404 405 100 -199 200 -299
 	if (!Request.IsValid())
 	{
@@ -86,10 +193,35 @@ void FSimpleHttpActionRequest::HttpRequestComplete(FHttpRequestPtr Request, FHtt
 	{
 		if (Request->GetVerb() == "GET")
 		{
-			if (bSaveDisk)
+			if (bExtractArchive)
+			{
+				//Completes, and ends the span, once the worker is done
+				ExtractArchive(Request, Response);
+				return;
+			}
+			else if (bSaveDisk)
 			{
+				const SimpleHTTP::Integrity::FContentCheck Check = GetContentCheck(Request, Response);
+				if (!Check.IsEmpty())
+				{
+					//Completes, and ends the span, once the worker is done
+					VerifyAndStore(Request, Response, Check);
+					return;
+				}
+
 				FString Filename = FPaths::GetCleanFilename(Request->GetURL());
-				FFileHelper::SaveArrayToFile(Response->GetContent(), *(GetPaths() / Filename));
+				const FString SavePath = GetPaths() / Filename;
+				const bool bStored = FFileHelper::SaveArrayToFile(Response->GetContent(), *SavePath);
+
+				PakPartFinished(Request->GetURL(), bStored);
+
+				if (!bStored)
+				{
+					FailStore(Request, Response, SavePath);
+
+					SimpleHTTP::Trace::EndSpan(Request.Get(), Response->GetResponseCode(), Response->GetContent().Num());
+					return;
+				}
 
 				UE_LOG(LogSimpleHTTP, Log, TEXT("Store the obtained http file locally."));
 				UE_LOG(LogSimpleHTTP, Log, TEXT("%s."), *Filename);
@@ -103,30 +235,356 @@ void FSimpleHttpActionRequest::HttpRequestComplete(FHttpRequestPtr Request, FHtt
 		ExecutionCompleteDelegate(Request, Response, bConnectedSuccessfully);
 		UE_LOG(LogSimpleHTTP, Log, TEXT("Request to complete execution of binding agent."));
 	}
+
+	SimpleHTTP::Trace::EndSpan(Request.Get(),
+		Response.IsValid() ? Response->GetResponseCode() : 0,
+		Response.IsValid() ? Response->GetContent().Num() : 0);
 }
 
 void FSimpleHttpActionRequest::HttpRequestProgress(FHttpRequestPtr Request, int32 BytesSent, int32 BytesReceived)
 {
-	FSimpleHttpRequest SimpleHttpRequest;
-	RequestPtrToSimpleRequest(Request, SimpleHttpRequest);
+	LLM_SCOPE_BYTAG(SimpleHTTP);
 
-	SimpleHttpRequestProgressDelegate.ExecuteIfBound(SimpleHttpRequest, BytesSent, BytesReceived);
-	SimpleSingleRequestProgressDelegate.ExecuteIfBound(SimpleHttpRequest, BytesSent, BytesReceived);
+	ChargeBufferedBody(Request.Get(), BytesReceived);
+
+	if (ShouldDeliverProgress(Request, BytesSent, BytesReceived))
+	{
+		DeliverProgress(Request, BytesSent, BytesReceived);
+	}
 
 //	UE_LOG(LogSimpleHTTP, Log, TEXT("Http request progress."));
 }
 
+void FSimpleHttpActionRequest::DeliverProgress(FHttpRequestPtr Request, int64 BytesSent, int64 BytesReceived)
+{
+	if (SimpleHttpProgressEventDelegate.IsBound() || SimpleProgressEventDelegate.IsBound())
+	{
+		FSimpleHttpProgressEvent ProgressEvent;
+		ProgressEvent.Handle = Handle;
+		ProgressEvent.BytesToSend = Request.IsValid() ? Request->GetContentLength() : 0;
+		ProgressEvent.BytesSent = BytesSent;
+		ProgressEvent.BytesReceived = BytesReceived;
+
+		SimpleHttpProgressEventDelegate.ExecuteIfBound(ProgressEvent);
+		SimpleProgressEventDelegate.ExecuteIfBound(ProgressEvent);
+	}
+
+	//The full request copy is only made for the agents that still take it
+	if (SimpleHttpRequestProgressDelegate.IsBound() || SimpleSingleRequestProgressDelegate.IsBound())
+	{
+		FSimpleHttpRequest SimpleHttpRequest;
+		RequestPtrToSimpleRequest(Request, SimpleHttpRequest);
+
+		SimpleHttpRequestProgressDelegate.ExecuteIfBound(SimpleHttpRequest, BytesSent, BytesReceived);
+		SimpleSingleRequestProgressDelegate.ExecuteIfBound(SimpleHttpRequest, BytesSent, BytesReceived);
+	}
+}
+
 void FSimpleHttpActionRequest::HttpRequestHeaderReceived(FHttpRequestPtr Request, const FString& HeaderName, const FString& NewHeaderValue)
 {
-	FSimpleHttpRequest SimpleHttpRequest;
-	RequestPtrToSimpleRequest(Request, SimpleHttpRequest);
+	LLM_SCOPE_BYTAG(SimpleHTTP);
 
-	SimpleHttpRequestHeaderReceivedDelegate.ExecuteIfBound(SimpleHttpRequest, HeaderName, NewHeaderValue);
-	SimpleSingleRequestHeaderReceivedDelegate.ExecuteIfBound(SimpleHttpRequest, HeaderName, NewHeaderValue);
+	SimpleHTTP::Trace::EnterPhase(Request.Get(), SimpleHTTP::Trace::EPhase::BodyTransfer);
+
+	DeliverHeader(HeaderName, NewHeaderValue, [&Request](FSimpleHttpRequest &OutRequest)
+	{
+		RequestPtrToSimpleRequest(Request, OutRequest);
+	});
 
 //	UE_LOG(LogSimpleHTTP, Log, TEXT("Http request header received."));
 }
 
+void FSimpleHttpActionRequest::DeliverHeader(const FString &HeaderName, const FString &NewHeaderValue, TFunctionRef<void(FSimpleHttpRequest&)> MakeRequest)
+{
+	if (HeaderFilter.Num() && !HeaderFilter.Contains(HeaderName))
+	{
+		return;
+	}
+
+	if (SimpleHttpHeaderEventDelegate.IsBound() || SimpleHeaderEventDelegate.IsBound())
+	{
+		FSimpleHttpHeaderEvent HeaderEvent;
+		HeaderEvent.Handle = Handle;
+		HeaderEvent.HeaderName = HeaderName;
+		HeaderEvent.HeaderValue = NewHeaderValue;
+
+		SimpleHttpHeaderEventDelegate.ExecuteIfBound(HeaderEvent);
+		SimpleHeaderEventDelegate.ExecuteIfBound(HeaderEvent);
+	}
+
+	if (SimpleHttpRequestHeaderReceivedDelegate.IsBound() || SimpleSingleRequestHeaderReceivedDelegate.IsBound())
+	{
+		FSimpleHttpRequest SimpleHttpRequest;
+		MakeRequest(SimpleHttpRequest);
+
+		SimpleHttpRequestHeaderReceivedDelegate.ExecuteIfBound(SimpleHttpRequest, HeaderName, NewHeaderValue);
+		SimpleSingleRequestHeaderReceivedDelegate.ExecuteIfBound(SimpleHttpRequest, HeaderName, NewHeaderValue);
+	}
+}
+
+bool FSimpleHttpActionRequest::ShouldDeliverProgress(FHttpRequestPtr Request, int32 BytesSent, int32 BytesReceived)
+{
+	const bool bThrottleTime = Options.MaxProgressEventsPerSecond > 0.f;
+	const bool bThrottleBytes = Options.ProgressByteInterval > 0;
+	if (!bThrottleTime && !bThrottleBytes)
+	{
+		return true;
+	}
+
+	FProgressThrottle &ProgressThrottle = ProgressThrottles.FindOrAdd(Request.Get());
+	ProgressThrottle.BytesSent = BytesSent;
+	ProgressThrottle.BytesReceived = BytesReceived;
+
+	//The end of the upload always goes out, it may be the last event the transport sends
+	const int64 BytesToSend = Request.IsValid() ? Request->GetContentLength() : 0;
+	const bool bUploadDone = BytesToSend > 0 && BytesSent >= BytesToSend && ProgressThrottle.DeliveredBytesSent < BytesToSend;
+
+	const double CurrentTime = FPlatformTime::Seconds();
+	if (!bUploadDone)
+	{
+		if (bThrottleTime && CurrentTime - ProgressThrottle.DeliveryTime < 1.0 / Options.MaxProgressEventsPerSecond)
+		{
+			return false;
+		}
+
+		const int64 TransferredBytes = (int64)BytesSent + (int64)BytesReceived;
+		const int64 DeliveredBytes = ProgressThrottle.DeliveredBytesSent + ProgressThrottle.DeliveredBytesReceived;
+		if (bThrottleBytes && TransferredBytes - DeliveredBytes < Options.ProgressByteInterval)
+		{
+			return false;
+		}
+	}
+
+	ProgressThrottle.DeliveredBytesSent = BytesSent;
+	ProgressThrottle.DeliveredBytesReceived = BytesReceived;
+	ProgressThrottle.DeliveryTime = CurrentTime;
+	return true;
+}
+
+void FSimpleHttpActionRequest::FlushProgress(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bConnectedSuccessfully)
+{
+	FProgressThrottle ProgressThrottle;
+	if (!ProgressThrottles.RemoveAndCopyValue(Request.Get(), ProgressThrottle))
+	{
+		return;
+	}
+
+	//A finished transfer counts as all of its bytes, whatever the throttle held back on the way
+	int64 BytesSent = ProgressThrottle.BytesSent;
+	int64 BytesReceived = ProgressThrottle.BytesReceived;
+	if (bConnectedSuccessfully && Request.IsValid())
+	{
+		BytesSent = FMath::Max<int64>(BytesSent, Request->GetContentLength());
+	}
+	if (Response.IsValid())
+	{
+		BytesReceived = FMath::Max<int64>(BytesReceived, Response->GetContent().Num());
+	}
+
+	if (BytesSent != ProgressThrottle.DeliveredBytesSent || BytesReceived != ProgressThrottle.DeliveredBytesReceived)
+	{
+		DeliverProgress(Request, BytesSent, BytesReceived);
+	}
+}
+
+void FSimpleHttpActionRequest::ChargeBufferedBody(const IHttpRequest *Request, int64 BodyBytes)
+{
+	int64 &BufferedBytes = BufferedBodies.FindOrAdd(Request);
+
+	const int64 DeltaBytes = BodyBytes - BufferedBytes;
+	if (DeltaBytes > 0)
+	{
+		SimpleHTTP::FSimpleHttpMemoryBudget::Get().Charge(DeltaBytes);
+	}
+	else
+	{
+		SimpleHTTP::FSimpleHttpMemoryBudget::Get().Release(-DeltaBytes);
+	}
+
+	BufferedBytes = BodyBytes;
+}
+
+void FSimpleHttpActionRequest::ReleaseBufferedBody(const IHttpRequest *Request)
+{
+	int64 BufferedBytes = 0;
+	if (BufferedBodies.RemoveAndCopyValue(Request, BufferedBytes))
+	{
+		SimpleHTTP::FSimpleHttpMemoryBudget::Get().Release(BufferedBytes);
+	}
+}
+
+SimpleHTTP::Integrity::FContentCheck FSimpleHttpActionRequest::GetContentCheck(FHttpRequestPtr Request, FHttpResponsePtr Response) const
+{
+	SimpleHTTP::Integrity::FContentCheck Check;
+
+	if (const FSimpleHttpExpectedContent* ExpectedContent = ExpectedContents.Find(Request->GetURL()))
+	{
+		Check.Size = ExpectedContent->Size;
+		Check.Hash = ExpectedContent->Hash;
+	}
+
+	if (Options.bVerifyHashHeaders)
+	{
+		Check.HeaderHash = SimpleHTTP::Integrity::GetHashFromHeaders(Response);
+	}
+
+	return Check;
+}
+
+void FSimpleHttpActionRequest::VerifyAndStore(FHttpRequestPtr Request, FHttpResponsePtr Response, const SimpleHTTP::Integrity::FContentCheck &Check)
+{
+	//The handle stays alive and incomplete until the worker is done
+	TSharedRef<FSimpleHttpActionRequest> ActionRequest = AsShared();
+	const FString Filename = FPaths::GetCleanFilename(Request->GetURL());
+	const FString SavePath = GetPaths() / Filename;
+	Async(EAsyncExecution::ThreadPool, [ActionRequest, Request, Response, Check, Filename, SavePath]()
+	{
+		LLM_SCOPE_BYTAG(SimpleHTTP);
+
+		//A hash over a large download costs frames, nothing here needs the game thread
+		FString IntegrityError;
+		const bool bVerified = Check.Run(Response->GetContent(), IntegrityError);
+		const bool bStored = bVerified && FFileHelper::SaveArrayToFile(Response->GetContent(), *SavePath);
+
+		AsyncTask(ENamedThreads::GameThread, [ActionRequest, Request, Response, Filename, SavePath, bVerified, bStored, IntegrityError]()
+		{
+			ActionRequest->PakPartFinished(Request->GetURL(), bStored);
+
+			if (!bVerified)
+			{
+				ActionRequest->FailIntegrity(Request, Response, IntegrityError);
+			}
+			else if (!bStored)
+			{
+				ActionRequest->FailStore(Request, Response, SavePath);
+			}
+			else
+			{
+				UE_LOG(LogSimpleHTTP, Log, TEXT("Store the obtained http file locally."));
+				UE_LOG(LogSimpleHTTP, Log, TEXT("%s."), *Filename);
+
+				ActionRequest->ExecutionCompleteDelegate(Request, Response, true);
+			}
+
+			SimpleHTTP::Trace::EndSpan(Request.Get(), Response->GetResponseCode(), Response->GetContent().Num());
+		});
+	});
+}
+
+void FSimpleHttpActionRequest::FailIntegrity(FHttpRequestPtr Request, FHttpResponsePtr Response, const FString &Error)
+{
+	UE_LOG(LogSimpleHTTP, Error, TEXT("[%s] failed verification, nothing is kept: %s."), *Request->GetURL(), *Error);
+
+	FailedIntegrity.Add(Request.Get());
+	ExecutionCompleteDelegate(Request, Response, false);
+}
+
+void FSimpleHttpActionRequest::FailStore(FHttpRequestPtr Request, FHttpResponsePtr Response, const FString &SavePath)
+{
+	UE_LOG(LogSimpleHTTP, Error, TEXT("[%s] arrived but could not be written to [%s]."), *Request->GetURL(), *SavePath);
+
+	FailedStores.Add(Request.Get());
+	ExecutionCompleteDelegate(Request, Response, false);
+}
+
+void FSimpleHttpActionRequest::ExpectPakParts(const TArray<FString> &URL)
+{
+	if (!Options.bMountPaks)
+	{
+		return;
+	}
+
+	for (const auto &Tmp : URL)
+	{
+		//Named the way CompleteRequest names the stored file
+		const FString Filename = FPaths::GetCleanFilename(SimpleHTTP::SimpleURLEncode(*Tmp));
+		if (SimpleHTTP::PakMount::IsContainerPart(Filename))
+		{
+			PendingPaks.FindOrAdd(SimpleHTTP::PakMount::GetPakFilename(Filename)).Parts.Add(Filename);
+		}
+	}
+}
+
+void FSimpleHttpActionRequest::PakPartFinished(const FString &URL, bool bStored)
+{
+	const FString Filename = FPaths::GetCleanFilename(URL);
+	const FString PakFilename = SimpleHTTP::PakMount::GetPakFilename(Filename);
+
+	FPendingPak *PendingPak = PendingPaks.Find(PakFilename);
+	if (!PendingPak || !PendingPak->Parts.Remove(Filename))
+	{
+		return;
+	}
+
+	PendingPak->bFailed |= !bStored;
+	if (PendingPak->Parts.Num() > 0)
+	{
+		return;
+	}
+
+	const bool bFailed = PendingPak->bFailed;
+	PendingPaks.Remove(PakFilename);
+
+	FSimpleHttpPakMountEvent PakMountEvent;
+	PakMountEvent.Handle = Handle;
+	PakMountEvent.PakFile = GetPaths() / PakFilename;
+
+	if (bFailed)
+	{
+		PakMountEvent.Error = TEXT("a part of the container was not stored");
+		DeliverPakMount(PakMountEvent);
+		return;
+	}
+
+	//Reading the footer and mounting the index are file IO, the pak platform file locks its own lists as it mounts
+	TSharedRef<FSimpleHttpActionRequest> ActionRequest = AsShared();
+	const int32 PakMountOrder = Options.PakMountOrder;
+	++PendingWorkers;
+	Async(EAsyncExecution::ThreadPool, [ActionRequest, PakMountEvent, PakMountOrder]() mutable
+	{
+		LLM_SCOPE_BYTAG(SimpleHTTP);
+
+		if (SimpleHTTP::PakMount::VerifyContainer(PakMountEvent.PakFile, PakMountEvent.Error))
+		{
+			PakMountEvent.bMounted = SimpleHTTP::PakMount::Mount(PakMountEvent.PakFile, PakMountOrder, PakMountEvent.Error);
+		}
+
+		AsyncTask(ENamedThreads::GameThread, [ActionRequest, PakMountEvent]()
+		{
+			ActionRequest->DeliverPakMount(PakMountEvent);
+			ActionRequest->WorkerFinished();
+		});
+	});
+}
+
+void FSimpleHttpActionRequest::FailPendingPaks(const FString &Error)
+{
+	TArray<FString> PakFilenames;
+	PendingPaks.GenerateKeyArray(PakFilenames);
+	PendingPaks.Reset();
+
+	for (const auto &Tmp : PakFilenames)
+	{
+		FSimpleHttpPakMountEvent PakMountEvent;
+		PakMountEvent.Handle = Handle;
+		PakMountEvent.PakFile = GetPaths() / Tmp;
+		PakMountEvent.Error = Error;
+
+		DeliverPakMount(PakMountEvent);
+	}
+}
+
+void FSimpleHttpActionRequest::DeliverPakMount(const FSimpleHttpPakMountEvent &PakMountEvent)
+{
+	if (!PakMountEvent.bMounted)
+	{
+		UE_LOG(LogSimpleHTTP, Error, TEXT("[%s] is not mounted: %s."), *PakMountEvent.PakFile, *PakMountEvent.Error);
+	}
+
+	SimpleHttpPakMountDelegate.ExecuteIfBound(PakMountEvent);
+	SimplePakMountDelegate.ExecuteIfBound(PakMountEvent);
+}
+
 void FSimpleHttpActionRequest::Print(const FString &Msg, float Time /*= 10.f*/, FColor Color /*= FColor::Red*/)
 {
 #ifdef PLATFORM_PROJECT
@@ -139,13 +597,265 @@ void FSimpleHttpActionRequest::Print(const FString &Msg, float Time /*= 10.f*/,
 
 void FSimpleHttpActionRequest::ExecutionCompleteDelegate(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bConnectedSuccessfully)
 {
+	SimpleHTTP::Trace::EnterPhase(Request.Get(), SimpleHTTP::Trace::EPhase::Dispatch);
+
 	FSimpleHttpRequest SimpleHttpRequest;
-	FSimpleHttpResponse SimpleHttpResponse;
-	ResponsePtrToSimpleResponse(Response, SimpleHttpResponse);
 	RequestPtrToSimpleRequest(Request, SimpleHttpRequest);
 
-	SimpleHttpRequestCompleteDelegate.ExecuteIfBound(SimpleHttpRequest, SimpleHttpResponse, bConnectedSuccessfully);
-	SimpleCompleteDelegate.ExecuteIfBound(SimpleHttpRequest, SimpleHttpResponse, bConnectedSuccessfully);
+	//The engine saw a good transfer, only FailIntegrity knows the body was rejected
+	if (FailedIntegrity.Remove(Request.Get()) > 0)
+	{
+		SimpleHttpRequest.Status = ESimpleHttpStarte::Failed_Integrity;
+	}
+	else if (FailedUploads.Remove(Request.Get()) > 0 || FailedStores.Remove(Request.Get()) > 0)
+	{
+		SimpleHttpRequest.Status = ESimpleHttpStarte::Failed;
+	}
+
+	DeliverComplete(SimpleHttpRequest, Response, bConnectedSuccessfully);
+}
+
+void FSimpleHttpActionRequest::DeliverComplete(const FSimpleHttpRequest &SimpleHttpRequest, FHttpResponsePtr Response, bool bConnectedSuccessfully)
+{
+	if (Options.bAggregateResults)
+	{
+		if (Options.ResultChunkSize > 0 && ResultRecords.Max() == 0)
+		{
+			ResultRecords.Reserve(Options.ResultChunkSize);
+		}
+
+		FSimpleHttpResultRecord &ResultRecord = ResultRecords.AddDefaulted_GetRef();
+		ResultRecord.URL = SimpleHttpRequest.URL;
+		ResultRecord.ElapsedTime = SimpleHttpRequest.ElapsedTime;
+		ResultRecord.ResponseCode = Response.IsValid() ? Response->GetResponseCode() : 0;
+		ResultRecord.ContentLength = Response.IsValid() ? Response->GetContentLength() : 0;
+		ResultRecord.bSucceeded = bConnectedSuccessfully && Response.IsValid() && EHttpResponseCodes::IsOk(ResultRecord.ResponseCode);
+
+		if (SimpleHttpRequest.Status == ESimpleHttpStarte::Failed_Integrity)
+		{
+			ResultRecord.Error = TEXT("Integrity check failed");
+		}
+		else if (SimpleHttpRequest.Status == ESimpleHttpStarte::Failed && Response.IsValid())
+		{
+			ResultRecord.Error = SimpleHttpRequest.Verb == TEXT("GET") ? TEXT("Could not be stored") : TEXT("Upload source changed");
+		}
+		else if (!bConnectedSuccessfully || !Response.IsValid())
+		{
+			ResultRecord.Error = TEXT("No response");
+		}
+		else if (!ResultRecord.bSucceeded)
+		{
+			ResultRecord.Error = FString::Printf(TEXT("HTTP %d"), ResultRecord.ResponseCode);
+		}
+
+		//Holding the response would keep every body of the handle alive until the records are delivered
+		if (Options.bKeepResultBodies)
+		{
+			ResultRecord.Response = FSimpleHttpResponseView(Response);
+		}
+
+		if (Options.ResultChunkSize > 0 && ResultRecords.Num() >= Options.ResultChunkSize)
+		{
+			FlushResultRecords();
+		}
+
+		return;
+	}
+
+	//The struct copy of the response is only made for the agents that take it
+	if (SimpleHttpRequestCompleteDelegate.IsBound() || SimpleCompleteDelegate.IsBound())
+	{
+		FSimpleHttpResponse SimpleHttpResponse;
+		ResponsePtrToSimpleResponse(Response, SimpleHttpResponse);
+
+		SimpleHttpRequestCompleteDelegate.ExecuteIfBound(SimpleHttpRequest, SimpleHttpResponse, bConnectedSuccessfully);
+		SimpleCompleteDelegate.ExecuteIfBound(SimpleHttpRequest, SimpleHttpResponse, bConnectedSuccessfully);
+	}
+
+	SimpleCompleteViewDelegate.ExecuteIfBound(SimpleHttpRequest, FSimpleHttpResponseView(Response), bConnectedSuccessfully);
+
+	if (SimpleCompleteStructDelegate.IsBound())
+	{
+		DecodeResponseToStruct(SimpleHttpRequest, Response, bConnectedSuccessfully);
+	}
+}
+
+void FSimpleHttpActionRequest::DeliverCachedResponse(const FString &URL, FHttpResponsePtr CachedResponse)
+{
+	FSimpleHttpRequest SimpleHttpRequest;
+	SimpleHttpRequest.Verb = TEXT("GET");
+	SimpleHttpRequest.URL = URL;
+	SimpleHttpRequest.Status = ESimpleHttpStarte::Succeeded;
+
+	UE_LOG(LogSimpleHTTP, Log, TEXT("[%s] is served from the prefetch cache."), *URL);
+
+	DeliverComplete(SimpleHttpRequest, CachedResponse, true);
+}
+
+void FSimpleHttpActionRequest::FlushResultRecords()
+{
+	if (ResultRecords.Num() == 0)
+	{
+		return;
+	}
+
+	//Agents may finish more operations of this handle while they run
+	TArray<FSimpleHttpResultRecord> Results = MoveTemp(ResultRecords);
+
+	if (SimpleHttpResultBatchDelegate.IsBound() && Options.bKeepResultBodies)
+	{
+		//Made right before the call, nothing keeps them from the garbage collector afterwards
+		for (auto &Tmp : Results)
+		{
+			Tmp.Content = NewObject<USimpleHttpContent>();
+			Tmp.Content->Content = Tmp.Response.GetSharedContent();
+		}
+	}
+
+	SimpleHttpResultBatchDelegate.ExecuteIfBound(Results);
+
+	SimpleResultBatchDelegate.ExecuteIfBound(Results);
+}
+
+void FSimpleHttpActionRequest::DecodeResponseToStruct(const FSimpleHttpRequest &SimpleHttpRequest, FHttpResponsePtr Response, bool bConnectedSuccessfully)
+{
+	const UScriptStruct* Struct = DecodeStruct.Get();
+	if (Struct && !SimpleHTTP::CanDecodeOffGameThread(Struct))
+	{
+		UE_LOG(LogSimpleHTTP, Error, TEXT("Struct [%s] holds object references and can not be decoded on a worker thread."), *Struct->GetName());
+		Struct = nullptr;
+	}
+
+	if (!Struct || !bConnectedSuccessfully || !Response.IsValid() || !EHttpResponseCodes::IsOk(Response->GetResponseCode()))
+	{
+		SimpleCompleteStructDelegate.ExecuteIfBound(SimpleHttpRequest, FSimpleHttpResponseView(Response), nullptr, false);
+		return;
+	}
+
+	//The request may be reaped from the manager before the worker is done, it is kept alive by the task
+	TSharedRef<FSimpleHttpActionRequest> ActionRequest = AsShared();
+	TWeakObjectPtr<const UScriptStruct> WeakStruct = DecodeStruct;
+	++PendingWorkers;
+	Async(EAsyncExecution::ThreadPool, [ActionRequest, SimpleHttpRequest, Response, WeakStruct]()
+	{
+		LLM_SCOPE_BYTAG(SimpleHTTP);
+
+		TSharedPtr<FStructOnScope, ESPMode::ThreadSafe> DecodedStruct;
+		{
+			//The struct can not be collected while it is read
+			FGCScopeGuard GCGuard;
+			if (const UScriptStruct* Struct = WeakStruct.Get())
+			{
+				DecodedStruct = SimpleHTTP::DecodeJsonToStruct(Response->GetContent(), Struct);
+			}
+		}
+
+		AsyncTask(ENamedThreads::GameThread, [ActionRequest, SimpleHttpRequest, Response, DecodedStruct]()
+		{
+			ActionRequest->SimpleCompleteStructDelegate.ExecuteIfBound(SimpleHttpRequest, FSimpleHttpResponseView(Response), DecodedStruct, DecodedStruct.IsValid());
+			ActionRequest->WorkerFinished();
+		});
+	});
+}
+
+bool FSimpleHttpActionRequest::DeferUntilWorkersDone(TFunction<void()> Complete)
+{
+	if (PendingWorkers == 0)
+	{
+		return false;
+	}
+
+	WorkersDoneCompletion = MoveTemp(Complete);
+	return true;
+}
+
+void FSimpleHttpActionRequest::WorkerFinished()
+{
+	check(PendingWorkers > 0);
+	if (--PendingWorkers == 0 && WorkersDoneCompletion)
+	{
+		TFunction<void()> Complete = MoveTemp(WorkersDoneCompletion);
+		WorkersDoneCompletion = nullptr;
+
+		Complete();
+	}
+}
+
+void FSimpleHttpActionRequest::DeliverStreamEvents()
+{
+	TArray<FSimpleHttpStreamEvent> StreamEvents;
+	EventStream->Dequeue(StreamEvents);
+
+	for (auto &Tmp : StreamEvents)
+	{
+		Tmp.Handle = Handle;
+
+		SimpleHttpStreamEventDelegate.ExecuteIfBound(Tmp);
+		SimpleStreamEventDelegate.ExecuteIfBound(Tmp);
+	}
+}
+
+bool FSimpleHttpActionRequest::HasContentCheck(const FString &URL) const
+{
+	return Options.bVerifyHashHeaders || ExpectedContents.Contains(SimpleHTTP::SimpleURLEncode(*URL));
+}
+
+void FSimpleHttpActionRequest::ExtractArchive(FHttpRequestPtr Request, FHttpResponsePtr Response)
+{
+	//The handle stays alive and incomplete until the worker is done
+	TSharedRef<FSimpleHttpActionRequest> ActionRequest = AsShared();
+	const FString TargetDir = GetPaths();
+	const SimpleHTTP::Integrity::FContentCheck Check = GetContentCheck(Request, Response);
+	TSharedPtr<SimpleHTTP::Archive::FStreamExtractor, ESPMode::ThreadSafe> Extractor = ArchiveExtractor;
+	ArchiveExtractor.Reset();
+
+	Async(EAsyncExecution::ThreadPool, [ActionRequest, Request, Response, TargetDir, Check, Extractor]()
+	{
+		LLM_SCOPE_BYTAG(SimpleHTTP);
+
+		int32 Entries = 0;
+		FString Error;
+		bool bExtracted = false;
+		int64 Size = Response->GetContent().Num();
+
+		if (Extractor.IsValid())
+		{
+			//Entries were written while the body arrived, what is left is moving them into place
+			bExtracted = Extractor->Finish(Entries, Error);
+			Size = Extractor->GetReceivedBytes();
+		}
+		else
+		{
+			//The archive is checked whole before a single entry is written
+			FString IntegrityError;
+			if (!Check.Run(Response->GetContent(), IntegrityError))
+			{
+				AsyncTask(ENamedThreads::GameThread, [ActionRequest, Request, Response, IntegrityError, Size]()
+				{
+					ActionRequest->FailIntegrity(Request, Response, IntegrityError);
+					SimpleHTTP::Trace::EndSpan(Request.Get(), Response->GetResponseCode(), Size);
+				});
+				return;
+			}
+
+			bExtracted = SimpleHTTP::Archive::Extract(Response->GetContent(), TargetDir, Entries, Error);
+		}
+
+		if (bExtracted)
+		{
+			UE_LOG(LogSimpleHTTP, Log, TEXT("[%s] extracted %d entries to [%s]."), *Request->GetURL(), Entries, *TargetDir);
+		}
+		else
+		{
+			UE_LOG(LogSimpleHTTP, Error, TEXT("[%s] could not be extracted: %s."), *Request->GetURL(), *Error);
+		}
+
+		AsyncTask(ENamedThreads::GameThread, [ActionRequest, Request, Response, bExtracted, Size]()
+		{
+			ActionRequest->ExecutionCompleteDelegate(Request, Response, bExtracted);
+			SimpleHTTP::Trace::EndSpan(Request.Get(), Response->GetResponseCode(), Size);
+		});
+	});
 }
 
 bool FSimpleHttpActionRequest::GetObject(const FString &URL, const FString &SavePaths)
@@ -183,7 +893,27 @@ bool FSimpleHttpActionRequest::DeleteObject(const FString &URL)
 	return false;
 }
 
-bool FSimpleHttpActionRequest::PostObject(const FString &URL)
+bool FSimpleHttpActionRequest::PostObject(const FString &URL, TArray<uint8> &&FormBody)
+{
+	return false;
+}
+
+bool FSimpleHttpActionRequest::PostMultipartForm(const FString &URL, const SimpleHTTP::FSimpleHttpMultipartForm &Form)
+{
+	return false;
+}
+
+bool FSimpleHttpActionRequest::GetArchive(const FString &URL, const FString &ExtractPaths)
+{
+	return false;
+}
+
+bool FSimpleHttpActionRequest::PutDirectory(const FString &URL, const FString &LocalDirectory, bool bGzip)
+{
+	return false;
+}
+
+bool FSimpleHttpActionRequest::GetStream(const FString &URL, bool bServerSentEvents)
 {
 	return false;
 }
\ No newline at end of file
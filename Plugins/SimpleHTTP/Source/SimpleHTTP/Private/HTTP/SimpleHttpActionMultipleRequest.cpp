@@ -8,14 +8,139 @@
 #include "Misc/FileHelper.h"
 #include "Misc/Paths.h"
 #include "Math/UnrealMathUtility.h"
+#include "Core/SimpleHttpSyntheticResponse.h"
+#include "Core/SimpleHttpJsonDecoder.h"
+#include "Core/SimpleHTTPMethod.h"
+#include "Dom/JsonObject.h"
+#include "Serialization/JsonWriter.h"
+#include "Misc/Base64.h"
+#include "PlatformHttp.h"
+#include "Core/SimpleHttpUploadSource.h"
+#include "Containers/Queue.h"
+#include "Core/SimpleHttpStats.h"
+#include "Core/SimpleHttpTrace.h"
+#include "Core/SimpleHttpMemoryBudget.h"
+#include "Core/SimpleHttpFrameBudget.h"
+#include "Core/SimpleHttpPrefetchCache.h"
+#include "Async/Async.h"
+#include "HAL/Event.h"
+#include <atomic>
+
+/**
+ * Walks a folder on a worker and hands the files to the game thread through a bounded queue.
+ * The files are opened for upload on the worker as well, so the game thread only builds requests.
+ */
+struct FSimpleHttpActionMultipleRequest::FUploadScan
+{
+	struct FFile
+	{
+		FString Path;
+		TSharedPtr<FArchive, ESPMode::ThreadSafe> Stream;
+	};
+
+	FUploadScan(int32 InCapacity)
+		:Capacity(InCapacity)
+		,SpaceEvent(FPlatformProcess::GetSynchEventFromPool(false))
+		,QueuedCount(0)
+		,FoundCount(0)
+		,bFinished(false)
+		,bCancelled(false)
+	{}
+
+	~FUploadScan()
+	{
+		FPlatformProcess::ReturnSynchEventToPool(SpaceEvent);
+	}
+
+	void Run(const FString &LocalPaths)
+	{
+		LLM_SCOPE_BYTAG(SimpleHTTP);
+
+		IFileManager::Get().IterateDirectoryRecursively(*LocalPaths, [this](const TCHAR* Filename, bool bIsDirectory)
+		{
+			if (bIsDirectory)
+			{
+				return !bCancelled;
+			}
+
+			//Keeps at most Capacity files open ahead of the uploads, Dequeue and Cancel wake the worker
+			while (QueuedCount >= Capacity && !bCancelled)
+			{
+				SpaceEvent->Wait();
+			}
+
+			if (bCancelled)
+			{
+				return false;
+			}
+
+			//A file that can not be opened is still handed out, its upload is reported as failed
+			FFile File;
+			File.Path = Filename;
+			File.Stream = SimpleHTTP::CreateMappedFileStream(File.Path);
+
+			Files.Enqueue(MoveTemp(File));
+			QueuedCount++;
+			FoundCount++;
+
+			return true;
+		});
+
+		bFinished = true;
+	}
+
+	bool Dequeue(FFile &OutFile)
+	{
+		if (Files.Dequeue(OutFile))
+		{
+			QueuedCount--;
+			SpaceEvent->Trigger();
+			return true;
+		}
+
+		return false;
+	}
+
+	void Cancel()
+	{
+		bCancelled = true;
+		SpaceEvent->Trigger();
+	}
+
+	FORCEINLINE int32 GetFoundCount() const { return FoundCount; }
+
+	/*The worker is done and every file it found was handed out*/
+	FORCEINLINE bool IsDrained() const { return bFinished && Files.IsEmpty(); }
+
+private:
+	const int32 Capacity;
+	FEvent* SpaceEvent;
+
+	TQueue<FFile, EQueueMode::Spsc> Files;
+	std::atomic<int32> QueuedCount;
+	std::atomic<int32> FoundCount;
+	std::atomic<bool> bFinished;
+	std::atomic<bool> bCancelled;
+};
 
 FSimpleHttpActionMultipleRequest::FSimpleHttpActionMultipleRequest()
 	:Super()
 	,RequestNumber(0)
+	,bPausedByMemoryBudget(false)
+	,bPausedByFrameBudget(false)
 {
 
 }
 
+FSimpleHttpActionMultipleRequest::~FSimpleHttpActionMultipleRequest()
+{
+	//A scan worker waiting for room would otherwise wait for a Dequeue that never comes
+	if (UploadScan.IsValid())
+	{
+		UploadScan->Cancel();
+	}
+}
+
 bool FSimpleHttpActionMultipleRequest::Suspend()
 {
 	return false;
@@ -23,90 +148,130 @@ bool FSimpleHttpActionMultipleRequest::Suspend()
 
 bool FSimpleHttpActionMultipleRequest::Cancel()
 {
-	for (auto &Tmp : Requests)
+	//Containers are reported before any of their parts completes as cancelled
+	FailPendingPaks(TEXT("the download was cancelled"));
+
+	//Files the scan has not handed out yet are dropped with it
+	if (UploadScan.IsValid())
+	{
+		UploadScan->Cancel();
+		UploadScan.Reset();
+	}
+
+	//Queued requests never reached the transport, they are failed here instead of cancelled
+	TArray<TSharedPtr<IHTTPClientRequest>> PendingRequests;
+	for (auto &Tmp : HostQueues)
 	{
-		if (Tmp.IsValid())
+		for (int32 i = Tmp.NextPending; i < Tmp.Pending.Num(); ++i)
 		{
-			FHTTPClient().Cancel(Tmp.ToSharedRef());
+			Requests.Remove(Tmp.Pending[i]->GetHttpRequest());
+			PendingRequests.Add(MoveTemp(Tmp.Pending[i]));
+			SimpleHTTP::FSimpleHttpStats::Get().RequestDequeued();
 		}
+
+		Tmp.Pending.Reset();
+		Tmp.NextPending = 0;
+	}
+
+	//A cancelled request may complete right away and release itself from Requests
+	TArray<TSharedPtr<IHTTPClientRequest>> ActiveRequests;
+	Requests.GenerateValueArray(ActiveRequests);
+	for (auto &Tmp : ActiveRequests)
+	{
+		FHTTPClient().Cancel(Tmp.ToSharedRef());
 	}
 
+	for (auto &Tmp : PendingRequests)
+	{
+		FailRequest(Tmp);
+	}
+
+	CompleteIfIdle();
+
 	return true;
 }
 
 void FSimpleHttpActionMultipleRequest::GetObjects(const TArray<FString> &URL, const FString &SavePaths)
 {
 	SetPaths(SavePaths);
+	ExpectPakParts(URL);
 
+	Requests.Reserve(Requests.Num() + URL.Num());
 	for (const auto &Tmp : URL)
 	{
-		Requests.Add(MakeShareable(new FGetObjectRequest(Tmp)));
-		TSharedPtr<IHTTPClientRequest> Request = Requests.Last();
+		TSharedPtr<IHTTPClientRequest> Request = AddRequest(MakeShared<FGetObjectRequest>(Tmp));
 
 		REQUEST_BIND_FUN(FSimpleHttpActionMultipleRequest)
 
-		if (FHTTPClient().Execute(Request.ToSharedRef()))
-		{
-			RequestNumber++;
-
-			UE_LOG(LogSimpleHTTP, Log, TEXT("Multple get objects request number %d by multple request."), RequestNumber);
-		}
-		else
-		{
-			UE_LOG(LogSimpleHTTP, Error, TEXT("Multple get objects request execution failed."));
-		}
-
-		UE_LOG(LogSimpleHTTP, Log, TEXT("GetObjects RequestNumber = %i"), RequestNumber);
+		SubmitRequest(Request);
 	}
+
+	DispatchPendingRequests();
 }
 
 void FSimpleHttpActionMultipleRequest::GetObjects(const TArray<FString> &URL)
 {
 	bSaveDisk = false;
 
+	//Prefetched bodies do not go to the network, their agents fire from the next Tick
+	TArray<FString> MissedURL;
+	MissedURL.Reserve(URL.Num());
 	for (const auto &Tmp : URL)
 	{
-		Requests.Add(MakeShareable(new FGetObjectRequest(Tmp)));
-		TSharedPtr<IHTTPClientRequest> Request = Requests.Last();
-
-		REQUEST_BIND_FUN(FSimpleHttpActionMultipleRequest)
-
-		if (FHTTPClient().Execute(Request.ToSharedRef()))
+		FHttpResponsePtr CachedResponse = SimpleHTTP::FSimpleHttpPrefetchCache::Get().Find(Tmp);
+		if (CachedResponse.IsValid())
 		{
 			RequestNumber++;
-			UE_LOG(LogSimpleHTTP, Log, TEXT("Multple get objects request number %d by multple request."), RequestNumber);
+			DeliverOnNextTick([this, Tmp, CachedResponse]()
+			{
+				DeliverCachedResponse(Tmp, CachedResponse);
+				OperationComplete();
+			});
 		}
 		else
 		{
-			UE_LOG(LogSimpleHTTP, Error, TEXT("Multple get objects request execution failed."));
+			MissedURL.Add(Tmp);
 		}
+	}
+
+	if (IsBatchEnabled())
+	{
+		ExecuteBatches(TEXT("GET"), MissedURL);
+		return;
+	}
+
+	Requests.Reserve(Requests.Num() + MissedURL.Num());
+	for (const auto &Tmp : MissedURL)
+	{
+		TSharedPtr<IHTTPClientRequest> Request = AddRequest(MakeShared<FGetObjectRequest>(Tmp));
 
-		UE_LOG(LogSimpleHTTP, Log, TEXT("GetObjects RequestNumber = %i"), RequestNumber);
+		REQUEST_BIND_FUN(FSimpleHttpActionMultipleRequest)
+
+		SubmitRequest(Request);
 	}
+
+	DispatchPendingRequests();
 }
 
 void FSimpleHttpActionMultipleRequest::DeleteObjects(const TArray<FString> &URL)
 {
+	if (IsBatchEnabled())
+	{
+		ExecuteBatches(TEXT("DELETE"), URL);
+		return;
+	}
+
+	Requests.Reserve(Requests.Num() + URL.Num());
 	for (const auto &Tmp : URL)
 	{
-		Requests.Add(MakeShareable(new FDeleteObjectsRequest(Tmp)));
-		TSharedPtr<IHTTPClientRequest> Request = Requests.Last();
+		TSharedPtr<IHTTPClientRequest> Request = AddRequest(MakeShared<FDeleteObjectsRequest>(Tmp));
 
 		REQUEST_BIND_FUN(FSimpleHttpActionMultipleRequest)
 
-		if (FHTTPClient().Execute(Request.ToSharedRef()))
-		{
-			RequestNumber++;
-
-			UE_LOG(LogSimpleHTTP, Log, TEXT("Multple delete request number %d by multple request."), RequestNumber);
-		}
-		else
-		{
-			UE_LOG(LogSimpleHTTP, Error, TEXT("Fail to delete object."));
-		}
-
-		UE_LOG(LogSimpleHTTP, Log, TEXT("DeleteObjects RequestNumber = %i"), RequestNumber);
+		SubmitRequest(Request);
 	}
+
+	DispatchPendingRequests();
 }
 
 bool FSimpleHttpActionMultipleRequest::PutObject(const FString &URL, const FString &LocalPaths)
@@ -115,83 +280,500 @@ bool FSimpleHttpActionMultipleRequest::PutObject(const FString &URL, const FStri
 	{
 		UE_LOG(LogSimpleHTTP, Log, TEXT("Set path %s."), *LocalPaths);
 	}
+
+	if (!IFileManager::Get().DirectoryExists(*LocalPaths))
+	{
+		UE_LOG(LogSimpleHTTP, Error, TEXT("The upload folder does not exist [%s]."), *LocalPaths);
+		return false;
+	}
 	
 	SetPaths(LocalPaths);
+	UploadURL = URL;
 
-	//Start filtering path
-	TArray<FString> AllPaths;
-	IFileManager::Get().FindFilesRecursive(AllPaths, *LocalPaths, TEXT("*"), true, false);
-	
-	if (AllPaths.Num())
+	//The folder is walked on a worker, files are uploaded from Tick as they are found
+	UploadScan = MakeShared<FUploadScan, ESPMode::ThreadSafe>(FMath::Max(Options.UploadPipelineDepth, 1));
+
+	TSharedRef<FUploadScan, ESPMode::ThreadSafe> Scan = UploadScan.ToSharedRef();
+	Async(EAsyncExecution::ThreadPool, [Scan, LocalPaths]()
+	{
+		Scan->Run(LocalPaths);
+	});
+
+	return true;
+}
+
+void FSimpleHttpActionMultipleRequest::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	//Queued transfers held back by a budget go once it allows them, bytes are released by other handles
+	const bool bMemoryReleased = bPausedByMemoryBudget && !SimpleHTTP::FSimpleHttpMemoryBudget::Get().IsExceeded();
+	if (bPausedByFrameBudget || bMemoryReleased)
 	{
-		for (auto &Tmp : AllPaths)
+		bPausedByFrameBudget = false;
+		if (bMemoryReleased)
 		{
-			UE_LOG(LogSimpleHTTP, Log, TEXT("The uploaded resources are[%s]."), *Tmp);
+			bPausedByMemoryBudget = false;
 		}
+
+		DispatchPendingRequests();
 	}
-	else
+
+	if (UploadScan.IsValid())
 	{
-		UE_LOG(LogSimpleHTTP, Error, TEXT("The obtained content is empty. Please check whether there are resources under this path%s.[%s]"), *LocalPaths);
-		return false;
+		PumpUploadScan();
 	}
+}
+
+void FSimpleHttpActionMultipleRequest::PumpUploadScan()
+{
+	const uint32 PipelineDepth = (uint32)FMath::Max(Options.UploadPipelineDepth, 1);
 
-	for (const auto &Tmp: AllPaths)
+	FUploadScan::FFile File;
+	while (RequestNumber < PipelineDepth && UploadScan->Dequeue(File))
 	{
-		TArray<uint8> ByteData;
-		FFileHelper::LoadFileToArray(ByteData, *Tmp);
+		UE_LOG(LogSimpleHTTP, Verbose, TEXT("The uploaded resources are[%s]."), *File.Path);
 
-		FString ObjectName = FPaths::GetCleanFilename(Tmp);
+		if (!File.Stream.IsValid())
+		{
+			UE_LOG(LogSimpleHTTP, Error, TEXT("The file could not be opened for upload [%s]."), *File.Path);
+
+			FSimpleHttpRequest SimpleHttpRequest;
+			SimpleHttpRequest.Verb = TEXT("PUT");
+			SimpleHttpRequest.URL = UploadURL / FPaths::GetCleanFilename(File.Path);
+			SimpleHttpRequest.Status = ESimpleHttpStarte::Failed;
+
+			RequestNumber++;
+			DeliverComplete(SimpleHttpRequest, nullptr, false);
+			OperationComplete();
+
+			if (!UploadScan.IsValid())
+			{
+				return;
+			}
+			continue;
+		}
 
-		Requests.Add(MakeShareable(new FPutObjectRequest(URL / ObjectName, ByteData)));
-		TSharedPtr<IHTTPClientRequest> Request = Requests.Last();
+		TSharedPtr<IHTTPClientRequest> Request = AddRequest(MakeShared<FPutObjectRequest>(UploadURL / FPaths::GetCleanFilename(File.Path), File.Stream.ToSharedRef()));
 
 		REQUEST_BIND_FUN(FSimpleHttpActionMultipleRequest)
 
-		if (FHTTPClient().Execute(Request.ToSharedRef()))
+		SubmitRequest(Request);
+		DispatchPendingRequests();
+
+		//A failed start completes agents that may cancel the handle
+		if (!UploadScan.IsValid())
 		{
-			RequestNumber++;
+			return;
+		}
+	}
 
-			UE_LOG(LogSimpleHTTP, Log, TEXT("Multple put object request number %d by multple request."), RequestNumber);
+	if (UploadScan->IsDrained())
+	{
+		if (UploadScan->GetFoundCount() == 0)
+		{
+			UE_LOG(LogSimpleHTTP, Error, TEXT("The obtained content is empty. Please check whether there are resources under this path[%s]."), *GetPaths());
 		}
 		else
 		{
-			UE_LOG(LogSimpleHTTP, Error, TEXT("Fail to put object."));
+			UE_LOG(LogSimpleHTTP, Log, TEXT("Scanned %d files under [%s]."), UploadScan->GetFoundCount(), *GetPaths());
 		}
 
-		UE_LOG(LogSimpleHTTP, Log, TEXT("PutObject RequestNumber = %i"), RequestNumber);
+		UploadScan.Reset();
+		CompleteIfIdle();
 	}
-
-	return RequestNumber > 0;
 }
 
 void FSimpleHttpActionMultipleRequest::ExecutionCompleteDelegate(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bConnectedSuccessfully)
 {
 	Super::ExecutionCompleteDelegate(Request, Response, bConnectedSuccessfully);
 
+	//Delivered, the handle has no further use for the request or its body
+	ReleaseRequest(Request.Get());
+
+	OperationComplete();
+}
+
+void FSimpleHttpActionMultipleRequest::OperationComplete()
+{
 	if (RequestNumber > 0)
 	{
 		RequestNumber--;
-		if (RequestNumber <= 0)
+
+		UE_LOG(LogSimpleHTTP, Log, TEXT("ExecutionCompleteDelegate RequestNumber = %i"), RequestNumber);
+
+		CompleteIfIdle();
+	}
+	else
+	{
+		UE_LOG(LogSimpleHTTP, Error, TEXT("Request quantity error."));
+	}
+}
+
+void FSimpleHttpActionMultipleRequest::CompleteIfIdle()
+{
+	//A running folder scan still has uploads to hand out
+	if (RequestNumber > 0 || UploadScan.IsValid() || bRequestComplete)
+	{
+		return;
+	}
+
+	//Struct and pak mount agents fire before the handle reports completion
+	if (DeferUntilWorkersDone([this]() { CompleteIfIdle(); }))
+	{
+		return;
+	}
+
+	FlushResultRecords();
+
+	AllRequestCompleteDelegate.ExecuteIfBound();
+	AllTasksCompletedDelegate.ExecuteIfBound();
+
+	bRequestComplete = true;
+
+	UE_LOG(LogSimpleHTTP, Log, TEXT("The task has been completed."));
+}
+
+TSharedPtr<IHTTPClientRequest> FSimpleHttpActionMultipleRequest::AddRequest(TSharedRef<IHTTPClientRequest> Request)
+{
+	return Requests.Add(Request->GetHttpRequest(), Request);
+}
+
+void FSimpleHttpActionMultipleRequest::ReleaseRequest(const IHttpRequest *Request)
+{
+	Requests.Remove(Request);
+	ReleaseBufferedBody(Request);
+}
+
+void FSimpleHttpActionMultipleRequest::SubmitRequest(TSharedPtr<IHTTPClientRequest> Request)
+{
+	const FString Host = FPlatformHttp::GetUrlDomain(Request->GetURL());
+
+	int32 HostIndex = INDEX_NONE;
+	if (const int32* FoundHostIndex = HostIndices.Find(Host))
+	{
+		HostIndex = *FoundHostIndex;
+	}
+	else
+	{
+		HostIndex = HostQueues.AddDefaulted();
+		HostQueues[HostIndex].Host = Host;
+		HostIndices.Add(Host, HostIndex);
+	}
+
+	HostQueues[HostIndex].Pending.Add(Request);
+	RequestNumber++;
+
+	SimpleHTTP::FSimpleHttpStats::Get().RequestQueued();
+}
+
+void FSimpleHttpActionMultipleRequest::DispatchPendingRequests()
+{
+	//Agents of a failed start may add hosts, they are dispatched by the call that added them
+	const int32 HostNum = HostQueues.Num();
+	for (int32 i = 0; i < HostNum; ++i)
+	{
+		DispatchPendingRequests(i);
+	}
+}
+
+void FSimpleHttpActionMultipleRequest::DispatchPendingRequests(int32 HostIndex)
+{
+	FHostQueue* HostQueue = &HostQueues[HostIndex];
+
+	while (HostQueue->NextPending < HostQueue->Pending.Num() &&
+		(Options.MaxConnectionsPerHost <= 0 || HostQueue->ActiveCount < Options.MaxConnectionsPerHost))
+	{
+		//Starts left for this frame go out from the next Tick
+		if (!Options.bInteractive && SimpleHTTP::FSimpleHttpFrameBudget::Get().IsExhausted())
 		{
-			AllRequestCompleteDelegate.ExecuteIfBound();
-			AllTasksCompletedDelegate.ExecuteIfBound();
+			bPausedByFrameBudget = true;
+			break;
+		}
+
+		//Over the memory budget the handle waits for bytes to be released, one transfer keeps it moving
+		if (ActiveHosts.Num() > 0 && SimpleHTTP::FSimpleHttpMemoryBudget::Get().IsExceeded())
+		{
+			if (!bPausedByMemoryBudget)
+			{
+				bPausedByMemoryBudget = true;
+				UE_LOG(LogSimpleHTTP, Log, TEXT("Multple request paused, %lld bytes buffered over the budget of %lld."),
+					SimpleHTTP::FSimpleHttpMemoryBudget::Get().GetBufferedBytes(),
+					SimpleHTTP::FSimpleHttpMemoryBudget::Get().GetBudgetBytes());
+			}
+			break;
+		}
 
-			bRequestComplete = true;
+		TSharedPtr<IHTTPClientRequest> Request = MoveTemp(HostQueue->Pending[HostQueue->NextPending++]);
+		SimpleHTTP::FSimpleHttpStats::Get().RequestDequeued();
 
-			UE_LOG(LogSimpleHTTP, Log, TEXT("The task has been completed."));
+		bool bStarted = false;
+		{
+			SimpleHTTP::FSimpleHttpFrameBudget::FScope FrameBudgetScope;
+			bStarted = FHTTPClient().Execute(Request.ToSharedRef());
 		}
 
-		UE_LOG(LogSimpleHTTP, Log, TEXT("ExecutionCompleteDelegate RequestNumber = %i"), RequestNumber);
+		if (bStarted)
+		{
+			HostQueue->ActiveCount++;
+			ActiveHosts.Add(Request->GetHttpRequest(), HostIndex);
+
+			UE_LOG(LogSimpleHTTP, Log, TEXT("Multple request started on [%s], %d active."), *HostQueue->Host, HostQueue->ActiveCount);
+		}
+		else
+		{
+			UE_LOG(LogSimpleHTTP, Error, TEXT("Multple request execution failed [%s]."), *Request->GetURL());
+
+			FailRequest(Request);
+
+			//Completion agents may have added hosts and moved the queues
+			HostQueue = &HostQueues[HostIndex];
+		}
+	}
+
+	if (HostQueue->NextPending >= HostQueue->Pending.Num())
+	{
+		HostQueue->Pending.Reset();
+		HostQueue->NextPending = 0;
+	}
+}
+
+void FSimpleHttpActionMultipleRequest::FailRequest(TSharedPtr<IHTTPClientRequest> Request)
+{
+	SimpleHTTP::Trace::EndSpan(Request->GetHttpRequest());
+	PakPartFinished(Request->GetURL(), false);
+
+	FSimpleHttpRequest SimpleHttpRequest;
+	SimpleHttpRequest.Verb = Request->GetVerb();
+	SimpleHttpRequest.URL = Request->GetURL();
+	SimpleHttpRequest.Status = ESimpleHttpStarte::Failed;
+
+	DeliverComplete(SimpleHttpRequest, nullptr, false);
+	ReleaseRequest(Request->GetHttpRequest());
+	OperationComplete();
+}
+
+void FSimpleHttpActionMultipleRequest::ExecuteBatches(const FString &Verb, const TArray<FString> &URL)
+{
+	TArray<TSharedPtr<IHTTPClientRequest>> FailedRequests;
+	TArray<int32> FailedBatches;
+
+	for (int32 BatchStart = 0; BatchStart < URL.Num(); BatchStart += Options.MaxBatchSize)
+	{
+		const int32 BatchIndex = Batches.Num();
+
+		FBatch &Batch = Batches.AddDefaulted_GetRef();
+		Batch.Verb = Verb;
+		Batch.URLs.Append(URL.GetData() + BatchStart, FMath::Min(Options.MaxBatchSize, URL.Num() - BatchStart));
+
+		FString BatchJson;
+		TSharedRef<TJsonWriter<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>> JsonWriter = TJsonWriterFactory<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>::Create(&BatchJson);
+		JsonWriter->WriteObjectStart();
+		JsonWriter->WriteArrayStart(TEXT("operations"));
+		for (int32 i = 0; i < Batch.URLs.Num(); ++i)
+		{
+			JsonWriter->WriteObjectStart();
+			JsonWriter->WriteValue(TEXT("id"), i);
+			JsonWriter->WriteValue(TEXT("method"), Verb);
+			JsonWriter->WriteValue(TEXT("url"), SimpleHTTP::SimpleURLEncode(*Batch.URLs[i]));
+			JsonWriter->WriteObjectEnd();
+		}
+		JsonWriter->WriteArrayEnd();
+		JsonWriter->WriteObjectEnd();
+		JsonWriter->Close();
+
+		FTCHARToUTF8 UTF8Converter(*BatchJson);
+		TSharedPtr<IHTTPClientRequest> Request = AddRequest(MakeShared<FBatchRequest>(Options.BatchEndpoint, TArray<uint8>((const uint8*)UTF8Converter.Get(), UTF8Converter.Length())));
+
+		//The headers of the envelope mean nothing to the per-URL agents, they get the headers of their own entry
+		(*Request)
+			<< FHttpRequestProgressDelegate::CreateRaw(this, &FSimpleHttpActionMultipleRequest::HttpRequestProgress)
+			<< FHttpRequestCompleteDelegate::CreateRaw(this, &FSimpleHttpActionMultipleRequest::HttpBatchRequestComplete, BatchIndex);
+
+		SimpleHTTP::Trace::RequestCreated(this, Request->GetHttpRequest());
+
+		RequestNumber += Batch.URLs.Num();
+
+		if (FHTTPClient().Execute(Request.ToSharedRef()))
+		{
+			UE_LOG(LogSimpleHTTP, Log, TEXT("Multple %s batch of %d operations by multple request."), *Verb, Batch.URLs.Num());
+		}
+		else
+		{
+			UE_LOG(LogSimpleHTTP, Error, TEXT("Multple %s batch request execution failed."), *Verb);
+
+			FailedRequests.Add(Request);
+			FailedBatches.Add(BatchIndex);
+		}
+	}
+
+	//Failed only once every batch is counted, the first one can not finish the handle while others still start
+	for (int32 i = 0; i < FailedBatches.Num(); ++i)
+	{
+		const FBatch Batch = MoveTemp(Batches[FailedBatches[i]]);
+
+		SimpleHTTP::Trace::EndSpan(FailedRequests[i]->GetHttpRequest());
+		ReleaseRequest(FailedRequests[i]->GetHttpRequest());
+
+		//Every operation of the batch reports on its own, as if the envelope had come back failed
+		for (const auto &Tmp : Batch.URLs)
+		{
+			FSimpleHttpRequest SimpleHttpRequest;
+			SimpleHttpRequest.Verb = Batch.Verb;
+			SimpleHttpRequest.URL = Tmp;
+			SimpleHttpRequest.Status = ESimpleHttpStarte::Failed;
+			DeliverComplete(SimpleHttpRequest, nullptr, false);
+			OperationComplete();
+		}
+	}
+}
+
+void FSimpleHttpActionMultipleRequest::HttpBatchRequestComplete(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bConnectedSuccessfully, int32 BatchIndex)
+{
+	LLM_SCOPE_BYTAG(SimpleHTTP);
+
+	FlushProgress(Request, Response, bConnectedSuccessfully);
+	ChargeBufferedBody(Request.Get(), Response.IsValid() ? Response->GetContent().Num() : 0);
+	SimpleHTTP::FSimpleHttpStats::Get().RequestFinished(Request, Response, bConnectedSuccessfully);
+	SimpleHTTP::Trace::EnterPhase(Request.Get(), SimpleHTTP::Trace::EPhase::PostProcess);
+
+	DeliverWithinFrameBudget([this, Request, Response, bConnectedSuccessfully, BatchIndex]()
+	{
+		CompleteBatchRequest(Request, Response, bConnectedSuccessfully, BatchIndex);
+	});
+}
+
+void FSimpleHttpActionMultipleRequest::CompleteBatchRequest(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bConnectedSuccessfully, int32 BatchIndex)
+{
+	const FBatch Batch = MoveTemp(Batches[BatchIndex]);
+
+	const bool bBatchSucceeded = bConnectedSuccessfully && Response.IsValid() && EHttpResponseCodes::IsOk(Response->GetResponseCode());
+
+	TMap<int32, TSharedPtr<FJsonObject>> SubResponses;
+	if (bBatchSucceeded)
+	{
+		TSharedPtr<FJsonObject> JsonObject = SimpleHTTP::DecodeJsonObject(Response->GetContent());
+		const TArray<TSharedPtr<FJsonValue>>* Entries = nullptr;
+		if (JsonObject.IsValid() && JsonObject->TryGetArrayField(TEXT("responses"), Entries))
+		{
+			for (const auto &Tmp : *Entries)
+			{
+				const TSharedPtr<FJsonObject>* Entry = nullptr;
+				int32 Id = INDEX_NONE;
+				if (Tmp->TryGetObject(Entry) && (*Entry)->TryGetNumberField(TEXT("id"), Id))
+				{
+					SubResponses.Add(Id, *Entry);
+				}
+			}
+		}
+		else
+		{
+			UE_LOG(LogSimpleHTTP, Warning, TEXT("Batch reply from [%s] has no responses array."), *Options.BatchEndpoint);
+		}
 	}
 	else
 	{
-		UE_LOG(LogSimpleHTTP, Error, TEXT("Request quantity error."));
+		UE_LOG(LogSimpleHTTP, Warning, TEXT("Batch request to [%s] failed, all %d operations fail with it."), *Options.BatchEndpoint, Batch.URLs.Num());
 	}
+
+	SimpleHTTP::Trace::EnterPhase(Request.Get(), SimpleHTTP::Trace::EPhase::Dispatch);
+
+	for (int32 i = 0; i < Batch.URLs.Num(); ++i)
+	{
+		FSimpleHttpRequest SimpleHttpRequest;
+		SimpleHttpRequest.Verb = Batch.Verb;
+		SimpleHttpRequest.URL = Batch.URLs[i];
+		SimpleHttpRequest.ElapsedTime = Request.IsValid() ? Request->GetElapsedTime() : 0.f;
+
+		//Without an entry of its own the operation reports the envelope
+		FHttpResponsePtr SubResponse = Response;
+		bool bSubConnected = bConnectedSuccessfully;
+
+		//An entry without a status says nothing about how the operation went
+		const TSharedPtr<FJsonObject>* Entry = SubResponses.Find(i);
+		int32 StatusCode = 0;
+		if (Entry && !(*Entry)->TryGetNumberField(TEXT("status"), StatusCode))
+		{
+			UE_LOG(LogSimpleHTTP, Warning, TEXT("Batch reply from [%s] has no status for [%s]."), *Options.BatchEndpoint, *SimpleHttpRequest.URL);
+			Entry = nullptr;
+		}
+
+		if (Entry)
+		{
+			TMap<FString, FString> Headers;
+			const TSharedPtr<FJsonObject>* HeaderObject = nullptr;
+			if ((*Entry)->TryGetObjectField(TEXT("headers"), HeaderObject))
+			{
+				for (const auto &Header : (*HeaderObject)->Values)
+				{
+					const FString &HeaderValue = Headers.Add(Header.Key, Header.Value->AsString());
+
+					//The headers of the operation stand in for the ones of the envelope
+					DeliverHeader(Header.Key, HeaderValue, [&SimpleHttpRequest](FSimpleHttpRequest &OutRequest)
+					{
+						OutRequest = SimpleHttpRequest;
+					});
+				}
+			}
+
+			TArray<uint8> Content;
+			FString Body;
+			if ((*Entry)->TryGetStringField(TEXT("bodyBase64"), Body))
+			{
+				FBase64::Decode(Body, Content);
+			}
+			else if ((*Entry)->TryGetStringField(TEXT("body"), Body))
+			{
+				FTCHARToUTF8 UTF8Converter(*Body);
+				Content.Append((const uint8*)UTF8Converter.Get(), UTF8Converter.Length());
+			}
+
+			SubResponse = MakeShared<FSimpleHttpSyntheticResponse, ESPMode::ThreadSafe>(SimpleHttpRequest.URL, StatusCode, MoveTemp(Headers), MoveTemp(Content));
+			SimpleHttpRequest.Status = ESimpleHttpStarte::Succeeded;
+		}
+		else
+		{
+			SimpleHttpRequest.Status = ESimpleHttpStarte::Failed;
+
+			//The batch went through but left this operation out, or gave it no status
+			if (bBatchSucceeded)
+			{
+				bSubConnected = false;
+			}
+		}
+
+		DeliverComplete(SimpleHttpRequest, SubResponse, bSubConnected);
+		OperationComplete();
+	}
+
+	SimpleHTTP::Trace::EndSpan(Request.Get(),
+		Response.IsValid() ? Response->GetResponseCode() : 0,
+		Response.IsValid() ? Response->GetContent().Num() : 0);
+
+	ReleaseRequest(Request.Get());
 }
 
 void FSimpleHttpActionMultipleRequest::HttpRequestComplete(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bConnectedSuccessfully)
 {
+	int32 HostIndex = INDEX_NONE;
+	if (ActiveHosts.RemoveAndCopyValue(Request.Get(), HostIndex))
+	{
+		HostQueues[HostIndex].ActiveCount--;
+	}
+
 	Super::HttpRequestComplete(Request, Response, bConnectedSuccessfully);
+
+	//The freed connection goes to the next request for the same host
+	if (HostIndex != INDEX_NONE)
+	{
+		DispatchPendingRequests(HostIndex);
+	}
+
+	//The freed pipeline slot goes to the next scanned file without waiting for Tick
+	if (UploadScan.IsValid())
+	{
+		PumpUploadScan();
+	}
 }
 
 void FSimpleHttpActionMultipleRequest::HttpRequestProgress(FHttpRequestPtr Request, int32 BytesSent, int32 BytesReceived)
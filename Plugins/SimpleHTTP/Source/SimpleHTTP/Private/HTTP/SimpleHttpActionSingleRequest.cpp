@@ -6,10 +6,20 @@
 #include "Misc/Paths.h"
 #include "Misc/FileHelper.h"
 #include "Math/UnrealMathUtility.h"
+#include "Core/SimpleHttpUploadSource.h"
+#include "Core/SimpleHttpPrefetchCache.h"
+#include "Core/SimpleHttpTarStream.h"
+#include "Core/SimpleHttpEventStream.h"
+#include "Core/SimpleHttpArchive.h"
+#include "Core/SimpleHttpMemoryBudget.h"
+#include "Core/SimpleHttpStats.h"
+#include "Async/Async.h"
 
 FSimpleHttpActionSingleRequest::FSimpleHttpActionSingleRequest()
 	:Super()
 	,Request(NULL)
+	,bWalkingDirectory(false)
+	,bCancelled(false)
 {
 }
 
@@ -22,15 +32,32 @@ bool FSimpleHttpActionSingleRequest::Cancel()
 {
 	if (Request.IsValid())
 	{
+		FailPendingPaks(TEXT("the download was cancelled"));
 		FHTTPClient().Cancel(Request.ToSharedRef());
 		return true;
 	}
 
+	//No request yet, SendDirectory completes the handle instead of starting one
+	if (bWalkingDirectory)
+	{
+		bCancelled = true;
+		return true;
+	}
+
 	return false;
 }
 
 void FSimpleHttpActionSingleRequest::HttpRequestComplete(FHttpRequestPtr InRequest, FHttpResponsePtr Response, bool bConnectedSuccessfully)
 {
+	//The server accepted a tar whose content no longer matches the directory
+	if (DirectoryStream.IsValid() && DirectoryStream->IsError() && InRequest.IsValid())
+	{
+		UE_LOG(LogSimpleHTTP, Error, TEXT("A file changed while [%s] was uploaded, the upload has failed."), *InRequest->GetURL());
+
+		FailedUploads.Add(InRequest.Get());
+		bConnectedSuccessfully = false;
+	}
+
 	Super::HttpRequestComplete(InRequest, Response, bConnectedSuccessfully);
 }
 
@@ -48,6 +75,19 @@ void FSimpleHttpActionSingleRequest::ExecutionCompleteDelegate(FHttpRequestPtr I
 {
 	Super::ExecutionCompleteDelegate(InRequest, Response, bConnectedSuccessfully);
 
+	OperationComplete();
+}
+
+void FSimpleHttpActionSingleRequest::OperationComplete()
+{
+	//Struct and pak mount agents fire before the handle reports completion
+	if (DeferUntilWorkersDone([this]() { OperationComplete(); }))
+	{
+		return;
+	}
+
+	FlushResultRecords();
+
 	//对于单个HTTP请求 就这样执行就行
 	AllRequestCompleteDelegate.ExecuteIfBound();
 	AllTasksCompletedDelegate.ExecuteIfBound();
@@ -59,6 +99,19 @@ bool FSimpleHttpActionSingleRequest::GetObject(const FString& URL)
 {
 	bSaveDisk = false;
 
+	//A prefetched body does not go to the network, the agents still fire after the caller has its handle
+	FHttpResponsePtr CachedResponse = SimpleHTTP::FSimpleHttpPrefetchCache::Get().Find(URL);
+	if (CachedResponse.IsValid())
+	{
+		DeliverOnNextTick([this, URL, CachedResponse]()
+		{
+			DeliverCachedResponse(URL, CachedResponse);
+			OperationComplete();
+		});
+
+		return true;
+	}
+
 	Request = MakeShareable(new FGetObjectRequest(URL));
 
 	REQUEST_BIND_FUN(FSimpleHttpActionSingleRequest)
@@ -69,6 +122,7 @@ bool FSimpleHttpActionSingleRequest::GetObject(const FString& URL)
 bool FSimpleHttpActionSingleRequest::GetObject(const FString& URL, const FString& SavePaths)
 {
 	TmpSavePaths = SavePaths;
+	ExpectPakParts({ URL });
 
 	Request = MakeShareable(new FGetObjectRequest(URL));
 
@@ -88,10 +142,11 @@ bool FSimpleHttpActionSingleRequest::PutObject(const FString& URL, const TArray<
 
 bool FSimpleHttpActionSingleRequest::PutObject(const FString& URL, const FString& LocalPaths)
 {
-	TArray<uint8> Data;
-	if (FFileHelper::LoadFileToArray(Data, *LocalPaths))
+	//The file is sent from a mapping, it is never loaded into the request
+	TSharedPtr<FArchive, ESPMode::ThreadSafe> Stream = SimpleHTTP::CreateMappedFileStream(LocalPaths);
+	if (Stream.IsValid())
 	{
-		Request = MakeShareable(new FPutObjectRequest(URL, Data));
+		Request = MakeShareable(new FPutObjectRequest(URL, Stream.ToSharedRef()));
 
 		REQUEST_BIND_FUN(FSimpleHttpActionSingleRequest)
 
@@ -125,13 +180,128 @@ bool FSimpleHttpActionSingleRequest::DeleteObject(const FString& URL)
 	return FHTTPClient().Execute(Request.ToSharedRef());
 }
 
-bool FSimpleHttpActionSingleRequest::PostObject(const FString& URL)
+bool FSimpleHttpActionSingleRequest::PostObject(const FString& URL, TArray<uint8>&& FormBody)
 {
-	//FString NewURL = FGenericPlatformHttp::UrlEncode(URL);
+	bSaveDisk = false;
 
+	Request = MakeShareable(new FPostObjectsRequest(URL, MoveTemp(FormBody)));
+
+	REQUEST_BIND_FUN(FSimpleHttpActionSingleRequest)
+
+	return FHTTPClient().Execute(Request.ToSharedRef());
+}
+
+bool FSimpleHttpActionSingleRequest::PostMultipartForm(const FString& URL, const SimpleHTTP::FSimpleHttpMultipartForm& Form)
+{
+	bSaveDisk = false;
+
+	Request = MakeShareable(new FMultipartFormRequest(URL, TEXT("POST"), Form));
+
+	REQUEST_BIND_FUN(FSimpleHttpActionSingleRequest)
+
+	return FHTTPClient().Execute(Request.ToSharedRef());
+}
+
+bool FSimpleHttpActionSingleRequest::GetStream(const FString& URL, bool bServerSentEvents)
+{
 	bSaveDisk = false;
 
-	Request = MakeShareable(new FPostObjectsRequest(URL));
+	EventStream = MakeShared<SimpleHTTP::FSimpleHttpEventStream, ESPMode::ThreadSafe>(bServerSentEvents, Options.StreamBufferBytes);
+
+	Request = MakeShareable(new FGetStreamRequest(URL, *EventStream, bServerSentEvents));
+
+	//Before 5.2 the events are handed over together once the response ends
+	if (!EventStream->IsAttached())
+	{
+		UE_LOG(LogSimpleHTTP, Warning, TEXT("This engine can not read a body while it arrives, [%s] is delivered when the response ends."), *URL);
+	}
+
+	REQUEST_BIND_FUN(FSimpleHttpActionSingleRequest)
+
+	if (!FHTTPClient().Execute(Request.ToSharedRef()))
+	{
+		return false;
+	}
+
+	SimpleHTTP::FSimpleHttpStats::Get().StreamOpened();
+	return true;
+}
+
+bool FSimpleHttpActionSingleRequest::PutDirectory(const FString& URL, const FString& LocalDirectory, bool bGzip)
+{
+	bSaveDisk = false;
+
+	if (!IFileManager::Get().DirectoryExists(*LocalDirectory))
+	{
+		UE_LOG(LogSimpleHTTP, Error, TEXT("Directory [%s] does not exist."), *LocalDirectory);
+		return false;
+	}
+
+	//Walking thousands of files and measuring the deflated size are kept off the game thread
+	bWalkingDirectory = true;
+	TSharedRef<FSimpleHttpActionSingleRequest> ActionRequest = StaticCastSharedRef<FSimpleHttpActionSingleRequest>(AsShared());
+	Async(EAsyncExecution::ThreadPool, [ActionRequest, URL, LocalDirectory, bGzip]()
+	{
+		LLM_SCOPE_BYTAG(SimpleHTTP);
+
+		TSharedPtr<FArchive, ESPMode::ThreadSafe> Stream = SimpleHTTP::CreateDirectoryTarStream(LocalDirectory, bGzip);
+
+		AsyncTask(ENamedThreads::GameThread, [ActionRequest, URL, Stream, bGzip]()
+		{
+			ActionRequest->SendDirectory(URL, Stream, bGzip);
+		});
+	});
+
+	return true;
+}
+
+void FSimpleHttpActionSingleRequest::SendDirectory(const FString& URL, TSharedPtr<FArchive, ESPMode::ThreadSafe> Stream, bool bGzip)
+{
+	bWalkingDirectory = false;
+
+	if (bCancelled)
+	{
+		UE_LOG(LogSimpleHTTP, Log, TEXT("[%s] was cancelled before the directory was sent."), *URL);
+	}
+	else if (Stream.IsValid())
+	{
+		DirectoryStream = Stream;
+		Request = MakeShareable(new FPutArchiveRequest(URL, Stream.ToSharedRef(), bGzip));
+
+		REQUEST_BIND_FUN(FSimpleHttpActionSingleRequest)
+
+		if (FHTTPClient().Execute(Request.ToSharedRef()))
+		{
+			return;
+		}
+	}
+
+	//Nothing was sent, the agents still hear that the operation failed
+	FSimpleHttpRequest SimpleHttpRequest;
+	SimpleHttpRequest.Verb = TEXT("PUT");
+	SimpleHttpRequest.URL = URL;
+	SimpleHttpRequest.Status = ESimpleHttpStarte::Failed;
+
+	DeliverComplete(SimpleHttpRequest, nullptr, false);
+	OperationComplete();
+}
+
+bool FSimpleHttpActionSingleRequest::GetArchive(const FString& URL, const FString& ExtractPaths)
+{
+	TmpSavePaths = ExtractPaths;
+	bExtractArchive = true;
+
+	//A hash covers the whole body, so a checked archive is held until it has arrived
+	if (!HasContentCheck(URL))
+	{
+		ArchiveExtractor = MakeShared<SimpleHTTP::Archive::FStreamExtractor, ESPMode::ThreadSafe>(ExtractPaths);
+	}
+
+	Request = MakeShareable(new FGetArchiveRequest(URL, ArchiveExtractor.Get()));
+	if (ArchiveExtractor.IsValid() && !ArchiveExtractor->IsAttached())
+	{
+		ArchiveExtractor.Reset();
+	}
 
 	REQUEST_BIND_FUN(FSimpleHttpActionSingleRequest)
 
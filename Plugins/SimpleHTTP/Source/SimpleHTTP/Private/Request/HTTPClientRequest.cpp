@@ -2,10 +2,13 @@
 #include "Core/SimpleHttpMacro.h"
 #include "SimpleHTTPLog.h"
 #include "Core/SimpleHTTPMethod.h"
+#include "Core/SimpleHttpFormBody.h"
+#include "Core/SimpleHttpEventStream.h"
+#include "Core/SimpleHttpArchive.h"
 
 SimpleHTTP::HTTP::FPutObjectRequest::FPutObjectRequest(const FString &URL, const FString& ContentString)
 {
-	DEFINITION_HTTP_TYPE(PUT,"multipart/form-data;charset=utf-8")
+	DEFINITION_HTTP_TYPE(PUT, "text/plain;charset=utf-8")
 	HttpReuest->SetContentAsString(ContentString);
 
 	UE_LOG(LogSimpleHTTP, Log, TEXT("PUT Action as string"));
@@ -13,7 +16,7 @@ SimpleHTTP::HTTP::FPutObjectRequest::FPutObjectRequest(const FString &URL, const
 
 SimpleHTTP::HTTP::FPutObjectRequest::FPutObjectRequest(const FString &URL, TSharedRef<FArchive, ESPMode::ThreadSafe> Stream)
 {
-	DEFINITION_HTTP_TYPE(PUT, "multipart/form-data;charset=utf-8")
+	DEFINITION_HTTP_TYPE(PUT, "application/octet-stream")
 	HttpReuest->SetContentFromStream(Stream);
 
 	UE_LOG(LogSimpleHTTP, Log, TEXT("PUT Action by stream."));
@@ -21,7 +24,7 @@ SimpleHTTP::HTTP::FPutObjectRequest::FPutObjectRequest(const FString &URL, TShar
 
 SimpleHTTP::HTTP::FPutObjectRequest::FPutObjectRequest(const FString &URL,const TArray<uint8>& ContentPayload)
 {
-	DEFINITION_HTTP_TYPE(PUT, "multipart/form-data;charset=utf-8")
+	DEFINITION_HTTP_TYPE(PUT, "application/octet-stream")
 	HttpReuest->SetContent(ContentPayload);
 
 	UE_LOG(LogSimpleHTTP, Log, TEXT("PUT Action by content."));
@@ -49,9 +52,75 @@ SimpleHTTP::HTTP::FDeleteObjectsRequest::FDeleteObjectsRequest(const FString &UR
 	UE_LOG(LogSimpleHTTP, Log, TEXT("DELETE Action."));
 }
 
-SimpleHTTP::HTTP::FPostObjectsRequest::FPostObjectsRequest(const FString &URL)
+SimpleHTTP::HTTP::FPostObjectsRequest::FPostObjectsRequest(const FString &URL, TArray<uint8> &&FormBody)
 {
 	DEFINITION_HTTP_TYPE(POST, "application/x-www-form-urlencoded;charset=utf-8")
+	HttpReuest->SetContent(MoveTemp(FormBody));
 
 	UE_LOG(LogSimpleHTTP, Log, TEXT("POST Action."));
+}
+
+SimpleHTTP::HTTP::FBatchRequest::FBatchRequest(const FString &URL, TArray<uint8> &&BatchBody)
+{
+	DEFINITION_HTTP_TYPE(POST, "application/json;charset=utf-8")
+	HttpReuest->SetContent(MoveTemp(BatchBody));
+
+	UE_LOG(LogSimpleHTTP, Log, TEXT("POST Action as batch."));
+}
+
+SimpleHTTP::HTTP::FMultipartFormRequest::FMultipartFormRequest(const FString &URL, const FString &Verb, const FSimpleHttpMultipartForm &Form)
+{
+	FString InNewURLEncoded = SimpleHTTP::SimpleURLEncode(*URL);
+	HttpReuest->SetURL(InNewURLEncoded);
+	HttpReuest->SetVerb(Verb);
+	HttpReuest->SetHeader(TEXT("Content-Type"), Form.GetContentType());
+
+	//File parts are read by the transport while it sends
+	HttpReuest->SetContentFromStream(Form.CreateStream());
+
+	UE_LOG(LogSimpleHTTP, Log, TEXT("%s Action as multipart form, %lld bytes."), *Verb, Form.GetTotalSize());
+}
+
+SimpleHTTP::HTTP::FPutArchiveRequest::FPutArchiveRequest(const FString &URL, TSharedRef<FArchive, ESPMode::ThreadSafe> Stream, bool bGzip)
+{
+	FString InNewURLEncoded = SimpleHTTP::SimpleURLEncode(*URL);
+	HttpReuest->SetURL(InNewURLEncoded);
+	HttpReuest->SetVerb(TEXT("PUT"));
+	HttpReuest->SetHeader(TEXT("Content-Type"), bGzip ? TEXT("application/gzip") : TEXT("application/x-tar"));
+
+	//Entries are read from disk by the transport while it sends
+	HttpReuest->SetContentFromStream(Stream);
+
+	UE_LOG(LogSimpleHTTP, Log, TEXT("PUT Action as archive, %lld bytes."), Stream->TotalSize());
+}
+
+SimpleHTTP::HTTP::FGetArchiveRequest::FGetArchiveRequest(const FString &URL, Archive::FStreamExtractor *Extractor)
+{
+	DEFINITION_HTTP_TYPE(GET, "application/x-www-form-urlencoded;charset=utf-8")
+
+	//Engines without a receive stream hold the whole archive until the response ends
+	if (Extractor && !Extractor->AttachTo(*HttpReuest))
+	{
+		UE_LOG(LogSimpleHTTP, Log, TEXT("This engine can not read a body while it arrives, [%s] is extracted when the response ends."), *URL);
+	}
+
+	UE_LOG(LogSimpleHTTP, Log, TEXT("GET Action as archive."));
+}
+
+SimpleHTTP::HTTP::FGetStreamRequest::FGetStreamRequest(const FString &URL, FSimpleHttpEventStream &EventStream, bool bServerSentEvents)
+{
+	FString InNewURLEncoded = SimpleHTTP::SimpleURLEncode(*URL);
+	HttpReuest->SetURL(InNewURLEncoded);
+	HttpReuest->SetVerb(TEXT("GET"));
+
+	if (bServerSentEvents)
+	{
+		HttpReuest->SetHeader(TEXT("Accept"), TEXT("text/event-stream"));
+		HttpReuest->SetHeader(TEXT("Cache-Control"), TEXT("no-cache"));
+	}
+
+	//Engines without a receive stream only hand the body over once the response ends, CompleteRequest parses it then
+	EventStream.AttachTo(*HttpReuest);
+
+	UE_LOG(LogSimpleHTTP, Log, TEXT("GET Action as stream."));
 }
\ No newline at end of file
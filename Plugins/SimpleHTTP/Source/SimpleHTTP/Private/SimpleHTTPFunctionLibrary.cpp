@@ -5,6 +5,7 @@
 #include "SimpleHttpManage.h"
 #include "HTTP/Core/SimpleHttpActionRequest.h"
 #include "HTTP/Core/SimpleHTTPHandle.h"
+#include "Core/SimpleHTTPMethod.h"
 
 void USimpleHTTPFunctionLibrary::Pause()
 {
@@ -36,6 +37,16 @@ bool USimpleHTTPFunctionLibrary::PostRequest(const FString &InURL, const FString
 	return SIMPLE_HTTP.PostRequest(*InURL,*InParam, BPResponseDelegate);
 }
 
+bool USimpleHTTPFunctionLibrary::PostForm(const FSimpleHttpBpResponseDelegate &BPResponseDelegate, const FString &URL, const TMap<FString, FString> &Fields)
+{
+	return SIMPLE_HTTP.PostForm(BPResponseDelegate, URL, Fields);
+}
+
+bool USimpleHTTPFunctionLibrary::PostMultipartForm(const FSimpleHttpBpResponseDelegate &BPResponseDelegate, const FString &URL, const TMap<FString, FString> &Fields, const TMap<FString, FString> &Files)
+{
+	return SIMPLE_HTTP.PostMultipartForm(BPResponseDelegate, URL, Fields, Files);
+}
+
 void USimpleHTTPFunctionLibrary::Tick(float DeltaTime)
 {
 	FSimpleHttpManage::Get()->Tick(DeltaTime);
@@ -51,6 +62,16 @@ bool USimpleHTTPFunctionLibrary::GetObjectToLocal(const FSimpleHttpBpResponseDel
 	return SIMPLE_HTTP.GetObjectToLocal(BPResponseDelegate, URL, SavePaths);
 }
 
+bool USimpleHTTPFunctionLibrary::GetArchiveToLocal(const FSimpleHttpBpResponseDelegate &BPResponseDelegate, const FString &URL, const FString &ExtractPaths)
+{
+	return SIMPLE_HTTP.GetArchiveToLocal(BPResponseDelegate, URL, ExtractPaths);
+}
+
+bool USimpleHTTPFunctionLibrary::GetStream(const FSimpleHttpBpResponseDelegate &BPResponseDelegate, const FString &URL, bool bServerSentEvents)
+{
+	return SIMPLE_HTTP.GetStream(BPResponseDelegate, URL, bServerSentEvents);
+}
+
 bool USimpleHTTPFunctionLibrary::PutObjectFromLocal(const FSimpleHttpBpResponseDelegate &BPResponseDelegate, const FString &URL, const FString &LocalPaths)
 {
 	return SIMPLE_HTTP.PutObjectFromLocal(BPResponseDelegate, URL, LocalPaths);
@@ -76,6 +97,11 @@ bool USimpleHTTPFunctionLibrary::PutObjectsFromLocal(const FSimpleHttpBpResponse
 	return SIMPLE_HTTP.PutObjectsFromLocal(BPResponseDelegate, URL,LocalPaths);
 }
 
+bool USimpleHTTPFunctionLibrary::PutDirectoryAsArchive(const FSimpleHttpBpResponseDelegate &BPResponseDelegate, const FString &URL, const FString &LocalDirectory, bool bGzip)
+{
+	return SIMPLE_HTTP.PutDirectoryAsArchive(BPResponseDelegate, URL, LocalDirectory, bGzip);
+}
+
 void USimpleHTTPFunctionLibrary::GetObjectsToLocal(const FSimpleHttpBpResponseDelegate &BPResponseDelegate, const TArray<FString> &URL, const FString &SavePaths)
 {
 	SIMPLE_HTTP.GetObjectsToLocal(BPResponseDelegate, URL, SavePaths);
@@ -90,3 +116,33 @@ void USimpleHTTPFunctionLibrary::DeleteObjects(const FSimpleHttpBpResponseDelega
 {
 	SIMPLE_HTTP.DeleteObjects(BPResponseDelegate, URL);
 }
+
+void USimpleHTTPFunctionLibrary::PrefetchObjects(const TArray<FString> &URL)
+{
+	SIMPLE_HTTP.PrefetchObjects(URL);
+}
+
+void USimpleHTTPFunctionLibrary::CancelPrefetch()
+{
+	SIMPLE_HTTP.CancelPrefetch();
+}
+
+void USimpleHTTPFunctionLibrary::PrewarmConnections(const TArray<FString> &URL)
+{
+	SIMPLE_HTTP.PrewarmConnections(URL);
+}
+
+FString USimpleHTTPFunctionLibrary::URLEncodeComponent(const FString &InString)
+{
+	return SimpleHTTP::SimpleURLEncodeComponent(*InString);
+}
+
+FString USimpleHTTPFunctionLibrary::URLDecode(const FString &InString, bool bPlusAsSpace)
+{
+	return SimpleHTTP::SimpleURLDecode(*InString, bPlusAsSpace);
+}
+
+FString USimpleHTTPFunctionLibrary::MakeURL(const FString &BaseURL, const TMap<FString, FString> &QueryParams)
+{
+	return SimpleHTTP::FSimpleURLBuilder(BaseURL).AddQuery(QueryParams).ToString();
+}
@@ -3,10 +3,16 @@
 #include "HTTP/SimpleHttpActionMultipleRequest.h"
 #include "HTTP/SimpleHttpActionSingleRequest.h"
 #include "Core/SimpleHttpMacro.h"
+#include "Core/SimpleHttpFormBody.h"
+#include "Core/SimpleHttpUploadSource.h"
 #include "Misc/FileHelper.h"
 #include "SimpleHTTPLog.h"
 #include "HttpModule.h"
 #include "HttpManager.h"
+#include "Core/SimpleHttpStats.h"
+#include "Core/SimpleHttpTrace.h"
+#include "Core/SimpleHttpPrefetchCache.h"
+#include "Core/SimpleHttpConnectionWarmer.h"
 
 #if PLATFORM_WINDOWS
 #pragma optimize("",off) 
@@ -38,12 +44,25 @@ TSharedPtr<FSimpleHttpActionRequest> GetHttpActionRequest(EHTTPRequestType Reque
 
 void FSimpleHttpManage::Tick(float DeltaTime)
 {
+	LLM_SCOPE_BYTAG(SimpleHTTP);
 	FScopeLock ScopeLock(&Instance->Mutex);
 
 	if (!HTTP.bPause)
 	{
 		FHttpModule::Get().GetHttpManager().Tick(DeltaTime);
 	}
+
+	//Agents fired from a request tick may register new requests
+	TArray<TSharedPtr<FSimpleHttpActionRequest>> TickRequests;
+	HTTP.HTTPMap.GenerateValueArray(TickRequests);
+	for (auto &Tmp : TickRequests)
+	{
+		Tmp->Tick(DeltaTime);
+	}
+
+	//After the requests, so traffic they just started keeps the prefetches waiting
+	SimpleHTTP::FSimpleHttpPrefetchCache::Get().Tick();
+	SimpleHTTP::FSimpleHttpConnectionWarmer::Get().Tick();
 	
 	TArray<FName> RemoveRequest;
 	for (auto &Tmp : HTTP.HTTPMap)
@@ -56,6 +75,11 @@ void FSimpleHttpManage::Tick(float DeltaTime)
 
 	for (auto &Tmp : RemoveRequest)
 	{
+		if (TSharedPtr<FSimpleHttpActionRequest> *HttpObject = GetHTTP().HTTPMap.Find(Tmp))
+		{
+			SimpleHTTP::Trace::EndSpan(HttpObject->Get());
+		}
+
 		GetHTTP().HTTPMap.Remove(Tmp);
 
 		UE_LOG(LogSimpleHTTP, Log, TEXT("Remove request %s from tick"), *Tmp.ToString());
@@ -69,7 +93,7 @@ bool FSimpleHttpManage::IsTickableInEditor() const
 
 TStatId FSimpleHttpManage::GetStatId() const
 {
-	return TStatId();
+	RETURN_QUICK_DECLARE_CYCLE_STAT(FSimpleHttpManage, STATGROUP_SimpleHTTP);
 }
 
 FSimpleHttpManage * FSimpleHttpManage::Get()
@@ -89,6 +113,8 @@ void FSimpleHttpManage::Destroy()
 	if (Instance != nullptr)
 	{
 		FScopeLock ScopeLock(&Instance->Mutex);
+		SimpleHTTP::FSimpleHttpPrefetchCache::Get().CancelPrefetch();
+		SimpleHTTP::FSimpleHttpConnectionWarmer::Get().Cancel();
 		delete Instance;		
 
 		UE_LOG(LogSimpleHTTP, Log, TEXT("delete HTTP management"));
@@ -97,12 +123,7 @@ void FSimpleHttpManage::Destroy()
 	Instance = nullptr;
 }
 
-FSimpleHTTPHandle FSimpleHttpManage::FHTTP::RegisteredHttpRequest(
-	EHTTPRequestType RequestType ,
-	FSimpleHttpSingleRequestCompleteDelegate SimpleHttpRequestCompleteDelegate /*= FSimpleHttpRequestCompleteDelegate()*/,
-	FSimpleHttpSingleRequestProgressDelegate SimpleHttpRequestProgressDelegate /*= FSimpleHttpRequestProgressDelegate()*/, 
-	FSimpleHttpSingleRequestHeaderReceivedDelegate SimpleHttpRequestHeaderReceivedDelegate /*= FSimpleHttpRequestHeaderReceivedDelegate()*/,
-	FAllRequestCompleteDelegate AllRequestCompleteDelegate /*= FAllRequestCompleteDelegate()*/)
+FSimpleHTTPHandle FSimpleHttpManage::FHTTP::RegisteredHttpRequest(EHTTPRequestType RequestType, const FSimpleHttpBpResponseDelegate &BPResponseDelegate)
 {
 	FScopeLock ScopeLock(&Instance->Mutex);
 
@@ -110,23 +131,27 @@ FSimpleHTTPHandle FSimpleHttpManage::FHTTP::RegisteredHttpRequest(
 
 	TSharedPtr<FSimpleHttpActionRequest> HttpObject = GetHttpActionRequest(RequestType);
 	
-	HttpObject->SimpleHttpRequestCompleteDelegate = SimpleHttpRequestCompleteDelegate;
-	HttpObject->SimpleHttpRequestHeaderReceivedDelegate = SimpleHttpRequestHeaderReceivedDelegate;
-	HttpObject->SimpleHttpRequestProgressDelegate = SimpleHttpRequestProgressDelegate;
-	HttpObject->AllRequestCompleteDelegate = AllRequestCompleteDelegate;
+	HttpObject->SimpleHttpRequestCompleteDelegate = BPResponseDelegate.SimpleHttpRequestCompleteDelegate;
+	HttpObject->SimpleHttpRequestHeaderReceivedDelegate = BPResponseDelegate.SimpleHttpRequestHeaderReceivedDelegate;
+	HttpObject->SimpleHttpRequestProgressDelegate = BPResponseDelegate.SimpleHttpRequestProgressDelegate;
+	HttpObject->AllRequestCompleteDelegate = BPResponseDelegate.AllRequestCompleteDelegate;
+	HttpObject->SimpleHttpProgressEventDelegate = BPResponseDelegate.SimpleHttpProgressEventDelegate;
+	HttpObject->SimpleHttpHeaderEventDelegate = BPResponseDelegate.SimpleHttpHeaderEventDelegate;
+	HttpObject->SimpleHttpResultBatchDelegate = BPResponseDelegate.SimpleHttpResultBatchDelegate;
+	HttpObject->SimpleHttpPakMountDelegate = BPResponseDelegate.SimpleHttpPakMountDelegate;
+	HttpObject->SimpleHttpStreamEventDelegate = BPResponseDelegate.SimpleHttpStreamEventDelegate;
+	HttpObject->SetOptions(BPResponseDelegate.RequestOptions);
 
 	FSimpleHTTPHandle Key = *FGuid::NewGuid().ToString();
+	HttpObject->SetHandle(Key);
 	HTTPMap.Add(Key,HttpObject);
 
+	SimpleHTTP::Trace::BeginSpan(HttpObject.Get(), SimpleHTTP::Trace::EPhase::Registration, TEXT("Handle"), Key.ToString());
+
 	return Key;
 }
 
-FSimpleHTTPHandle FSimpleHttpManage::FHTTP::RegisteredHttpRequest(
-	EHTTPRequestType RequestType /*= EHTTPRequestType::SINGLE*/, 
-	FSimpleSingleCompleteDelegate SimpleHttpRequestCompleteDelegate /*= nullptr*/, 
-	FSimpleSingleRequestProgressDelegate SimpleHttpRequestProgressDelegate /*= nullptr*/,
-	FSimpleSingleRequestHeaderReceivedDelegate SimpleHttpRequestHeaderReceivedDelegate /*= nullptr*/,
-	FSimpleDelegate AllRequestCompleteDelegate /*= nullptr*/)
+FSimpleHTTPHandle FSimpleHttpManage::FHTTP::RegisteredHttpRequest(EHTTPRequestType RequestType, const FSimpleHttpResponseDelegate &BPResponseDelegate)
 {
 	FScopeLock ScopeLock(&Instance->Mutex);
 
@@ -134,14 +159,25 @@ FSimpleHTTPHandle FSimpleHttpManage::FHTTP::RegisteredHttpRequest(
 
 	TSharedPtr<FSimpleHttpActionRequest> HttpObject = GetHttpActionRequest(RequestType);
 
-	HttpObject->SimpleCompleteDelegate = SimpleHttpRequestCompleteDelegate;
-	HttpObject->SimpleSingleRequestHeaderReceivedDelegate = SimpleHttpRequestHeaderReceivedDelegate;
-	HttpObject->SimpleSingleRequestProgressDelegate = SimpleHttpRequestProgressDelegate;
-	HttpObject->AllTasksCompletedDelegate = AllRequestCompleteDelegate;
+	HttpObject->SimpleCompleteDelegate = BPResponseDelegate.SimpleCompleteDelegate;
+	HttpObject->SimpleCompleteViewDelegate = BPResponseDelegate.SimpleCompleteViewDelegate;
+	HttpObject->SimpleCompleteStructDelegate = BPResponseDelegate.SimpleCompleteStructDelegate;
+	HttpObject->SimpleSingleRequestHeaderReceivedDelegate = BPResponseDelegate.SimpleSingleRequestHeaderReceivedDelegate;
+	HttpObject->SimpleSingleRequestProgressDelegate = BPResponseDelegate.SimpleSingleRequestProgressDelegate;
+	HttpObject->AllTasksCompletedDelegate = BPResponseDelegate.AllTasksCompletedDelegate;
+	HttpObject->SimpleProgressEventDelegate = BPResponseDelegate.SimpleProgressEventDelegate;
+	HttpObject->SimpleHeaderEventDelegate = BPResponseDelegate.SimpleHeaderEventDelegate;
+	HttpObject->SimpleResultBatchDelegate = BPResponseDelegate.SimpleResultBatchDelegate;
+	HttpObject->SimplePakMountDelegate = BPResponseDelegate.SimplePakMountDelegate;
+	HttpObject->SimpleStreamEventDelegate = BPResponseDelegate.SimpleStreamEventDelegate;
+	HttpObject->SetOptions(BPResponseDelegate.RequestOptions);
 
 	FSimpleHTTPHandle Key = *FGuid::NewGuid().ToString();
+	HttpObject->SetHandle(Key);
 	HTTPMap.Add(Key, HttpObject);
 
+	SimpleHTTP::Trace::BeginSpan(HttpObject.Get(), SimpleHTTP::Trace::EPhase::Registration, TEXT("Handle"), Key.ToString());
+
 	return Key;
 }
 
@@ -249,6 +285,93 @@ bool FSimpleHttpManage::FHTTP::GetObjectToLocal(const FSimpleHttpBpResponseDeleg
 	return GetObjectToLocal(Handle, URL, SavePaths);
 }
 
+bool FSimpleHttpManage::FHTTP::PutDirectoryAsArchive(const FSimpleHTTPHandle &Handle, const FString &URL, const FString &LocalDirectory, bool bGzip)
+{
+	TWeakPtr<FSimpleHttpActionRequest> Object = Find(Handle);
+	if (Object.IsValid())
+	{
+		return Object.Pin()->PutDirectory(URL, LocalDirectory, bGzip);
+	}
+	else
+	{
+		UE_LOG(LogSimpleHTTP, Warning, TEXT("The handle was not found [%s]"), *(Handle.ToString()));
+	}
+
+	return false;
+}
+
+bool FSimpleHttpManage::FHTTP::PutDirectoryAsArchive(const FSimpleHttpResponseDelegate &BPResponseDelegate, const FString &URL, const FString &LocalDirectory, bool bGzip)
+{
+	SIMPLE_HTTP_REGISTERED_REQUEST(EHTTPRequestType::SINGLE);
+
+	return PutDirectoryAsArchive(Handle, URL, LocalDirectory, bGzip);
+}
+
+bool FSimpleHttpManage::FHTTP::PutDirectoryAsArchive(const FSimpleHttpBpResponseDelegate &BPResponseDelegate, const FString &URL, const FString &LocalDirectory, bool bGzip)
+{
+	SIMPLE_HTTP_REGISTERED_REQUEST_BP(EHTTPRequestType::SINGLE);
+
+	return PutDirectoryAsArchive(Handle, URL, LocalDirectory, bGzip);
+}
+
+bool FSimpleHttpManage::FHTTP::GetStream(const FSimpleHTTPHandle &Handle, const FString &URL, bool bServerSentEvents)
+{
+	TWeakPtr<FSimpleHttpActionRequest> Object = Find(Handle);
+	if (Object.IsValid())
+	{
+		return Object.Pin()->GetStream(URL, bServerSentEvents);
+	}
+	else
+	{
+		UE_LOG(LogSimpleHTTP, Warning, TEXT("The handle was not found [%s]"), *(Handle.ToString()));
+	}
+
+	return false;
+}
+
+bool FSimpleHttpManage::FHTTP::GetStream(const FSimpleHttpResponseDelegate &BPResponseDelegate, const FString &URL, bool bServerSentEvents)
+{
+	SIMPLE_HTTP_REGISTERED_REQUEST(EHTTPRequestType::SINGLE);
+
+	return GetStream(Handle, URL, bServerSentEvents);
+}
+
+bool FSimpleHttpManage::FHTTP::GetStream(const FSimpleHttpBpResponseDelegate &BPResponseDelegate, const FString &URL, bool bServerSentEvents)
+{
+	SIMPLE_HTTP_REGISTERED_REQUEST_BP(EHTTPRequestType::SINGLE);
+
+	return GetStream(Handle, URL, bServerSentEvents);
+}
+
+bool FSimpleHttpManage::FHTTP::GetArchiveToLocal(const FSimpleHTTPHandle &Handle, const FString &URL, const FString &ExtractPaths)
+{
+	TWeakPtr<FSimpleHttpActionRequest> Object = Find(Handle);
+	if (Object.IsValid())
+	{
+		return Object.Pin()->GetArchive(URL, ExtractPaths);
+	}
+	else
+	{
+		UE_LOG(LogSimpleHTTP, Warning, TEXT("The handle was not found [%s]"), *(Handle.ToString()));
+	}
+
+	return false;
+}
+
+bool FSimpleHttpManage::FHTTP::GetArchiveToLocal(const FSimpleHttpResponseDelegate &BPResponseDelegate, const FString &URL, const FString &ExtractPaths)
+{
+	SIMPLE_HTTP_REGISTERED_REQUEST(EHTTPRequestType::SINGLE);
+
+	return GetArchiveToLocal(Handle, URL, ExtractPaths);
+}
+
+bool FSimpleHttpManage::FHTTP::GetArchiveToLocal(const FSimpleHttpBpResponseDelegate &BPResponseDelegate, const FString &URL, const FString &ExtractPaths)
+{
+	SIMPLE_HTTP_REGISTERED_REQUEST_BP(EHTTPRequestType::SINGLE);
+
+	return GetArchiveToLocal(Handle, URL, ExtractPaths);
+}
+
 void FSimpleHttpManage::FHTTP::GetObjectsToLocal(const FSimpleHTTPHandle &Handle, const TArray<FString> &URL, const FString &SavePaths)
 {
 	TWeakPtr<FSimpleHttpActionRequest> Object = Find(Handle);
@@ -363,6 +486,13 @@ bool FSimpleHttpManage::FHTTP::PutObjectFromStream(const FSimpleHttpResponseDele
 	return PutObjectFromStream(Handle, URL, Stream);
 }
 
+bool FSimpleHttpManage::FHTTP::PutObjectFromSharedBuffer(const FSimpleHttpResponseDelegate &BPResponseDelegate, const FString &URL, TSharedRef<const TArray<uint8>, ESPMode::ThreadSafe> Buffer)
+{
+	SIMPLE_HTTP_REGISTERED_REQUEST(EHTTPRequestType::SINGLE);
+
+	return PutObjectFromStream(Handle, URL, SimpleHTTP::CreateSharedBufferStream(Buffer));
+}
+
 bool FSimpleHttpManage::FHTTP::PutObjectFromLocal(const FSimpleHTTPHandle &Handle, const FString &URL, const FString &LocalPaths)
 {
 	TWeakPtr<FSimpleHttpActionRequest> Object = Find(Handle);
@@ -467,44 +597,189 @@ void FSimpleHttpManage::FHTTP::DeleteObjects(const FSimpleHttpResponseDelegate &
 	DeleteObjects(Handle, URL);
 }
 
+void FSimpleHttpManage::FHTTP::PrefetchObjects(const TArray<FString> &URL)
+{
+	LLM_SCOPE_BYTAG(SimpleHTTP);
+
+	SimpleHTTP::FSimpleHttpPrefetchCache::Get().Prefetch(URL);
+}
+
+void FSimpleHttpManage::FHTTP::CancelPrefetch()
+{
+	SimpleHTTP::FSimpleHttpPrefetchCache::Get().CancelPrefetch();
+}
+
+void FSimpleHttpManage::FHTTP::PrewarmConnections(const TArray<FString> &URL)
+{
+	SimpleHTTP::FSimpleHttpConnectionWarmer::Get().Prewarm(URL);
+}
+
+namespace SimpleHTTP
+{
+	TArray<uint8> StringToUTF8Body(const TCHAR *InString)
+	{
+		FTCHARToUTF8 UTF8Converter(InString);
+		return TArray<uint8>((const uint8*)UTF8Converter.Get(), UTF8Converter.Length());
+	}
+
+	bool BuildMultipartForm(const TMap<FString, FString> &Fields, const TMap<FString, FString> &Files, FSimpleHttpMultipartForm &OutForm)
+	{
+		for (auto &Tmp : Fields)
+		{
+			OutForm.AddField(Tmp.Key, Tmp.Value);
+		}
+
+		for (auto &Tmp : Files)
+		{
+			if (!OutForm.AddFile(Tmp.Key, Tmp.Value))
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+}
+
 bool FSimpleHttpManage::FHTTP::PostRequest(const TCHAR *InURL, const TCHAR *InParam, const FSimpleHttpBpResponseDelegate &BPResponseDelegate)
 {
 	SIMPLE_HTTP_REGISTERED_REQUEST_BP(EHTTPRequestType::SINGLE);
 
-	return PostRequest(Handle,InURL + FString(TEXT("?")) + InParam);
+	return PostRequest(Handle, InURL, SimpleHTTP::StringToUTF8Body(InParam));
 }
 
-bool FSimpleHttpManage::FHTTP::PostRequest(const FSimpleHTTPHandle &Handle, const FString &URL)
+bool FSimpleHttpManage::FHTTP::PostRequest(const FSimpleHTTPHandle &Handle, const FString &URL, TArray<uint8> &&FormBody)
 {
 	TWeakPtr<FSimpleHttpActionRequest> Object = Find(Handle);
-
 	if (Object.IsValid())
 	{
-		Object.Pin()->PostObject(URL);
+		return Object.Pin()->PostObject(URL, MoveTemp(FormBody));
+	}
+	else
+	{
+		UE_LOG(LogSimpleHTTP, Warning, TEXT("The handle was not found [%s]"), *(Handle.ToString()));
+	}
 
-		return true;
+	return false;
+}
+
+bool FSimpleHttpManage::FHTTP::PostRequest(const TCHAR *InURL, const TCHAR *InParam, const FSimpleHttpResponseDelegate &BPResponseDelegate)
+{
+	SIMPLE_HTTP_REGISTERED_REQUEST(EHTTPRequestType::SINGLE);
+
+	return PostRequest(Handle, InURL, SimpleHTTP::StringToUTF8Body(InParam));
+}
+
+bool FSimpleHttpManage::FHTTP::PostForm(const FSimpleHttpBpResponseDelegate &BPResponseDelegate, const FString &URL, const TMap<FString, FString> &Fields)
+{
+	SIMPLE_HTTP_REGISTERED_REQUEST_BP(EHTTPRequestType::SINGLE);
+
+	return PostRequest(Handle, URL, SimpleHTTP::BuildFormURLEncodedBody(Fields));
+}
+
+bool FSimpleHttpManage::FHTTP::PostForm(const FSimpleHttpResponseDelegate &BPResponseDelegate, const FString &URL, const TMap<FString, FString> &Fields)
+{
+	SIMPLE_HTTP_REGISTERED_REQUEST(EHTTPRequestType::SINGLE);
+
+	return PostRequest(Handle, URL, SimpleHTTP::BuildFormURLEncodedBody(Fields));
+}
+
+bool FSimpleHttpManage::FHTTP::PostMultipartForm(const FSimpleHTTPHandle &Handle, const FString &URL, const SimpleHTTP::FSimpleHttpMultipartForm &Form)
+{
+	TWeakPtr<FSimpleHttpActionRequest> Object = Find(Handle);
+	if (Object.IsValid())
+	{
+		return Object.Pin()->PostMultipartForm(URL, Form);
 	}
 	else
 	{
 		UE_LOG(LogSimpleHTTP, Warning, TEXT("The handle was not found [%s]"), *(Handle.ToString()));
+	}
+
+	return false;
+}
+
+bool FSimpleHttpManage::FHTTP::PostMultipartForm(const FSimpleHttpBpResponseDelegate &BPResponseDelegate, const FString &URL, const TMap<FString, FString> &Fields, const TMap<FString, FString> &Files)
+{
+	//A missing file fails here, before a handle is registered that would never complete
+	SimpleHTTP::FSimpleHttpMultipartForm Form;
+	if (!SimpleHTTP::BuildMultipartForm(Fields, Files, Form))
+	{
 		return false;
 	}
+
+	SIMPLE_HTTP_REGISTERED_REQUEST_BP(EHTTPRequestType::SINGLE);
+
+	return PostMultipartForm(Handle, URL, Form);
 }
 
-bool FSimpleHttpManage::FHTTP::PostRequest(const TCHAR *InURL, const TCHAR *InParam, const FSimpleHttpResponseDelegate &BPResponseDelegate)
+bool FSimpleHttpManage::FHTTP::PostMultipartForm(const FSimpleHttpResponseDelegate &BPResponseDelegate, const FString &URL, const SimpleHTTP::FSimpleHttpMultipartForm &Form)
 {
 	SIMPLE_HTTP_REGISTERED_REQUEST(EHTTPRequestType::SINGLE);
 
-	return PostRequest(Handle, InURL + FString(TEXT("?")) + InParam);
+	return PostMultipartForm(Handle, URL, Form);
+}
+
+bool FSimpleHttpManage::FHTTP::GetObjectToStruct(const FSimpleHTTPHandle &Handle, const FString &URL, const UScriptStruct *Struct)
+{
+	TWeakPtr<FSimpleHttpActionRequest> Object = Find(Handle);
+	if (Object.IsValid())
+	{
+		Object.Pin()->SetDecodeStruct(Struct);
+		return Object.Pin()->GetObject(URL);
+	}
+	else
+	{
+		UE_LOG(LogSimpleHTTP, Warning, TEXT("The handle was not found [%s]"), *(Handle.ToString()));
+	}
+
+	return false;
 }
 
-TArray<uint8> & USimpleHttpContent::GetContent()
+bool FSimpleHttpManage::FHTTP::GetObjectToStruct(const FSimpleHttpResponseDelegate &BPResponseDelegate, const FString &URL, const UScriptStruct *Struct)
 {
-	return *Content;
+	SIMPLE_HTTP_REGISTERED_REQUEST(EHTTPRequestType::SINGLE);
+
+	return GetObjectToStruct(Handle, URL, Struct);
+}
+
+bool FSimpleHttpManage::FHTTP::PostFormToStruct(const FSimpleHTTPHandle &Handle, const FString &URL, TArray<uint8> &&FormBody, const UScriptStruct *Struct)
+{
+	TWeakPtr<FSimpleHttpActionRequest> Object = Find(Handle);
+	if (Object.IsValid())
+	{
+		Object.Pin()->SetDecodeStruct(Struct);
+		return Object.Pin()->PostObject(URL, MoveTemp(FormBody));
+	}
+	else
+	{
+		UE_LOG(LogSimpleHTTP, Warning, TEXT("The handle was not found [%s]"), *(Handle.ToString()));
+	}
+
+	return false;
+}
+
+bool FSimpleHttpManage::FHTTP::PostFormToStruct(const FSimpleHttpResponseDelegate &BPResponseDelegate, const FString &URL, const TMap<FString, FString> &Fields, const UScriptStruct *Struct)
+{
+	SIMPLE_HTTP_REGISTERED_REQUEST(EHTTPRequestType::SINGLE);
+
+	return PostFormToStruct(Handle, URL, SimpleHTTP::BuildFormURLEncodedBody(Fields), Struct);
+}
+
+const TArray<uint8> & USimpleHttpContent::GetContent() const
+{
+	static const TArray<uint8> EmptyContent;
+
+	return Content.IsValid() ? *Content : EmptyContent;
 }
 
 bool USimpleHttpContent::Save(const FString &LocalPath)
 {
+	if (!Content.IsValid())
+	{
+		return false;
+	}
+
 	return FFileHelper::SaveArrayToFile(*Content, *LocalPath);
 }
 
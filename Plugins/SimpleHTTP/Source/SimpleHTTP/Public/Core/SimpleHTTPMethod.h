@@ -6,6 +6,59 @@
 
 namespace SimpleHTTP
 {
+	enum class ESimpleURLEncoding : uint8
+	{
+		//Whole URL. Keeps the URL delimiters and any escape that is already valid.
+		URL,
+		//Single path segment, query key or query value. Only A-Z a-z 0-9 - _ . ~ are kept.
+		Component,
+		//application/x-www-form-urlencoded. Same as Component, but a space becomes '+'.
+		Form,
+	};
+
 	//如果里面包含中文字符，会进行特殊处理，防止字符因为特殊导致HTTP错误
-	FString SimpleURLEncode(const TCHAR* InUnencodedString);
-}
\ No newline at end of file
+	SIMPLEHTTP_API FString SimpleURLEncode(const TCHAR* InUnencodedString);
+
+	//Escapes a single query key or value, path segment or form field
+	SIMPLEHTTP_API FString SimpleURLEncodeComponent(const TCHAR* InUnencodedString);
+
+	//Reverses the escapes, the decoded bytes are read as UTF-8
+	SIMPLEHTTP_API FString SimpleURLDecode(const TCHAR* InEncodedString, bool bPlusAsSpace = false);
+
+	/**
+	 * Low level encoder used by the functions above and by the body builders.
+	 * GetURLEncodedLength returns exactly the number of characters URLEncodeTo writes,
+	 * so a caller can size its buffer once.
+	 */
+	SIMPLEHTTP_API int32 GetURLEncodedLength(const UTF8CHAR* InBytes, int32 InNum, ESimpleURLEncoding Encoding);
+	SIMPLEHTTP_API int32 URLEncodeTo(const UTF8CHAR* InBytes, int32 InNum, ESimpleURLEncoding Encoding, TCHAR* OutChars);
+	SIMPLEHTTP_API int32 URLEncodeTo(const UTF8CHAR* InBytes, int32 InNum, ESimpleURLEncoding Encoding, ANSICHAR* OutChars);
+
+	/**
+	 * Builds a URL from a base address, path segments and query parameters.
+	 * Segments, keys and values are escaped as components, so the result can be
+	 * handed to any request as is.
+	 */
+	struct SIMPLEHTTP_API FSimpleURLBuilder
+	{
+		explicit FSimpleURLBuilder(const FString &InBaseURL);
+
+		FSimpleURLBuilder &AddPath(const FString &Segment);
+		FSimpleURLBuilder &AddQuery(const FString &Key, const FString &Value);
+		FSimpleURLBuilder &AddQuery(const TMap<FString, FString> &Params);
+
+		FString ToString() const;
+
+		//Only the "k=v&k2=v2" part
+		FString ToQueryString() const;
+
+	private:
+		void AppendQueryString(FString &OutString) const;
+		int32 GetRawQueryLength() const;
+
+	private:
+		FString BaseURL;
+		TArray<FString> PathSegments;
+		TArray<TPair<FString, FString>> QueryParams;
+	};
+}
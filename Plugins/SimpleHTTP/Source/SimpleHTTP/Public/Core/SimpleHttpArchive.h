@@ -0,0 +1,86 @@
+// Copyright (C) RenZhai.2020.All Rights Reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Interfaces/IHttpRequest.h"
+
+namespace SimpleHTTP
+{
+	/**
+	 * Extraction of downloaded archives, the archive itself is never written.
+	 * zip (stored or deflated, no zip64 or encryption), tar and gzipped tar are told apart by their magic.
+	 * Entries go to a staging directory beside the target and are moved into the target only once the
+	 * whole archive has extracted, so a failed or cancelled download leaves the target as it was.
+	 * Entries that would land outside the target directory fail the whole archive.
+	 */
+	namespace Archive
+	{
+		class FStaging;
+		class FTarReader;
+		class FInflater;
+
+		/**
+		 * Extracts an archive handed over in pieces, in order and from one thread at a time.
+		 * tar and gzipped tar are written out as they arrive, with a fixed amount of memory. A zip keeps
+		 * its directory at the end, so its bytes are gathered and it is extracted by Finish.
+		 */
+		class SIMPLEHTTP_API FStreamExtractor : public TSharedFromThis<FStreamExtractor, ESPMode::ThreadSafe>
+		{
+		public:
+			FStreamExtractor(const FString &InTargetDir);
+
+			/*Removes the staging directory unless Finish has moved it into place*/
+			~FStreamExtractor();
+
+			/*Has the transport write the body into this extractor as it arrives. False where the engine can only hand it over at the end.*/
+			bool AttachTo(IHttpRequest &Request);
+			FORCEINLINE bool IsAttached() const { return bAttached; }
+
+			/*False once the archive has failed, what follows is ignored*/
+			bool Append(const uint8 *Data, int64 Num);
+
+			/*Checks that the archive is complete and moves what it extracted into the target. Blocks, run it on a worker.*/
+			bool Finish(int32 &OutEntries, FString &OutError);
+
+			FORCEINLINE int64 GetReceivedBytes() const { return ReceivedBytes; }
+
+			/*Why Append started returning false, from the thread that appends*/
+			FORCEINLINE const FString& GetError() const { return Error; }
+
+		private:
+			enum class EFormat : uint8
+			{
+				Unknown,
+				Zip,
+				Tar,
+				Gzip,
+			};
+
+			/*Picks the format once enough of the body is in Buffered, bFinal when no more is coming*/
+			void DetectFormat(bool bFinal);
+
+			/*Hands bytes to the tar reader, through the inflater for gzip*/
+			bool Feed(const uint8 *Data, int64 Num);
+
+		private:
+			TUniquePtr<FStaging> Staging;
+			TUniquePtr<FTarReader> Tar;
+			TUniquePtr<FInflater> Inflater;
+
+			/*The first bytes until the format is known, all of a zip*/
+			TArray<uint8> Buffered;
+
+			EFormat Format;
+			bool bAttached;
+			bool bFailed;
+			int64 ReceivedBytes;
+			FString Error;
+		};
+
+		/*Blocks, run it on a worker*/
+		SIMPLEHTTP_API bool Extract(TArrayView<const uint8> Archive, const FString &TargetDir, int32 &OutEntries, FString &OutError);
+
+		/*Relative, with no drive and no ".." part, either slash separates parts*/
+		SIMPLEHTTP_API bool IsSafeEntryName(const FString &Name);
+	}
+}
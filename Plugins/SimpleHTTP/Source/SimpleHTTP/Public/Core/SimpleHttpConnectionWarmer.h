@@ -0,0 +1,59 @@
+// Copyright (C) RenZhai.2020.All Rights Reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Interfaces/IHttpRequest.h"
+#include "Interfaces/IHttpResponse.h"
+
+namespace SimpleHTTP
+{
+	/**
+	 * Opens connections to hosts ahead of their first real request with a HEAD on the origin.
+	 * The engine transport keeps the resolved address, the TLS session and the connection itself for later requests,
+	 * so the first login call does not pay for DNS, TCP and the full handshake.
+	 * With SimpleHTTP.PrewarmTTLSeconds set, warm hosts are warmed again once it expires, so the resolver entries
+	 * and kept-alive connections do not go stale during long menus.
+	 * Game thread only.
+	 */
+	class SIMPLEHTTP_API FSimpleHttpConnectionWarmer
+	{
+	public:
+		static FSimpleHttpConnectionWarmer &Get();
+
+		/*Any URL of the host will do, only its scheme, host and port are used*/
+		void Prewarm(const TArray<FString> &URL);
+
+		/*Cancels running warmups and forgets every host*/
+		void Cancel();
+
+		/*The last warmup of the origin of this URL succeeded and has not expired*/
+		bool IsWarm(const FString &URL) const;
+
+		/*Called by the manager, warms expired hosts again*/
+		void Tick();
+
+		/*"scheme://host:port" of a URL, empty when it has no scheme*/
+		static FString GetOrigin(const FString &URL);
+
+	private:
+		FSimpleHttpConnectionWarmer();
+
+		void StartWarmup(const FString &Origin);
+		void HttpRequestComplete(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bConnectedSuccessfully, FString Origin);
+
+	private:
+		struct FHost
+		{
+			FHost()
+				:LastWarmTime(0.0)
+				,bWarm(false)
+			{}
+
+			FHttpRequestPtr Request;
+			double LastWarmTime;
+			bool bWarm;
+		};
+
+		TMap<FString, FHost> Hosts;
+	};
+}
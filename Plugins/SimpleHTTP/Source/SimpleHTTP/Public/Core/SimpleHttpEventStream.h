@@ -0,0 +1,60 @@
+// Copyright (C) RenZhai.2020.All Rights Reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Interfaces/IHttpRequest.h"
+#include "SimpleHTTPType.h"
+
+namespace SimpleHTTP
+{
+	/**
+	 * Turns a response body into server-sent events, or plain chunks, while the response is still open.
+	 * The transport appends on the HTTP thread, the game thread takes what is ready from its Tick.
+	 * Undelivered events are bounded in bytes, the oldest are dropped when the game thread falls behind.
+	 * Where the engine can not attach it, the whole body is appended once the response ends.
+	 */
+	class SIMPLEHTTP_API FSimpleHttpEventStream : public TSharedFromThis<FSimpleHttpEventStream, ESPMode::ThreadSafe>
+	{
+	public:
+		FSimpleHttpEventStream(bool bInServerSentEvents, int64 InMaxBufferedBytes);
+
+		/*Has the transport write the body into this stream. False where the engine can only hand it over at the end.*/
+		bool AttachTo(IHttpRequest &Request);
+		FORCEINLINE bool IsAttached() const { return bAttached; }
+
+		/*Any thread*/
+		void Append(const uint8 *Data, int64 Num);
+
+		/*The body of a response that has ended, every event it holds is kept for the next Dequeue*/
+		void AppendWhole(const uint8 *Data, int64 Num);
+
+		/*Game thread, in the order they were received*/
+		void Dequeue(TArray<FSimpleHttpStreamEvent> &OutEvents);
+
+	private:
+		void ParseLine();
+		void DispatchEvent();
+		void Enqueue(FSimpleHttpStreamEvent &&Event);
+
+	private:
+		const bool bServerSentEvents;
+		const int64 MaxBufferedBytes;
+		bool bAttached;
+
+		FCriticalSection Mutex;
+
+		/*Set by AppendWhole, the game thread takes everything in one go and nothing has to make room*/
+		bool bKeepAll;
+
+		TArray<FSimpleHttpStreamEvent> Events;
+		int64 BufferedBytes;
+
+		/*Server-sent event being read*/
+		TArray<uint8> Line;
+		bool bLastWasCR;
+		bool bSkippingLine;
+		FString EventType;
+		FString EventId;
+		FString EventData;
+	};
+}
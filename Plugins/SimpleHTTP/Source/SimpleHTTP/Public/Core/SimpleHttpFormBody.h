@@ -0,0 +1,60 @@
+// Copyright (C) RenZhai.2020.All Rights Reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+
+namespace SimpleHTTP
+{
+	/**
+	 * Builds an application/x-www-form-urlencoded body.
+	 * The encoded size is measured first, so the body is allocated exactly once.
+	 */
+	SIMPLEHTTP_API TArray<uint8> BuildFormURLEncodedBody(const TMap<FString, FString> &Fields);
+	SIMPLEHTTP_API TArray<uint8> BuildFormURLEncodedBody(const TArray<TPair<FString, FString>> &Fields);
+
+	/**
+	 * Describes a multipart/form-data body.
+	 * Only the part headers are kept in memory. File parts are read from disk while the transport
+	 * sends the body, so a large file is never buffered as a whole.
+	 */
+	class SIMPLEHTTP_API FSimpleHttpMultipartForm
+	{
+	public:
+		FSimpleHttpMultipartForm();
+
+		void AddField(const FString &Name, const FString &Value);
+
+		/* The file size is read here, the file must not change before the request is sent */
+		bool AddFile(const FString &Name, const FString &LocalPath, const FString &ContentType = TEXT("application/octet-stream"));
+
+		void AddBuffer(const FString &Name, const FString &FileName, TSharedRef<const TArray<uint8>, ESPMode::ThreadSafe> Data, const FString &ContentType = TEXT("application/octet-stream"));
+
+		/* multipart/form-data; boundary=... */
+		FString GetContentType() const;
+
+		int64 GetTotalSize() const;
+
+		/* Every call returns a new reader positioned at the start of the body */
+		TSharedRef<FArchive, ESPMode::ThreadSafe> CreateStream() const;
+
+		FORCEINLINE bool IsEmpty() const { return Parts.Num() == 0; }
+
+	public:
+		struct FSegment
+		{
+			TSharedPtr<const TArray<uint8>, ESPMode::ThreadSafe> Data;
+			FString FilePath;
+			int64 Size;
+		};
+
+	private:
+		void AddPartHeader(const FString &Name, const FString *FileName, const FString *ContentType);
+		void AddMemorySegment(TArray<uint8> &&Data);
+
+	private:
+		FString Boundary;
+
+		/*Boundaries, part headers and part bodies in the order they are sent*/
+		TArray<FSegment> Parts;
+	};
+}
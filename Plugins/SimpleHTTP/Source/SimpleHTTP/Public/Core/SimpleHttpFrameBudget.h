@@ -0,0 +1,43 @@
+// Copyright (C) RenZhai.2020.All Rights Reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+
+namespace SimpleHTTP
+{
+	/**
+	 * Game thread time the plugin may spend per frame starting queued transfers and firing completion agents,
+	 * set with SimpleHTTP.FrameBudgetMs (0 = unlimited). Work past it waits for the next frame.
+	 * The first piece of work of a frame always runs, so everything keeps moving.
+	 * Game thread only.
+	 */
+	class SIMPLEHTTP_API FSimpleHttpFrameBudget
+	{
+	public:
+		/*Charges the time spent in its lifetime to the current frame*/
+		struct SIMPLEHTTP_API FScope
+		{
+			FScope();
+			~FScope();
+
+		private:
+			double StartTime;
+		};
+
+		static FSimpleHttpFrameBudget &Get();
+
+		bool IsExhausted();
+
+	private:
+		FSimpleHttpFrameBudget();
+
+		void Spend(double Seconds);
+
+		/*Starts over when the frame changed*/
+		void UpdateFrame();
+
+	private:
+		uint64 Frame;
+		double SpentSeconds;
+	};
+}
@@ -0,0 +1,48 @@
+// Copyright (C) RenZhai.2020.All Rights Reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Interfaces/IHttpResponse.h"
+
+namespace SimpleHTTP
+{
+	/**
+	 * Download checks run on the body in memory, before it is written, so a file is never read back to be verified.
+	 * Hashes are written "algorithm:hex" with md5, sha1, blake3 or xxhash64, hex digits compare case-insensitively.
+	 * blake3 is the SIMD accelerated one and the fastest choice for large files.
+	 */
+	namespace Integrity
+	{
+		/*Hashes Content in one pass, an empty string for an unknown algorithm*/
+		SIMPLEHTTP_API FString HashContent(TArrayView<const uint8> Content, const FString &Algorithm);
+
+		/*False with the reason in OutError when the content does not match ExpectedHash*/
+		SIMPLEHTTP_API bool VerifyHash(TArrayView<const uint8> Content, const FString &ExpectedHash, FString &OutError);
+
+		/*Hash announced by the response in Content-MD5 or Digest (md5= or sha=), empty when there is none*/
+		SIMPLEHTTP_API FString GetHashFromHeaders(const FHttpResponsePtr &Response);
+
+		/**
+		 * Everything one body is held to, gathered from the options and headers on the game thread,
+		 * so that Run, which hashes the whole body, can be handed to a worker on its own.
+		 */
+		struct SIMPLEHTTP_API FContentCheck
+		{
+			FContentCheck()
+				:Size(0)
+			{}
+
+			/*0 skips the size*/
+			int64 Size;
+
+			/*"algorithm:hex", empty skips either one*/
+			FString Hash;
+			FString HeaderHash;
+
+			FORCEINLINE bool IsEmpty() const { return Size <= 0 && Hash.IsEmpty() && HeaderHash.IsEmpty(); }
+
+			/*False with the reason in OutError at the first check Content does not pass*/
+			bool Run(TArrayView<const uint8> Content, FString &OutError) const;
+		};
+	}
+}
@@ -0,0 +1,46 @@
+// Copyright (C) RenZhai.2020.All Rights Reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/StructOnScope.h"
+
+class FJsonObject;
+
+namespace SimpleHTTP
+{
+	/**
+	 * Parses a UTF-8 JSON body straight into a new instance of Struct.
+	 * The bytes are fed to the JSON reader through a converting archive, so the body is never
+	 * copied into an FString first. Safe to call from a worker thread when CanDecodeOffGameThread(Struct).
+	 * A body that is a JSON array fills the one array property of Struct.
+	 *
+	 * @param UTF8Json		Response body.
+	 * @param Struct		Target layout.
+	 * @Return				Null when the body is not JSON or does not match Struct.
+	 */
+	SIMPLEHTTP_API TSharedPtr<FStructOnScope, ESPMode::ThreadSafe> DecodeJsonToStruct(TArrayView<const uint8> UTF8Json, const UScriptStruct* Struct);
+
+	/**
+	 * Same as above, into an existing instance.
+	 */
+	SIMPLEHTTP_API bool DecodeJsonToStruct(TArrayView<const uint8> UTF8Json, const UScriptStruct* Struct, void* OutStructMemory);
+
+	template<typename StructType>
+	bool DecodeJsonToStruct(TArrayView<const uint8> UTF8Json, StructType &OutStruct)
+	{
+		return DecodeJsonToStruct(UTF8Json, StructType::StaticStruct(), &OutStruct);
+	}
+
+	/**
+	 * False when Struct, or anything it nests, holds object, class, soft or interface references.
+	 * Those are resolved through the object system, which is not safe off the game thread.
+	 */
+	SIMPLEHTTP_API bool CanDecodeOffGameThread(const UStruct* Struct);
+
+	/**
+	 * Parses a UTF-8 JSON body into a DOM, without the FString copy.
+	 *
+	 * @Return				Null when the body is not a JSON object.
+	 */
+	SIMPLEHTTP_API TSharedPtr<FJsonObject> DecodeJsonObject(TArrayView<const uint8> UTF8Json);
+}
@@ -1,40 +1,43 @@
 #pragma once
 
+#include "CoreMinimal.h"
+#include "Interfaces/IHttpRequest.h"
+#include "Interfaces/IHttpResponse.h"
+#include "Core/SimpleHTTPMethod.h"
+#include "SimpleHTTPType.h"
+#include "Core/SimpleHttpTrace.h"
+#include "Core/SimpleHttpMemoryBudget.h"
+
 #define DEFINITION_HTTP_TYPE(VerbString,Content) \
 FString InNewURLEncoded = SimpleHTTP::SimpleURLEncode(*URL);\
 HttpReuest->SetURL(InNewURLEncoded);\
 HttpReuest->SetVerb(TEXT(#VerbString));\
-HttpReuest->SetHeader(TEXT("Content-Type"), TEXT(#Content)); 
+HttpReuest->SetHeader(TEXT("Content-Type"), TEXT(#Content));
 
 #define REQUEST_BIND_FUN(RequestClass) \
 (*Request) \
 << FHttpRequestHeaderReceivedDelegate::CreateRaw(this, &RequestClass::HttpRequestHeaderReceived)\
 << FHttpRequestProgressDelegate::CreateRaw(this, &RequestClass::HttpRequestProgress)\
-<< FHttpRequestCompleteDelegate::CreateRaw(this, &RequestClass::HttpRequestComplete);
+<< FHttpRequestCompleteDelegate::CreateRaw(this, &RequestClass::HttpRequestComplete);\
+SimpleHTTP::Trace::RequestCreated(this, Request->GetHttpRequest());
 
 #define SIMPLE_HTTP_REGISTERED_REQUEST_BP(TYPE) \
-auto Handle = RegisteredHttpRequest(TYPE, \
-	BPResponseDelegate.SimpleHttpRequestCompleteDelegate, \
-	BPResponseDelegate.SimpleHttpRequestProgressDelegate, \
-	BPResponseDelegate.SimpleHttpRequestHeaderReceivedDelegate, \
-	BPResponseDelegate.AllRequestCompleteDelegate);\
+LLM_SCOPE_BYTAG(SimpleHTTP);\
+auto Handle = RegisteredHttpRequest(TYPE, BPResponseDelegate);\
 TemporaryStorageHandle = Handle
 
 #define SIMPLE_HTTP_REGISTERED_REQUEST(TYPE) \
-auto Handle = RegisteredHttpRequest(TYPE, \
-	BPResponseDelegate.SimpleCompleteDelegate, \
-	BPResponseDelegate.SimpleSingleRequestProgressDelegate, \
-	BPResponseDelegate.SimpleSingleRequestHeaderReceivedDelegate, \
-	BPResponseDelegate.AllTasksCompletedDelegate);\
+LLM_SCOPE_BYTAG(SimpleHTTP);\
+auto Handle = RegisteredHttpRequest(TYPE, BPResponseDelegate);\
 TemporaryStorageHandle = Handle
 
-void RequestPtrToSimpleRequest(FHttpRequestPtr Request, FSimpleHttpRequest &SimpleHttpRequest)
+inline void RequestPtrToSimpleRequest(FHttpRequestPtr Request, FSimpleHttpRequest &SimpleHttpRequest)
 {
 	if (Request.IsValid())
 	{
 		SimpleHttpRequest.Verb = Request->GetVerb();
 		SimpleHttpRequest.URL = Request->GetURL();
-		SimpleHttpRequest.Status = (FSimpleHttpStarte)Request->GetStatus();
+		SimpleHttpRequest.Status = (ESimpleHttpStarte)Request->GetStatus();
 		SimpleHttpRequest.ElapsedTime = Request->GetElapsedTime();
 		SimpleHttpRequest.ContentType = Request->GetContentType();
 		SimpleHttpRequest.ContentLength = Request->GetContentLength();
@@ -42,16 +45,22 @@ void RequestPtrToSimpleRequest(FHttpRequestPtr Request, FSimpleHttpRequest &Simp
 	}
 }
 
-void ResponsePtrToSimpleResponse(FHttpResponsePtr Response, FSimpleHttpResponse &SimpleHttpResponse)
+inline void ResponsePtrToSimpleResponse(FHttpResponsePtr Response, FSimpleHttpResponse &SimpleHttpResponse)
 {
+	//Only created when someone takes the response as a struct, but always, so a failed request hands out an empty object
+	SimpleHttpResponse.Content = NewObject<USimpleHttpContent>();
+
 	if (Response.IsValid())
 	{
-		SimpleHttpResponse.ResponseCode = Response->GetResponseCode();
-		SimpleHttpResponse.URL = Response->GetURL();
-		SimpleHttpResponse.ResponseMessage = Response->GetContentAsString();
-		SimpleHttpResponse.ContentType = Response->GetContentType();
-		SimpleHttpResponse.ContentLength = Response->GetContentLength();
-		SimpleHttpResponse.AllHeaders = Response->GetAllHeaders();
-		SimpleHttpResponse.Content->Content = const_cast<TArray<uint8>*>(&Response->GetContent());
+		FSimpleHttpResponseView ResponseView(Response);
+
+		SimpleHttpResponse.ResponseCode = ResponseView.GetResponseCode();
+		SimpleHttpResponse.URL = ResponseView.GetURL();
+		SimpleHttpResponse.ResponseMessage = ResponseView.GetContentAsString();
+		SimpleHttpResponse.ContentType = ResponseView.GetContentType();
+		SimpleHttpResponse.ContentLength = ResponseView.GetContentLength();
+		SimpleHttpResponse.AllHeaders = ResponseView.GetAllHeaders();
+
+		SimpleHttpResponse.Content->Content = ResponseView.GetSharedContent();
 	}
-}
\ No newline at end of file
+}
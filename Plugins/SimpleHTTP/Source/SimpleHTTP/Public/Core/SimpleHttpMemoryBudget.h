@@ -0,0 +1,38 @@
+// Copyright (C) RenZhai.2020.All Rights Reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/LowLevelMemTracker.h"
+#include <atomic>
+
+/*Everything the plugin allocates on its own paths is scoped to this tag, see "stat LLM" or -llm*/
+LLM_DECLARE_TAG_API(SimpleHTTP, SIMPLEHTTP_API);
+
+namespace SimpleHTTP
+{
+	/**
+	 * Global budget for response bodies held in memory by handles, set with SimpleHTTP.MemoryBudgetMB (0 = unlimited).
+	 * Bodies count from their first received byte until their handle is reaped, prefetched ones while they are cached.
+	 * Over budget, handles keep queued transfers back until bytes are released.
+	 * Every call is thread safe.
+	 */
+	class SIMPLEHTTP_API FSimpleHttpMemoryBudget
+	{
+	public:
+		static FSimpleHttpMemoryBudget &Get();
+
+		void Charge(int64 Bytes);
+		void Release(int64 Bytes);
+
+		int64 GetBudgetBytes() const;
+		FORCEINLINE int64 GetBufferedBytes() const { return BufferedBytes; }
+
+		bool IsExceeded() const;
+
+	private:
+		FSimpleHttpMemoryBudget();
+
+	private:
+		std::atomic<int64> BufferedBytes;
+	};
+}
@@ -0,0 +1,26 @@
+// Copyright (C) RenZhai.2020.All Rights Reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+
+namespace SimpleHTTP
+{
+	/**
+	 * Mounting of downloaded pak containers through FCoreDelegates::MountPak, bound by the pak platform file.
+	 * A container is a .pak, with a .utoc and .ucas beside it when it was cooked for IoStore.
+	 * Mounting the .pak mounts the IoStore part with it.
+	 */
+	namespace PakMount
+	{
+		/*.pak, .utoc or .ucas*/
+		SIMPLEHTTP_API bool IsContainerPart(const FString &Filename);
+
+		/*The .pak a part belongs to*/
+		SIMPLEHTTP_API FString GetPakFilename(const FString &Filename);
+
+		/*Cheap structural checks for truncated or foreign files, the engine checks the index hash when mounting*/
+		SIMPLEHTTP_API bool VerifyContainer(const FString &PakFile, FString &OutError);
+
+		SIMPLEHTTP_API bool Mount(const FString &PakFile, int32 Order, FString &OutError);
+	}
+}
@@ -0,0 +1,79 @@
+// Copyright (C) RenZhai.2020.All Rights Reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Interfaces/IHttpRequest.h"
+#include "Interfaces/IHttpResponse.h"
+
+namespace SimpleHTTP
+{
+	/**
+	 * Idle priority downloads kept in memory for later GetObjectToMemory / GetObjectsToMemory calls on the same URL.
+	 * A prefetch only starts while no other SimpleHTTP request is queued or in flight. Foreground traffic cancels
+	 * the running prefetches, they go back to the front of the queue and start over once it is quiet again.
+	 * The cache is bounded by SimpleHTTP.PrefetchCacheMB and drops the least recently used bodies first.
+	 * Cached bodies count against SimpleHTTP.MemoryBudgetMB until they are dropped or handed out.
+	 * A body is kept for as long as its Cache-Control or Expires header allows, at most SimpleHTTP.PrefetchTTLSeconds,
+	 * and is handed out once. Bodies marked no-store or no-cache are not kept.
+	 * Game thread only.
+	 */
+	class SIMPLEHTTP_API FSimpleHttpPrefetchCache
+	{
+	public:
+		static FSimpleHttpPrefetchCache &Get();
+
+		/*Queues the URLs that are neither cached nor queued yet*/
+		void Prefetch(const TArray<FString> &URL);
+
+		/*Drops the queue and cancels the running prefetches, cached bodies stay*/
+		void CancelPrefetch();
+
+		/*Drops every cached body*/
+		void Empty();
+
+		/*Cached response of a successful prefetch that is still fresh, the URL is compared as it was given. The entry is taken out of the cache.*/
+		FHttpResponsePtr Find(const FString &URL);
+
+		/*Called by the manager, starts and pauses prefetches*/
+		void Tick();
+
+		FORCEINLINE int32 GetQueued() const { return Queue.Num(); }
+		FORCEINLINE int32 GetRunning() const { return Running.Num(); }
+		FORCEINLINE int64 GetCachedBytes() const { return CachedBytes; }
+
+	private:
+		FSimpleHttpPrefetchCache();
+
+		bool HasForegroundTraffic() const;
+		void StartPrefetch(const FString &URL);
+
+		/*Puts the running prefetches back at the front of the queue*/
+		void RequeueRunning();
+
+		void HttpRequestComplete(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bConnectedSuccessfully, FString URL);
+
+		void AddEntry(const FString &URL, FHttpResponsePtr Response);
+		void RemoveEntry(const FString &URL);
+		void RemoveExpired();
+		void TrimTo(int64 MaxBytes);
+
+	private:
+		struct FEntry
+		{
+			FHttpResponsePtr Response;
+			int64 Size;
+			uint64 LastUse;
+
+			/*FPlatformTime::Seconds() after which the body is stale*/
+			double ExpireTime;
+		};
+
+		TArray<FString> Queue;
+		TMap<FString, FHttpRequestPtr> Running;
+
+		TMap<FString, FEntry> Entries;
+		int64 CachedBytes;
+		uint64 UseCounter;
+		double NextExpireCheckTime;
+	};
+}
@@ -0,0 +1,45 @@
+// Copyright (C) RenZhai.2020.All Rights Reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Interfaces/IHttpResponse.h"
+
+/**
+ * Native, read-only view over an engine HTTP response.
+ * Nothing is copied when the view is built. The string body and the header list are
+ * only decoded when they are asked for, and the body bytes are shared with the engine response.
+ * The lazily decoded values are cached per view, so a view should not be shared between threads.
+ */
+class SIMPLEHTTP_API FSimpleHttpResponseView
+{
+public:
+	FSimpleHttpResponseView();
+	explicit FSimpleHttpResponseView(FHttpResponsePtr InResponse);
+
+	FORCEINLINE bool IsValid() const { return Response.IsValid(); }
+	FORCEINLINE FHttpResponsePtr GetResponse() const { return Response; }
+
+	int32 GetResponseCode() const;
+	FString GetURL() const;
+	FString GetContentType() const;
+	int32 GetContentLength() const;
+	FString GetHeader(const FString& HeaderName) const;
+
+	/** Body bytes as owned by the engine response. */
+	TArrayView<const uint8> GetContent() const;
+
+	/** Body bytes sharing ownership with the engine response, so they can outlive the request. */
+	TSharedPtr<const TArray<uint8>, ESPMode::ThreadSafe> GetSharedContent() const;
+
+	/** Body decoded as UTF-8. Decoded on first use. */
+	const FString& GetContentAsString() const;
+
+	/** All headers as "Name: Value". Gathered on first use. */
+	const TArray<FString>& GetAllHeaders() const;
+
+private:
+	FHttpResponsePtr Response;
+
+	mutable TOptional<FString> CachedContentAsString;
+	mutable TOptional<TArray<FString>> CachedAllHeaders;
+};
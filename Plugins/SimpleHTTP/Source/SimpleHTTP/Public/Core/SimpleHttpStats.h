@@ -0,0 +1,117 @@
+// Copyright (C) RenZhai.2020.All Rights Reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+#include "Interfaces/IHttpRequest.h"
+#include "Interfaces/IHttpResponse.h"
+#include <atomic>
+
+DECLARE_STATS_GROUP(TEXT("SimpleHTTP"), STATGROUP_SimpleHTTP, STATCAT_Advanced);
+
+namespace SimpleHTTP
+{
+	/**
+	 * Log-linear latency histogram, 8 buckets per power of two of microseconds.
+	 * Percentiles are accurate to 12.5% over the whole range, recording never allocates.
+	 * Not thread safe, callers guard it.
+	 */
+	struct SIMPLEHTTP_API FSimpleHttpLatencyHistogram
+	{
+		enum
+		{
+			SubBucketBits = 3,
+			SubBucketCount = 1 << SubBucketBits,
+			MaxExponent = 40,
+			BucketCount = MaxExponent * SubBucketCount
+		};
+
+		FSimpleHttpLatencyHistogram();
+
+		void Add(double Seconds);
+		void Merge(const FSimpleHttpLatencyHistogram &Other);
+		void Reset();
+
+		/*Upper bound of the bucket holding the given percentile, 0..100, in seconds*/
+		double GetPercentile(double Percentile) const;
+
+		FORCEINLINE uint64 Num() const { return Count; }
+		FORCEINLINE double GetMin() const { return Count ? MinSeconds : 0.0; }
+		FORCEINLINE double GetMax() const { return MaxSeconds; }
+		FORCEINLINE double GetMean() const { return Count ? TotalSeconds / Count : 0.0; }
+
+	private:
+		uint32 Buckets[BucketCount];
+		uint64 Count;
+		double MinSeconds;
+		double MaxSeconds;
+		double TotalSeconds;
+	};
+
+	/**
+	 * Process wide counters of the plugin. Fed by the request paths, read by the STAT group,
+	 * the SimpleHTTP.Stats console command and anyone tuning the client.
+	 * Every call is thread safe.
+	 */
+	class SIMPLEHTTP_API FSimpleHttpStats
+	{
+	public:
+		static FSimpleHttpStats &Get();
+
+		void RequestQueued();
+		void RequestDequeued();
+		void RequestStarted();
+
+		/*Closes a started request and records its latency against the endpoint*/
+		void RequestFinished(const FString &Verb, const FString &URL, double ElapsedSeconds, int64 BytesSent, int64 BytesReceived, bool bSucceeded);
+
+		/*Same as above for an engine request, it succeeded when it connected and answered with a 2xx code*/
+		void RequestFinished(const FHttpRequestPtr &Request, const FHttpResponsePtr &Response, bool bConnectedSuccessfully);
+
+		/*Streams are counted in flight as well, they stay open for as long as the server keeps sending*/
+		void StreamOpened();
+		void StreamClosed();
+
+		void RecordRetry();
+		void RecordCacheHit();
+
+		FORCEINLINE int32 GetInFlight() const { return InFlight; }
+		FORCEINLINE int32 GetQueued() const { return Queued; }
+		FORCEINLINE int32 GetOpenStreams() const { return OpenStreams; }
+		FORCEINLINE uint64 GetCompleted() const { return Completed; }
+		FORCEINLINE uint64 GetErrors() const { return Errors; }
+		FORCEINLINE uint64 GetRetries() const { return Retries; }
+		FORCEINLINE uint64 GetCacheHits() const { return CacheHits; }
+		FORCEINLINE uint64 GetBytesSent() const { return BytesSent; }
+		FORCEINLINE uint64 GetBytesReceived() const { return BytesReceived; }
+
+		/*Copies the latency of every endpoint, plus the total under an empty key*/
+		void GetLatencies(TMap<FString, FSimpleHttpLatencyHistogram> &OutLatencies) const;
+
+		/*Clears the totals and histograms, requests in flight or queued stay counted*/
+		void Reset();
+
+		void Dump(FOutputDevice &Ar) const;
+
+	private:
+		FSimpleHttpStats();
+
+		/*Method, host and path. Past MaxEndpoints new paths fold into their host.*/
+		FString GetEndpoint(const FString &Verb, const FString &URL) const;
+
+	private:
+		std::atomic<int32> InFlight;
+		std::atomic<int32> Queued;
+		std::atomic<int32> OpenStreams;
+		std::atomic<uint64> Completed;
+		std::atomic<uint64> Errors;
+		std::atomic<uint64> Retries;
+		std::atomic<uint64> CacheHits;
+		std::atomic<uint64> BytesSent;
+		std::atomic<uint64> BytesReceived;
+
+		mutable FCriticalSection Mutex;
+		FSimpleHttpLatencyHistogram TotalLatency;
+		TMap<FString, FSimpleHttpLatencyHistogram> EndpointLatencies;
+	};
+}
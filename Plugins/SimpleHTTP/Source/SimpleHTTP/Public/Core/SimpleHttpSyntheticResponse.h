@@ -0,0 +1,36 @@
+// Copyright (C) RenZhai.2020.All Rights Reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Interfaces/IHttpResponse.h"
+
+/**
+ * Response that was not read from a connection of its own, e.g. one entry split out of a batch reply.
+ * It behaves like an engine response, so it can go through the same completion delegates.
+ */
+class SIMPLEHTTP_API FSimpleHttpSyntheticResponse : public IHttpResponse
+{
+public:
+	FSimpleHttpSyntheticResponse(const FString &InURL, int32 InResponseCode, TMap<FString, FString> &&InHeaders, TArray<uint8> &&InContent);
+
+	//IHttpBase
+	virtual FString GetURL() const override;
+	virtual FString GetURLParameter(const FString& ParameterName) const override;
+	virtual FString GetHeader(const FString& HeaderName) const override;
+	virtual TArray<FString> GetAllHeaders() const override;
+	virtual FString GetContentType() const override;
+	virtual int32 GetContentLength() const override;
+	virtual const TArray<uint8>& GetContent() const override;
+
+	//IHttpResponse
+	virtual int32 GetResponseCode() const override;
+	virtual FString GetContentAsString() const override;
+
+private:
+	FString URL;
+	int32 ResponseCode;
+
+	/*Header names compare case-insensitively, as FString keys do*/
+	TMap<FString, FString> Headers;
+	TArray<uint8> Content;
+};
@@ -0,0 +1,19 @@
+// Copyright (C) RenZhai.2020.All Rights Reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+
+namespace SimpleHTTP
+{
+	/**
+	 * Upload body of a whole directory as one ustar archive, built while the transport reads it.
+	 * Only the file list is kept, entry headers are made and files are read when the transport reaches them.
+	 * With bGzip the archive is deflated on the fly. Its size has to be known before sending, so the
+	 * files are deflated once up front to measure it: the CPU cost doubles, nothing is kept in memory or on disk.
+	 *
+	 * @param Directory		Walked recursively. A file that changes size or goes missing before it is sent is padded
+	 *						or cut to the size of the walk and leaves the stream in error, the upload is then failed.
+	 * @Return				Null when the directory can not be read. Blocks, run it on a worker.
+	 */
+	SIMPLEHTTP_API TSharedPtr<FArchive, ESPMode::ThreadSafe> CreateDirectoryTarStream(const FString &Directory, bool bGzip);
+}
@@ -0,0 +1,107 @@
+// Copyright (C) RenZhai.2020.All Rights Reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Async/Future.h"
+#include "Interfaces/IHttpRequest.h"
+#include "SimpleHTTPType.h"
+#include <atomic>
+
+namespace SimpleHTTP
+{
+	/*What a task resolves to, whether it succeeded or not*/
+	struct SIMPLEHTTP_API FSimpleHttpResult
+	{
+		FSimpleHttpResult()
+			:Response(nullptr)
+			,bConnectedSuccessfully(false)
+			,bCancelled(false)
+		{}
+
+		FSimpleHttpRequest Request;
+		FHttpResponsePtr Response;
+		bool bConnectedSuccessfully;
+		bool bCancelled;
+
+		/*Connected and answered with a 2xx code*/
+		bool IsOk() const;
+
+		FORCEINLINE FSimpleHttpResponseView GetView() const { return FSimpleHttpResponseView(Response); }
+	};
+
+	struct FSimpleHttpAnyResult
+	{
+		FSimpleHttpAnyResult()
+			:Index(INDEX_NONE)
+		{}
+
+		/*Position of the first finished task in the array handed to WhenAny*/
+		int32 Index;
+		FSimpleHttpResult Result;
+	};
+
+	/**
+	 * Shared between any number of tasks, cancelling it cancels all of them.
+	 * Tasks started with a token that is already cancelled resolve immediately.
+	 */
+	class SIMPLEHTTP_API FSimpleHttpCancellationToken : public TSharedFromThis<FSimpleHttpCancellationToken, ESPMode::ThreadSafe>
+	{
+	public:
+		static TSharedRef<FSimpleHttpCancellationToken, ESPMode::ThreadSafe> Create();
+
+		void Cancel();
+		FORCEINLINE bool IsCancelled() const { return bCancelled; }
+
+		/*Returns false when the token is already cancelled, the request must not be started then*/
+		bool Register(const FHttpRequestRef &Request);
+		void Unregister(const FHttpRequestRef &Request);
+
+	private:
+		FSimpleHttpCancellationToken();
+
+	private:
+		std::atomic<bool> bCancelled;
+
+		FCriticalSection Mutex;
+		TArray<FHttpRequestPtr> Requests;
+	};
+
+	struct FSimpleHttpTaskOptions
+	{
+		FSimpleHttpTaskOptions()
+			:bCompleteOnHttpThread(false)
+			,TimeoutSeconds(0.f)
+		{}
+
+		/*Resolve the future on the HTTP thread instead of the game thread, continuations run there as well*/
+		bool bCompleteOnHttpThread;
+
+		/*0 keeps the engine default*/
+		float TimeoutSeconds;
+
+		TMap<FString, FString> Headers;
+
+		TSharedPtr<FSimpleHttpCancellationToken, ESPMode::ThreadSafe> CancellationToken;
+	};
+
+	/**
+	 * Future based requests. Unlike FSimpleHttpManage::FHTTP they do not register a handle,
+	 * the future owns the request. Chain steps with TFuture::Next, they can be started from any thread.
+	 */
+	struct SIMPLEHTTP_API FSimpleHttpTasks
+	{
+		static TFuture<FSimpleHttpResult> Get(const FString &URL, const FSimpleHttpTaskOptions &TaskOptions = FSimpleHttpTaskOptions());
+		static TFuture<FSimpleHttpResult> Delete(const FString &URL, const FSimpleHttpTaskOptions &TaskOptions = FSimpleHttpTaskOptions());
+		static TFuture<FSimpleHttpResult> Post(const FString &URL, TArray<uint8> &&Body, const FString &ContentType, const FSimpleHttpTaskOptions &TaskOptions = FSimpleHttpTaskOptions());
+		static TFuture<FSimpleHttpResult> Put(const FString &URL, TArray<uint8> &&Body, const FString &ContentType, const FSimpleHttpTaskOptions &TaskOptions = FSimpleHttpTaskOptions());
+
+		/*Sends a request the caller has configured, verb, URL and body included*/
+		static TFuture<FSimpleHttpResult> Execute(const FHttpRequestRef &Request, const FSimpleHttpTaskOptions &TaskOptions = FSimpleHttpTaskOptions());
+
+		/*Resolves once every task has, results keep the order of Futures*/
+		static TFuture<TArray<FSimpleHttpResult>> WhenAll(TArray<TFuture<FSimpleHttpResult>> &&Futures);
+
+		/*Resolves with the first task to finish, the others keep running unless their token is cancelled*/
+		static TFuture<FSimpleHttpAnyResult> WhenAny(TArray<TFuture<FSimpleHttpResult>> &&Futures);
+	};
+}
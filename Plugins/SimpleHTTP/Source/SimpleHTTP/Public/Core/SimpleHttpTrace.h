@@ -0,0 +1,48 @@
+// Copyright (C) RenZhai.2020.All Rights Reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Trace/Trace.h"
+#include "Interfaces/IHttpRequest.h"
+
+#define SIMPLEHTTP_TRACE_ENABLED (UE_TRACE_ENABLED && !UE_BUILD_SHIPPING)
+
+#if SIMPLEHTTP_TRACE_ENABLED
+UE_TRACE_CHANNEL_EXTERN(SimpleHTTPChannel, SIMPLEHTTP_API)
+#endif
+
+namespace SimpleHTTP
+{
+	/**
+	 * Lifecycle spans for Unreal Insights, recorded when the SimpleHTTP trace channel is on (-trace=default,SimpleHTTP).
+	 * Every phase is emitted as a SimpleHTTP.RequestPhase event with host, verb, size and status,
+	 * and shown as a timing region so it lines up with frames in the Timing view.
+	 * A span is keyed by the object it follows, a handle's action request or an engine request.
+	 * Handle spans carry the handle name where requests carry their host.
+	 */
+	namespace Trace
+	{
+		/*Phases only move forward, entering an earlier one is ignored*/
+		enum class EPhase : uint8
+		{
+			Registration,
+			QueueWait,
+			/*Until the first response header. The engine does not report the connect on its own.*/
+			ConnectAndFirstByte,
+			BodyTransfer,
+			PostProcess,
+			Dispatch,
+			/*A handle between its registration and its last request*/
+			Active,
+		};
+
+		SIMPLEHTTP_API bool IsEnabled();
+
+		SIMPLEHTTP_API void BeginSpan(const void *Key, EPhase Phase, const FString &Verb, const FString &URL);
+		SIMPLEHTTP_API void EnterPhase(const void *Key, EPhase Phase);
+		SIMPLEHTTP_API void EndSpan(const void *Key, int32 Status = 0, int64 Size = 0);
+
+		/*Ends the registration of the owning handle and starts the queue wait of its request*/
+		SIMPLEHTTP_API void RequestCreated(const void *Owner, const IHttpRequest *Request);
+	}
+}
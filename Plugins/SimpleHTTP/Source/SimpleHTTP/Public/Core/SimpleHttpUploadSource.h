@@ -0,0 +1,22 @@
+// Copyright (C) RenZhai.2020.All Rights Reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+
+namespace SimpleHTTP
+{
+	/**
+	 * Upload body read straight out of a memory mapping of the file.
+	 * The transport copies from the mapped pages into its send buffer, so no heap block of the file size
+	 * is ever allocated. Falls back to a buffered file reader where the platform can not map files.
+	 *
+	 * @param LocalPath		File to upload, it must not change until the request completes.
+	 * @Return				Null when the file can not be opened.
+	 */
+	SIMPLEHTTP_API TSharedPtr<FArchive, ESPMode::ThreadSafe> CreateMappedFileStream(const FString &LocalPath);
+
+	/**
+	 * Upload body read from a buffer the caller shares by reference count instead of copying it into the request.
+	 */
+	SIMPLEHTTP_API TSharedRef<FArchive, ESPMode::ThreadSafe> CreateSharedBufferStream(TSharedRef<const TArray<uint8>, ESPMode::ThreadSafe> Buffer);
+}
@@ -4,6 +4,20 @@
 #include "Interfaces/IHttpRequest.h"
 #include "Interfaces/IHttpResponse.h"
 #include "SimpleHTTPType.h"
+#include "HTTP/Core/SimpleHTTPHandle.h"
+#include "Core/SimpleHttpIntegrity.h"
+
+namespace SimpleHTTP
+{
+	class FSimpleHttpMultipartForm;
+	class FSimpleHttpEventStream;
+
+	namespace Archive
+	{
+		class FStreamExtractor;
+	}
+}
+
 /**
  * 
  */
@@ -17,12 +31,24 @@ public:
 	FSimpleHttpSingleRequestProgressDelegate			SimpleHttpRequestProgressDelegate;
 	FSimpleHttpSingleRequestHeaderReceivedDelegate		SimpleHttpRequestHeaderReceivedDelegate;
 	FAllRequestCompleteDelegate							AllRequestCompleteDelegate;
+	FSimpleHttpProgressEventDelegate					SimpleHttpProgressEventDelegate;
+	FSimpleHttpHeaderEventDelegate						SimpleHttpHeaderEventDelegate;
+	FSimpleHttpResultBatchDelegate						SimpleHttpResultBatchDelegate;
+	FSimpleHttpPakMountDelegate							SimpleHttpPakMountDelegate;
+	FSimpleHttpStreamEventDelegate						SimpleHttpStreamEventDelegate;
 
 	//C++
 	FSimpleSingleCompleteDelegate						SimpleCompleteDelegate;
+	FSimpleSingleCompleteViewDelegate					SimpleCompleteViewDelegate;
+	FSimpleSingleCompleteStructDelegate					SimpleCompleteStructDelegate;
 	FSimpleSingleRequestProgressDelegate				SimpleSingleRequestProgressDelegate;
 	FSimpleSingleRequestHeaderReceivedDelegate			SimpleSingleRequestHeaderReceivedDelegate;
 	FSimpleDelegate										AllTasksCompletedDelegate;
+	FSimpleProgressEventDelegate						SimpleProgressEventDelegate;
+	FSimpleHeaderEventDelegate							SimpleHeaderEventDelegate;
+	FSimpleResultBatchDelegate							SimpleResultBatchDelegate;
+	FSimplePakMountDelegate								SimplePakMountDelegate;
+	FSimpleStreamEventDelegate							SimpleStreamEventDelegate;
 
 public:
 	FSimpleHttpActionRequest();
@@ -31,6 +57,9 @@ public:
 	virtual bool Suspend();
 	virtual bool Cancel();
 
+	/*Called by the manager on the game thread for work that is not driven by HTTP callbacks*/
+	virtual void Tick(float DeltaTime);
+
 	//Compatibility blueprint
 	virtual void GetObjects(const TArray<FString> &URL, const FString &SavePaths);
 	virtual void GetObjects(const TArray<FString> &URL);
@@ -43,12 +72,31 @@ public:
 	virtual bool PutObjectByString(const FString& URL, const FString& InBuff);
 	virtual bool PutObject(const FString &URL, TSharedRef<FArchive, ESPMode::ThreadSafe> Stream);
 	virtual bool DeleteObject(const FString &URL);
-	virtual bool PostObject(const FString &URL);
+	virtual bool PostObject(const FString &URL, TArray<uint8> &&FormBody);
+	virtual bool PostMultipartForm(const FString &URL, const SimpleHTTP::FSimpleHttpMultipartForm &Form);
+
+	/*The body is extracted into ExtractPaths on a worker, the archive itself is never stored*/
+	virtual bool GetArchive(const FString &URL, const FString &ExtractPaths);
+
+	/*The directory is sent as one tar, optionally gzipped, built while it is sent*/
+	virtual bool PutDirectory(const FString &URL, const FString &LocalDirectory, bool bGzip);
+
+	/*Events or chunks of the body go to the stream agents while the response is open, before 5.2 all of them once it ends*/
+	virtual bool GetStream(const FString &URL, bool bServerSentEvents);
 
 	FORCEINLINE const FString& GetPaths() const { return TmpSavePaths; }
 	FORCEINLINE void SetPaths(const FString &NewPaths) { TmpSavePaths = NewPaths; }
 	FORCEINLINE bool IsRequestComplete() const { return bRequestComplete; }
 
+	FORCEINLINE const FSimpleHTTPHandle& GetHandle() const { return Handle; }
+	FORCEINLINE void SetHandle(const FSimpleHTTPHandle &NewHandle) { Handle = NewHandle; }
+
+	/*Bodies are decoded into this struct on a worker thread for SimpleCompleteStructDelegate*/
+	FORCEINLINE void SetDecodeStruct(const UScriptStruct* NewDecodeStruct) { DecodeStruct = NewDecodeStruct; }
+
+	FORCEINLINE const FSimpleHttpRequestOptions& GetOptions() const { return Options; }
+	virtual void SetOptions(const FSimpleHttpRequestOptions &NewOptions);
+
 protected:
 	virtual void HttpRequestComplete(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bConnectedSuccessfully);
 	virtual void HttpRequestProgress(FHttpRequestPtr Request, int32 BytesSent, int32 BytesReceived);
@@ -58,8 +106,158 @@ protected:
 
 protected:
 	virtual void ExecutionCompleteDelegate(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bConnectedSuccessfully);
+
+	/*Stores the body of a finished request and fires its agents, HttpRequestComplete runs it within the frame budget*/
+	void CompleteRequest(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bConnectedSuccessfully);
+
+	/*Runs now, or from a later Tick once SimpleHTTP.FrameBudgetMs is spent this frame. Interactive handles never wait.*/
+	void DeliverWithinFrameBudget(TUniqueFunction<void()> &&Delivery);
+
+	/*Queues behind the deferred deliveries, for results that are ready before the caller has its handle*/
+	FORCEINLINE void DeliverOnNextTick(TUniqueFunction<void()> &&Delivery) { DeferredDeliveries.Add(MoveTemp(Delivery)); }
+
+	/*Serves a prefetched body as a finished GET*/
+	void DeliverCachedResponse(const FString &URL, FHttpResponsePtr CachedResponse);
+
+	/*Fires the completion agents for one finished operation, which is not always one engine request*/
+	void DeliverComplete(const FSimpleHttpRequest &SimpleHttpRequest, FHttpResponsePtr Response, bool bConnectedSuccessfully);
+
+	/*Hands the aggregated records gathered so far to the result batch agents, called before the handle completes*/
+	void FlushResultRecords();
+
+	/*Delivers the last progress of a finished sub request if the throttle held it back, and drops its throttle*/
+	void FlushProgress(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bConnectedSuccessfully);
+
+	/*Keeps the memory budget in step with the body a sub request holds, released with the handle or by ReleaseBufferedBody*/
+	void ChargeBufferedBody(const IHttpRequest *Request, int64 BodyBytes);
+	void ReleaseBufferedBody(const IHttpRequest *Request);
+
+	/*Decodes off the game thread, SimpleCompleteStructDelegate fires back on the game thread*/
+	void DecodeResponseToStruct(const FSimpleHttpRequest &SimpleHttpRequest, FHttpResponsePtr Response, bool bConnectedSuccessfully);
+
+	/*False when no struct decode or pak mount is out, otherwise Complete runs once the last one has been delivered*/
+	bool DeferUntilWorkersDone(TFunction<void()> Complete);
+	void WorkerFinished();
+
+	/*Applies the progress throttle of the sub request*/
+	bool ShouldDeliverProgress(FHttpRequestPtr Request, int32 BytesSent, int32 BytesReceived);
+
+	/*Fires the header agents unless the filter drops the header, MakeRequest only runs for the agents that take the request*/
+	void DeliverHeader(const FString &HeaderName, const FString &NewHeaderValue, TFunctionRef<void(FSimpleHttpRequest&)> MakeRequest);
+
+	/*Fires the progress agents*/
+	void DeliverProgress(FHttpRequestPtr Request, int64 BytesSent, int64 BytesReceived);
+
+	/*What the body must match under Options.ExpectedContents and Options.bVerifyHashHeaders*/
+	SimpleHTTP::Integrity::FContentCheck GetContentCheck(FHttpRequestPtr Request, FHttpResponsePtr Response) const;
+
+	/*Checks and writes the body on a worker, then completes the request back on the game thread*/
+	void VerifyAndStore(FHttpRequestPtr Request, FHttpResponsePtr Response, const SimpleHTTP::Integrity::FContentCheck &Check);
+
+	/*Completes a request whose body did not pass its check, with Failed_Integrity as its status*/
+	void FailIntegrity(FHttpRequestPtr Request, FHttpResponsePtr Response, const FString &Error);
+
+	/*Completes a download whose body could not be written to SavePath, with Failed as its status*/
+	void FailStore(FHttpRequestPtr Request, FHttpResponsePtr Response, const FString &SavePath);
+
+	/*Fires the stream agents for what the event stream has gathered*/
+	void DeliverStreamEvents();
+
+	/*True when Options hold the body of URL to a size or hash, which needs the whole body at once*/
+	bool HasContentCheck(const FString &URL) const;
+
+	/*Finishes the streamed extraction, or checks and extracts the whole body, on a worker and completes the request back on the game thread*/
+	void ExtractArchive(FHttpRequestPtr Request, FHttpResponsePtr Response);
+
+	/*With Options.bMountPaks, remembers which parts each container waits for before it is mounted*/
+	void ExpectPakParts(const TArray<FString> &URL);
+
+	/*A part of a container is on disk or has failed, once nothing is left the container is mounted on a worker or reported. Runs before the part completes, so a mount holds the handle open.*/
+	void PakPartFinished(const FString &URL, bool bStored);
+
+	/*Reports every container still waiting for parts as not mounted, for handles that are cancelled*/
+	void FailPendingPaks(const FString &Error);
+
+	/*Fires the pak mount agents*/
+	void DeliverPakMount(const FSimpleHttpPakMountEvent &PakMountEvent);
 protected:
 	FString						TmpSavePaths;
 	bool						bRequestComplete;
 	bool						bSaveDisk;
+	bool						bExtractArchive;
+
+	FSimpleHTTPHandle			Handle;
+	FSimpleHttpRequestOptions	Options;
+
+	TWeakObjectPtr<const UScriptStruct> DecodeStruct;
+
+	/*Set for GetStream, written by the transport on the HTTP thread*/
+	TSharedPtr<SimpleHTTP::FSimpleHttpEventStream, ESPMode::ThreadSafe> EventStream;
+
+	/*Requests whose body was not what the caller gave, ExecutionCompleteDelegate reports them as Failed*/
+	TSet<const IHttpRequest*>	FailedUploads;
+
+	/*Set for GetArchive while the engine can extract the body as it arrives*/
+	TSharedPtr<SimpleHTTP::Archive::FStreamExtractor, ESPMode::ThreadSafe> ArchiveExtractor;
+
+private:
+	struct FProgressThrottle
+	{
+		FProgressThrottle()
+			:BytesSent(0)
+			,BytesReceived(0)
+			,DeliveredBytesSent(0)
+			,DeliveredBytesReceived(0)
+			,DeliveryTime(0.0)
+		{}
+
+		/*Last progress seen and last progress delivered*/
+		int64 BytesSent;
+		int64 BytesReceived;
+		int64 DeliveredBytesSent;
+		int64 DeliveredBytesReceived;
+		double DeliveryTime;
+	};
+
+	/*Both throttles are kept per sub request, so one busy transfer does not starve the others of the handle*/
+	TMap<const IHttpRequest*, FProgressThrottle> ProgressThrottles;
+
+	/*Struct decodes and pak mounts still on a worker, the handle does not complete before they are delivered*/
+	int32						PendingWorkers;
+	TFunction<void()>			WorkersDoneCompletion;
+
+	/*Body bytes charged to SimpleHTTP::FSimpleHttpMemoryBudget per sub request*/
+	TMap<const IHttpRequest*, int64> BufferedBodies;
+
+	/*Built from Options.HeaderFilter, names compare case-insensitively*/
+	TSet<FString>				HeaderFilter;
+
+	/*Options.ExpectedContents keyed by the encoded URL the engine request reports*/
+	TMap<FString, FSimpleHttpExpectedContent> ExpectedContents;
+
+	/*Requests FailIntegrity is completing, ExecutionCompleteDelegate reports them as Failed_Integrity*/
+	TSet<const IHttpRequest*>	FailedIntegrity;
+
+	/*Downloads FailStore is completing, ExecutionCompleteDelegate reports them as Failed*/
+	TSet<const IHttpRequest*>	FailedStores;
+
+	/*Deliveries waiting on the frame budget, in the order the requests finished*/
+	TArray<TUniqueFunction<void()>> DeferredDeliveries;
+
+	/*Gathered while Options.bAggregateResults is set, up to Options.ResultChunkSize at a time*/
+	TArray<FSimpleHttpResultRecord> ResultRecords;
+
+	struct FPendingPak
+	{
+		FPendingPak()
+			:bFailed(false)
+		{}
+
+		/*Clean filenames still downloading*/
+		TSet<FString> Parts;
+		bool bFailed;
+	};
+
+	/*Keyed by the .pak filename of the container*/
+	TMap<FString, FPendingPak> PendingPaks;
 };
@@ -16,9 +16,11 @@ class SIMPLEHTTP_API FSimpleHttpActionMultipleRequest : public FSimpleHttpAction
 {
 public:
 	FSimpleHttpActionMultipleRequest();
+	virtual ~FSimpleHttpActionMultipleRequest();
 
 	virtual bool Suspend() override;
 	virtual bool Cancel() override;
+	virtual void Tick(float DeltaTime) override;
 
 	virtual void GetObjects(const TArray<FString> &URL, const FString &SavePaths) override;
 	virtual void GetObjects(const TArray<FString> &URL) override;
@@ -34,6 +36,82 @@ protected:
 	virtual void ExecutionCompleteDelegate(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bConnectedSuccessfully) override;
 
 private:
+	/**
+	 * Packs the operations into POSTs to Options.BatchEndpoint, Options.MaxBatchSize at a time.
+	 * Body:  {"operations":[{"id":0,"method":"DELETE","url":"..."},...]}
+	 * Reply: {"responses":[{"id":0,"status":200,"headers":{"k":"v"},"body":"..."},...]}
+	 * A reply entry may carry "bodyBase64" instead of "body" for binary content.
+	 */
+	void ExecuteBatches(const FString &Verb, const TArray<FString> &URL);
+	void HttpBatchRequestComplete(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bConnectedSuccessfully, int32 BatchIndex);
+	void CompleteBatchRequest(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bConnectedSuccessfully, int32 BatchIndex);
+
+	FORCEINLINE bool IsBatchEnabled() const { return !Options.BatchEndpoint.IsEmpty() && Options.MaxBatchSize > 1; }
+
+	/*Counts one finished operation, the last one completes the handle*/
+	void OperationComplete();
+	void CompleteIfIdle();
+
+	/*Moves scanned files into uploads while fewer than Options.UploadPipelineDepth are in flight*/
+	void PumpUploadScan();
+
+	/*Keeps a new sub request until its completion is delivered*/
+	TSharedPtr<SimpleHTTP::HTTP::IHTTPClientRequest> AddRequest(TSharedRef<SimpleHTTP::HTTP::IHTTPClientRequest> Request);
+
+	/*Drops a delivered sub request, its engine request and body go with it*/
+	void ReleaseRequest(const IHttpRequest *Request);
+
+	/*Queues a request behind its host, DispatchPendingRequests starts it*/
+	void SubmitRequest(TSharedPtr<SimpleHTTP::HTTP::IHTTPClientRequest> Request);
+	void DispatchPendingRequests();
+	void DispatchPendingRequests(int32 HostIndex);
+
+	/*Completes a request that never reached the transport*/
+	void FailRequest(TSharedPtr<SimpleHTTP::HTTP::IHTTPClientRequest> Request);
+
+private:
+	struct FBatch
+	{
+		FString Verb;
+		TArray<FString> URLs;
+	};
+
 	uint32 RequestNumber;
-	TArray<TSharedPtr<SimpleHTTP::HTTP::IHTTPClientRequest>> Requests;
+
+	/*Sub requests not delivered yet, keyed by their engine request. Reserved per call, not per request.*/
+	TMap<const IHttpRequest*, TSharedPtr<SimpleHTTP::HTTP::IHTTPClientRequest>> Requests;
+
+	/*Folder scan of PutObject, shared with the worker running it. Null once the scan is drained.*/
+	struct FUploadScan;
+	TSharedPtr<FUploadScan, ESPMode::ThreadSafe> UploadScan;
+	FString UploadURL;
+
+	/*Indexed by the payload bound to the batch completion*/
+	TArray<FBatch> Batches;
+
+	struct FHostQueue
+	{
+		FHostQueue()
+			:NextPending(0)
+			,ActiveCount(0)
+		{}
+
+		FString Host;
+		TArray<TSharedPtr<SimpleHTTP::HTTP::IHTTPClientRequest>> Pending;
+		int32 NextPending;
+		int32 ActiveCount;
+	};
+
+	/*Requests are scheduled per host, so one host never holds more than Options.MaxConnectionsPerHost connections*/
+	TArray<FHostQueue> HostQueues;
+	TMap<FString, int32> HostIndices;
+
+	/*Started engine requests and the index of the host they count against*/
+	TMap<const IHttpRequest*, int32> ActiveHosts;
+
+	/*Set while queued requests wait on SimpleHTTP.MemoryBudgetMB, Tick resumes them*/
+	bool bPausedByMemoryBudget;
+
+	/*Set when SimpleHTTP.FrameBudgetMs ran out with requests still queued, Tick starts them next frame*/
+	bool bPausedByFrameBudget;
 };
@@ -27,7 +27,11 @@ public:
 	virtual bool PutObjectByString(const FString& URL, const FString& InBuff) override;
 	virtual bool PutObject(const FString& URL, TSharedRef<FArchive, ESPMode::ThreadSafe> Stream) override;
 	virtual bool DeleteObject(const FString& URL) override;
-	virtual bool PostObject(const FString& URL) override;
+	virtual bool PostObject(const FString& URL, TArray<uint8>&& FormBody) override;
+	virtual bool PostMultipartForm(const FString& URL, const SimpleHTTP::FSimpleHttpMultipartForm& Form) override;
+	virtual bool GetArchive(const FString& URL, const FString& ExtractPaths) override;
+	virtual bool PutDirectory(const FString& URL, const FString& LocalDirectory, bool bGzip) override;
+	virtual bool GetStream(const FString& URL, bool bServerSentEvents) override;
 protected:
 	virtual void HttpRequestComplete(FHttpRequestPtr InRequest, FHttpResponsePtr Response, bool bConnectedSuccessfully) override;
 	virtual void HttpRequestProgress(FHttpRequestPtr InRequest, int32 BytesSent, int32 BytesReceived) override;
@@ -36,6 +40,19 @@ protected:
 protected:
 	virtual void ExecutionCompleteDelegate(FHttpRequestPtr InRequest, FHttpResponsePtr Response, bool bConnectedSuccessfully) override;
 
+	/*Completes the handle after its only operation*/
+	void OperationComplete();
+
+	/*Back on the game thread once the directory stream is built, a null stream fails the operation*/
+	void SendDirectory(const FString& URL, TSharedPtr<FArchive, ESPMode::ThreadSafe> Stream, bool bGzip);
+
 protected:
 	TSharedPtr<SimpleHTTP::HTTP::IHTTPClientRequest> Request;
+
+	/*The body of PutDirectory, which is in error once a file changed while it was sent*/
+	TSharedPtr<FArchive, ESPMode::ThreadSafe> DirectoryStream;
+
+	/*PutDirectory is walking the directory, and Cancel came before its request was made*/
+	bool bWalkingDirectory;
+	bool bCancelled;
 };
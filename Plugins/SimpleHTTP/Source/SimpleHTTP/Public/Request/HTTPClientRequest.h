@@ -3,6 +3,17 @@
 #include "CoreMinimal.h"
 #include "Request/RequestInterface.h"
 
+namespace SimpleHTTP
+{
+	class FSimpleHttpMultipartForm;
+	class FSimpleHttpEventStream;
+
+	namespace Archive
+	{
+		class FStreamExtractor;
+	}
+}
+
 namespace SimpleHTTP
 {
 	namespace HTTP
@@ -26,7 +37,33 @@ namespace SimpleHTTP
 
 		struct FPostObjectsRequest : IHTTPClientRequest
 		{
-			FPostObjectsRequest(const FString &URL);
+			FPostObjectsRequest(const FString &URL, TArray<uint8> &&FormBody);
+		};
+
+		struct FBatchRequest : IHTTPClientRequest
+		{
+			FBatchRequest(const FString &URL, TArray<uint8> &&BatchBody);
+		};
+
+		struct FMultipartFormRequest : IHTTPClientRequest
+		{
+			FMultipartFormRequest(const FString &URL, const FString &Verb, const FSimpleHttpMultipartForm &Form);
+		};
+
+		struct FPutArchiveRequest : IHTTPClientRequest
+		{
+			FPutArchiveRequest(const FString &URL, TSharedRef<FArchive, ESPMode::ThreadSafe> Stream, bool bGzip);
+		};
+
+		/*Extractor may be null, the body is then extracted once it has arrived*/
+		struct FGetArchiveRequest : IHTTPClientRequest
+		{
+			FGetArchiveRequest(const FString &URL, Archive::FStreamExtractor *Extractor);
+		};
+
+		struct FGetStreamRequest : IHTTPClientRequest
+		{
+			FGetStreamRequest(const FString &URL, FSimpleHttpEventStream &EventStream, bool bServerSentEvents);
 		};
 	}
 }
\ No newline at end of file
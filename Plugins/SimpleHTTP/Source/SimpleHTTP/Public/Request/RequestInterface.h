@@ -32,6 +32,12 @@ namespace SimpleHTTP
 				return *this;
 			}
 
+			FORCEINLINE FString GetURL() const { return HttpReuest->GetURL(); }
+			FORCEINLINE FString GetVerb() const { return HttpReuest->GetVerb(); }
+
+			/*Identifies the engine request in its delegates*/
+			FORCEINLINE const IHttpRequest* GetHttpRequest() const { return HttpReuest.Get(); }
+
 		protected:
 			bool ProcessRequest();
 			void CancelRequest();
@@ -57,6 +57,29 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "SimpleHTTP|SingleAction")
 	static bool PostRequest(const FString &InURL, const FString &InParam, const FSimpleHttpBpResponseDelegate &BPResponseDelegate);
 
+	/**
+	 * Submit an application/x-www-form-urlencoded form to server.
+	 *
+	 * @param BPResponseDelegate	Proxy set relative to the blueprint.
+	 * @param URL					domain name .
+	 * @param Fields				Keys and values, they are escaped here.
+	 * @Return						Returns true if the request succeeds
+	 */
+	UFUNCTION(BlueprintCallable, Category = "SimpleHTTP|SingleAction")
+	static bool PostForm(const FSimpleHttpBpResponseDelegate &BPResponseDelegate, const FString &URL, const TMap<FString, FString> &Fields);
+
+	/**
+	 * Submit a multipart/form-data form to server.
+	 *
+	 * @param BPResponseDelegate	Proxy set relative to the blueprint.
+	 * @param URL					domain name .
+	 * @param Fields				Text fields.
+	 * @param Files					Field name to local file path, files are streamed from disk.
+	 * @Return						Returns true if the request succeeds
+	 */
+	UFUNCTION(BlueprintCallable, Category = "SimpleHTTP|SingleAction")
+	static bool PostMultipartForm(const FSimpleHttpBpResponseDelegate &BPResponseDelegate, const FString &URL, const TMap<FString, FString> &Fields, const TMap<FString, FString> &Files);
+
 	/**
 	 *If platform is not turned PLATFORM_PROJECT macro, there is no need to manually put it in the tick of the project
 	 * @See SimpleHTTP.Build.cs
@@ -85,6 +108,28 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "SimpleHTTP|SingleAction")
 	static bool GetObjectToLocal(const FSimpleHttpBpResponseDelegate &BPResponseDelegate, const FString &URL, const FString &SavePaths);
 
+	/**
+	 * Download a zip, tar or gzipped tar and extract it on a worker, the archive itself is never stored .
+	 *
+	 * @param BPResponseDelegate	Proxy set relative to the blueprint.
+	 * @param URL					domain name .
+	 * @param ExtractPaths			Directory the entries are extracted into .
+	 * @Return						Returns true if the request succeeds
+	 */
+	UFUNCTION(BlueprintCallable, Category = "SimpleHTTP|SingleAction")
+	static bool GetArchiveToLocal(const FSimpleHttpBpResponseDelegate &BPResponseDelegate, const FString &URL, const FString &ExtractPaths);
+
+	/**
+	 * Open a long-lived response, each event or received chunk goes to Simple Http Stream Event Delegate while it is open .
+	 *
+	 * @param BPResponseDelegate	Proxy set relative to the blueprint.
+	 * @param URL					domain name .
+	 * @param bServerSentEvents		Parse text/event-stream events, otherwise chunks are delivered as received .
+	 * @Return						Returns true if the request succeeds. Before 5.2 the events arrive together once the response ends
+	 */
+	UFUNCTION(BlueprintCallable, Category = "SimpleHTTP|SingleAction")
+	static bool GetStream(const FSimpleHttpBpResponseDelegate &BPResponseDelegate, const FString &URL, bool bServerSentEvents = true);
+
 	/**
 	 * Upload single file from disk to server .
 	 *
@@ -138,6 +183,18 @@ public:
 	 */
 	UFUNCTION(BlueprintCallable, Category = "SimpleHTTP|MultpleAction")
 	static bool PutObjectsFromLocal(const FSimpleHttpBpResponseDelegate &BPResponseDelegate, const FString &URL, const FString &LocalPaths);
+
+	/**
+	 * Upload a whole directory as one tar in a single request, built while it is sent .
+	 *
+	 * @param BPResponseDelegate	Proxy set relative to the blueprint.
+	 * @param URL					domain name .
+	 * @param LocalDirectory		Directory to pack, walked recursively .
+	 * @param bGzip					Deflate the tar, the files are read twice to measure it .
+	 * @Return						Returns true if the request succeeds
+	 */
+	UFUNCTION(BlueprintCallable, Category = "SimpleHTTP|SingleAction")
+	static bool PutDirectoryAsArchive(const FSimpleHttpBpResponseDelegate &BPResponseDelegate, const FString &URL, const FString &LocalDirectory, bool bGzip);
 	
 	/**
 	 * Download multiple data to local .
@@ -168,5 +225,56 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "SimpleHTTP|MultpleAction")
 	static void DeleteObjects(const FSimpleHttpBpResponseDelegate &BPResponseDelegate, const TArray<FString> &URL);
 
+	/**
+	 * Download into the prefetch cache at idle priority, later Get Object(s) To Memory calls are served from it .
+	 *
+	 * @param URL					Need domain name .
+	 */
+	UFUNCTION(BlueprintCallable, Category = "SimpleHTTP|Prefetch")
+	static void PrefetchObjects(const TArray<FString> &URL);
+
+	/**
+	 * Drop the queued prefetches and cancel the running ones .
+	 */
+	UFUNCTION(BlueprintCallable, Category = "SimpleHTTP|Prefetch")
+	static void CancelPrefetch();
+
+	/**
+	 * Open connections to hosts before their first request, e.g. at startup .
+	 *
+	 * @param URL					Any URL of each host, only scheme, host and port are used .
+	 */
+	UFUNCTION(BlueprintCallable, Category = "SimpleHTTP|Prefetch")
+	static void PrewarmConnections(const TArray<FString> &URL);
+
+	/**
+	 * Escapes a single query key or value, path segment or form field .
+	 *
+	 * @param InString				Unescaped text.
+	 * @Return						Text that is safe to put in a URL.
+	 */
+	UFUNCTION(BlueprintPure, Category = "SimpleHTTP|URL")
+	static FString URLEncodeComponent(const FString &InString);
+
+	/**
+	 * Reverses URL escapes .
+	 *
+	 * @param InString				Escaped text.
+	 * @param bPlusAsSpace			Read '+' as a space, as form bodies do.
+	 * @Return						Decoded text.
+	 */
+	UFUNCTION(BlueprintPure, Category = "SimpleHTTP|URL")
+	static FString URLDecode(const FString &InString, bool bPlusAsSpace = false);
+
+	/**
+	 * Builds a URL with an escaped query string .
+	 *
+	 * @param BaseURL				Address to visit.
+	 * @param QueryParams			Keys and values, they are escaped here.
+	 * @Return						BaseURL?k=v&k2=v2
+	 */
+	UFUNCTION(BlueprintPure, Category = "SimpleHTTP|URL")
+	static FString MakeURL(const FString &BaseURL, const TMap<FString, FString> &QueryParams);
+
 public:
 };
@@ -9,6 +9,11 @@
 #endif
 
 class FSimpleHttpActionRequest;
+namespace SimpleHTTP
+{
+	class FSimpleHttpMultipartForm;
+}
+
 const FName NONE_NAME = TEXT("NONE");
 /*
  * A simple set of HTTP interface functions can quickly perform HTTP code operations. 
@@ -72,11 +77,33 @@ class SIMPLEHTTP_API FSimpleHttpManage
 		 * Submit form to server.
 		 *
 		 * @param InURL						Address to visit.
-		 * @param InParam					Parameters passed.
+		 * @param InParam					Already encoded "k=v&k2=v2" form, sent as the request body.
 		 * @param BPResponseDelegate		Proxy for site return.
 		 */
 		bool PostRequest(const TCHAR *InURL, const TCHAR *InParam, const FSimpleHttpBpResponseDelegate &BPResponseDelegate);
 
+		/**
+		 * Submit an application/x-www-form-urlencoded form to server.
+		 *
+		 * @param BPResponseDelegate	Proxy set relative to the blueprint.
+		 * @param URL					domain name .
+		 * @param Fields				Keys and values, they are escaped here.
+		 * @Return						Returns true if the request succeeds
+		 */
+		bool PostForm(const FSimpleHttpBpResponseDelegate &BPResponseDelegate, const FString &URL, const TMap<FString, FString> &Fields);
+
+		/**
+		 * Submit a multipart/form-data form to server.
+		 * Files are read from disk while the body is sent.
+		 *
+		 * @param BPResponseDelegate	Proxy set relative to the blueprint.
+		 * @param URL					domain name .
+		 * @param Fields				Text fields.
+		 * @param Files					Field name to local file path.
+		 * @Return						Returns true if the request succeeds
+		 */
+		bool PostMultipartForm(const FSimpleHttpBpResponseDelegate &BPResponseDelegate, const FString &URL, const TMap<FString, FString> &Fields, const TMap<FString, FString> &Files);
+
 		/**
 		 * The data can be downloaded to local memory via the HTTP serverll .
 		 *
@@ -104,6 +131,28 @@ class SIMPLEHTTP_API FSimpleHttpManage
 		 * @Return						Returns true if the request succeeds 
 		 */
 		bool GetObjectToLocal(const FSimpleHttpBpResponseDelegate &BPResponseDelegate, const FString &URL, const FString &SavePaths);
+
+		/**
+		 * Download a zip, tar or gzipped tar and extract it, the archive itself is never stored .
+		 * Extraction runs on a worker, the request completes once every entry is written.
+		 *
+		 * @param BPResponseDelegate	Proxy set relative to the blueprint.
+		 * @param URL					domain name .
+		 * @param ExtractPaths			Directory the entries are extracted into .
+		 * @Return						Returns true if the request succeeds
+		 */
+		bool GetArchiveToLocal(const FSimpleHttpBpResponseDelegate &BPResponseDelegate, const FString &URL, const FString &ExtractPaths);
+
+		/**
+		 * Open a long-lived response, e.g. server-sent events for match updates, instead of polling .
+		 * Each event or received chunk goes to the stream agents while the response is still open.
+		 *
+		 * @param BPResponseDelegate	Proxy set relative to the blueprint.
+		 * @param URL					domain name .
+		 * @param bServerSentEvents		Parse text/event-stream events, otherwise chunks are delivered as received .
+		 * @Return						Returns true if the request succeeds. Before 5.2 the events arrive together once the response ends
+		 */
+		bool GetStream(const FSimpleHttpBpResponseDelegate &BPResponseDelegate, const FString &URL, bool bServerSentEvents);
 		
 		/**
 		 * Download multiple data to local .
@@ -134,6 +183,18 @@ class SIMPLEHTTP_API FSimpleHttpManage
 		 */
 		bool PutObjectsFromLocal(const FSimpleHttpBpResponseDelegate &BPResponseDelegate, const FString &URL, const FString &LocalPaths);
 
+		/**
+		 * Upload a whole directory as one tar in a single request, for folders of many small files .
+		 * The tar is built while it is sent and never held in memory or on disk.
+		 *
+		 * @param BPResponseDelegate	Proxy set relative to the blueprint.
+		 * @param URL					domain name .
+		 * @param LocalDirectory		Directory to pack, walked recursively .
+		 * @param bGzip					Deflate the tar, the files are read twice to measure it .
+		 * @Return						Returns true if the request succeeds
+		 */
+		bool PutDirectoryAsArchive(const FSimpleHttpBpResponseDelegate &BPResponseDelegate, const FString &URL, const FString &LocalDirectory, bool bGzip);
+
 		/**
 		 * Can upload byte data .
 		 *
@@ -187,11 +248,31 @@ class SIMPLEHTTP_API FSimpleHttpManage
 		 * Submit form to server.
 		 *
 		 * @param InURL						Address to visit.
-		 * @param InParam					Parameters passed.
+		 * @param InParam					Already encoded "k=v&k2=v2" form, sent as the request body.
 		 * @param BPResponseDelegate		Proxy for site return.
 		 */
 		bool PostRequest(const TCHAR *InURL, const TCHAR *InParam, const FSimpleHttpResponseDelegate &BPResponseDelegate);
 
+		/**
+		 * Submit an application/x-www-form-urlencoded form to server.
+		 *
+		 * @param BPResponseDelegate	C + + based proxy interface .
+		 * @param URL					domain name .
+		 * @param Fields				Keys and values, they are escaped here.
+		 * @Return						Returns true if the request succeeds
+		 */
+		bool PostForm(const FSimpleHttpResponseDelegate &BPResponseDelegate, const FString &URL, const TMap<FString, FString> &Fields);
+
+		/**
+		 * Submit a multipart/form-data form to server.
+		 *
+		 * @param BPResponseDelegate	C + + based proxy interface .
+		 * @param URL					domain name .
+		 * @param Form					Fields, files and buffers, file parts are streamed from disk.
+		 * @Return						Returns true if the request succeeds
+		 */
+		bool PostMultipartForm(const FSimpleHttpResponseDelegate &BPResponseDelegate, const FString &URL, const SimpleHTTP::FSimpleHttpMultipartForm &Form);
+
 		/**
 		 * The data can be downloaded to local memory via the HTTP serverll .
 		 *
@@ -220,6 +301,26 @@ class SIMPLEHTTP_API FSimpleHttpManage
 		 */
 		bool GetObjectToLocal(const FSimpleHttpResponseDelegate &BPResponseDelegate, const FString &URL, const FString &SavePaths);
 
+		/**
+		 * Download a zip, tar or gzipped tar and extract it, the archive itself is never stored .
+		 *
+		 * @param BPResponseDelegate	C + + based proxy interface .
+		 * @param URL					domain name .
+		 * @param ExtractPaths			Directory the entries are extracted into .
+		 * @Return						Returns true if the request succeeds
+		 */
+		bool GetArchiveToLocal(const FSimpleHttpResponseDelegate &BPResponseDelegate, const FString &URL, const FString &ExtractPaths);
+
+		/**
+		 * Open a long-lived response, each event or received chunk goes to the stream agents while it is open .
+		 *
+		 * @param BPResponseDelegate	C + + based proxy interface .
+		 * @param URL					domain name .
+		 * @param bServerSentEvents		Parse text/event-stream events, otherwise chunks are delivered as received .
+		 * @Return						Returns true if the request succeeds. Before 5.2 the events arrive together once the response ends
+		 */
+		bool GetStream(const FSimpleHttpResponseDelegate &BPResponseDelegate, const FString &URL, bool bServerSentEvents = true);
+
 		/**
 		 * Download multiple data to local .
 		 *
@@ -249,6 +350,52 @@ class SIMPLEHTTP_API FSimpleHttpManage
 		 */
 		bool PutObjectsFromLocal(const FSimpleHttpResponseDelegate &BPResponseDelegate, const FString &URL, const FString &LocalPaths);
 
+		/**
+		 * Upload a whole directory as one tar in a single request, for folders of many small files .
+		 *
+		 * @param BPResponseDelegate	C + + based proxy interface .
+		 * @param URL					domain name .
+		 * @param LocalDirectory		Directory to pack, walked recursively .
+		 * @param bGzip					Deflate the tar, the files are read twice to measure it .
+		 * @Return						Returns true if the request succeeds
+		 */
+		bool PutDirectoryAsArchive(const FSimpleHttpResponseDelegate &BPResponseDelegate, const FString &URL, const FString &LocalDirectory, bool bGzip);
+
+		/**
+		 * Download a JSON object and decode it into Struct on a worker thread.
+		 * The result arrives through SimpleCompleteStructDelegate on the game thread, before the handle completes.
+		 * Struct must hold plain data only, object and soft references fail the decode.
+		 *
+		 * @param BPResponseDelegate	C + + based proxy interface .
+		 * @param URL					domain name .
+		 * @param Struct				Layout of the expected JSON object, or of an object whose only array takes a JSON array.
+		 * @Return						Returns true if the request succeeds
+		 */
+		bool GetObjectToStruct(const FSimpleHttpResponseDelegate &BPResponseDelegate, const FString &URL, const UScriptStruct *Struct);
+
+		template<typename StructType>
+		bool GetObjectToStruct(const FSimpleHttpResponseDelegate &BPResponseDelegate, const FString &URL)
+		{
+			return GetObjectToStruct(BPResponseDelegate, URL, StructType::StaticStruct());
+		}
+
+		/**
+		 * Submit a form and decode the JSON reply into Struct on a worker thread.
+		 *
+		 * @param BPResponseDelegate	C + + based proxy interface .
+		 * @param URL					domain name .
+		 * @param Fields				Keys and values, they are escaped here.
+		 * @param Struct				Layout of the expected JSON object, or of an object whose only array takes a JSON array.
+		 * @Return						Returns true if the request succeeds
+		 */
+		bool PostFormToStruct(const FSimpleHttpResponseDelegate &BPResponseDelegate, const FString &URL, const TMap<FString, FString> &Fields, const UScriptStruct *Struct);
+
+		template<typename StructType>
+		bool PostFormToStruct(const FSimpleHttpResponseDelegate &BPResponseDelegate, const FString &URL, const TMap<FString, FString> &Fields)
+		{
+			return PostFormToStruct(BPResponseDelegate, URL, Fields, StructType::StaticStruct());
+		}
+
 		/**
 		 * Can upload byte data .
 		 *
@@ -269,6 +416,16 @@ class SIMPLEHTTP_API FSimpleHttpManage
 		 */
 		bool PutObjectFromString(const FSimpleHttpResponseDelegate& BPResponseDelegate, const FString& URL, const FString& InBuffer);
 
+		/**
+		 * Upload a buffer shared by reference count, the request never copies it .
+		 *
+		 * @param BPResponseDelegate	C + + based proxy interface .
+		 * @param URL					domain name .
+		 * @param Buffer				Byte code data, kept alive until the request completes.
+		 * @Return						Returns true if the request succeeds
+		 */
+		bool PutObjectFromSharedBuffer(const FSimpleHttpResponseDelegate &BPResponseDelegate, const FString &URL, TSharedRef<const TArray<uint8>, ESPMode::ThreadSafe> Buffer);
+
 		/**
 		 * Stream data upload supported by UE4 .
 		 *
@@ -296,6 +453,26 @@ class SIMPLEHTTP_API FSimpleHttpManage
 		 */
 		void DeleteObjects(const FSimpleHttpResponseDelegate &BPResponseDelegate, const TArray<FString> &URL);
 
+		/**
+		 * Download into the prefetch cache at idle priority, for loading screens and menus .
+		 * The next GetObjectToMemory or GetObjectsToMemory call for the same URL is served from it while the body is fresh.
+		 * Prefetches wait while other requests run, see FSimpleHttpPrefetchCache.
+		 *
+		 * @param URL					Need domain name .
+		 */
+		void PrefetchObjects(const TArray<FString> &URL);
+
+		/*Drops the queued prefetches and cancels the running ones, what is already cached stays*/
+		void CancelPrefetch();
+
+		/**
+		 * Open connections to hosts before their first request, e.g. at startup .
+		 * Resolving, connecting and the TLS handshake are done ahead, see FSimpleHttpConnectionWarmer.
+		 *
+		 * @param URL					Any URL of each host, only scheme, host and port are used .
+		 */
+		void PrewarmConnections(const TArray<FString> &URL);
+
 	private:
 
 		/**
@@ -303,22 +480,14 @@ class SIMPLEHTTP_API FSimpleHttpManage
 		 *
 		 * @param return	Use handle find PRequest.
 		 */
-		FSimpleHTTPHandle RegisteredHttpRequest(EHTTPRequestType RequestType = EHTTPRequestType::SINGLE,
-			FSimpleHttpSingleRequestCompleteDelegate SimpleHttpRequestCompleteDelegate = FSimpleHttpSingleRequestCompleteDelegate(),
-			FSimpleHttpSingleRequestProgressDelegate	SimpleHttpRequestProgressDelegate = FSimpleHttpSingleRequestProgressDelegate(),
-			FSimpleHttpSingleRequestHeaderReceivedDelegate SimpleHttpRequestHeaderReceivedDelegate = FSimpleHttpSingleRequestHeaderReceivedDelegate(), 
-			FAllRequestCompleteDelegate AllRequestCompleteDelegate = FAllRequestCompleteDelegate());
+		FSimpleHTTPHandle RegisteredHttpRequest(EHTTPRequestType RequestType, const FSimpleHttpBpResponseDelegate &BPResponseDelegate);
 
 		/**
-		 * Register our agent BP for internal use .
+		 * Register our C++ agent for internal use .
 		 *
 		 * @param return	Use handle find PRequest.
 		 */
-		FSimpleHTTPHandle RegisteredHttpRequest(EHTTPRequestType RequestType = EHTTPRequestType::SINGLE,
-			FSimpleSingleCompleteDelegate SimpleHttpRequestCompleteDelegate = nullptr,
-			FSimpleSingleRequestProgressDelegate	SimpleHttpRequestProgressDelegate = nullptr,
-			FSimpleSingleRequestHeaderReceivedDelegate SimpleHttpRequestHeaderReceivedDelegate = nullptr,
-			FSimpleDelegate AllRequestCompleteDelegate = nullptr);
+		FSimpleHTTPHandle RegisteredHttpRequest(EHTTPRequestType RequestType, const FSimpleHttpResponseDelegate &BPResponseDelegate);
 
 		/** 
 		 * Refer to the previous API for internal use details only 
@@ -341,6 +510,20 @@ class SIMPLEHTTP_API FSimpleHttpManage
 		 */
 		bool GetObjectToLocal(const FSimpleHTTPHandle &Handle, const FString &URL, const FString &SavePaths);
 
+		/**
+		 * Refer to the previous API for internal use details only
+		 *
+		 * @param Handle	Easy to find requests .
+		 */
+		bool GetArchiveToLocal(const FSimpleHTTPHandle &Handle, const FString &URL, const FString &ExtractPaths);
+
+		/**
+		 * Refer to the previous API for internal use details only
+		 *
+		 * @param Handle	Easy to find requests .
+		 */
+		bool GetStream(const FSimpleHTTPHandle &Handle, const FString &URL, bool bServerSentEvents);
+
 		/**
 		 * Refer to the previous API for internal use details only
 		 *
@@ -361,6 +544,13 @@ class SIMPLEHTTP_API FSimpleHttpManage
 		 * @param Handle	Easy to find requests .
 		 */
 		bool PutObjectsFromLocal(const FSimpleHTTPHandle &Handle, const FString &URL, const FString &LocalPaths);
+
+		/**
+		 * Refer to the previous API for internal use details only
+		 *
+		 * @param Handle	Easy to find requests .
+		 */
+		bool PutDirectoryAsArchive(const FSimpleHTTPHandle &Handle, const FString &URL, const FString &LocalDirectory, bool bGzip);
 		
 		/**
 		 * Refer to the previous API for internal use details only
@@ -402,8 +592,30 @@ class SIMPLEHTTP_API FSimpleHttpManage
 		 *
 		 * @param Handle					It can be used to retrieve the corresponding request.
 		 * @param InURL						Address to visit.
+		 * @param FormBody					Encoded form body.
+		 */
+		bool PostRequest(const FSimpleHTTPHandle &Handle, const FString &URL, TArray<uint8> &&FormBody);
+
+		/**
+		 * Refer to the previous API for internal use details only
+		 *
+		 * @param Handle	Easy to find requests .
+		 */
+		bool GetObjectToStruct(const FSimpleHTTPHandle &Handle, const FString &URL, const UScriptStruct *Struct);
+
+		/**
+		 * Refer to the previous API for internal use details only
+		 *
+		 * @param Handle	Easy to find requests .
+		 */
+		bool PostFormToStruct(const FSimpleHTTPHandle &Handle, const FString &URL, TArray<uint8> &&FormBody, const UScriptStruct *Struct);
+
+		/**
+		 * Refer to the previous API for internal use details only
+		 *
+		 * @param Handle	Easy to find requests .
 		 */
-		bool PostRequest(const FSimpleHTTPHandle &Handle, const FString &URL);
+		bool PostMultipartForm(const FSimpleHTTPHandle &Handle, const FString &URL, const SimpleHTTP::FSimpleHttpMultipartForm &Form);
 
 	private:
 		/*You can find the corresponding request according to the handle  */
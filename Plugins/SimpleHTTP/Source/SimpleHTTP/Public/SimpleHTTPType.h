@@ -1,6 +1,8 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "Core/SimpleHttpResponseView.h"
+#include "UObject/StructOnScope.h"
 #include "SimpleHTTPType.generated.h"
 
 UCLASS(BlueprintType)
@@ -9,10 +11,12 @@ class SIMPLEHTTP_API USimpleHttpContent :public UObject
 	GENERATED_BODY()
 
 public:
-	TArray<uint8> *Content;
+	/*Shared with the engine response, the body is never copied into the object*/
+	TSharedPtr<const TArray<uint8>, ESPMode::ThreadSafe> Content;
 
+	/*Read only, the buffer belongs to the engine response. Empty when the request got no response*/
 	UFUNCTION(BlueprintPure, Category = "SimpleHTTP|HttpContent")
-	TArray<uint8> &GetContent();
+	const TArray<uint8> &GetContent() const;
 
 	UFUNCTION(BlueprintCallable, Category = "SimpleHTTP|HttpContent")
 	bool Save(const FString &LocalPath);
@@ -32,6 +36,9 @@ enum class ESimpleHttpStarte :uint8
 	Failed,
 	Failed_ConnectionError,
 	Succeeded,
+
+	//Not an engine status, the body arrived but did not match ExpectedContents or its hash headers
+	Failed_Integrity,
 };
 
 USTRUCT(BlueprintType)
@@ -85,7 +92,7 @@ struct SIMPLEHTTP_API FSimpleHttpResponse :public FSimpleHttpBase
 	FSimpleHttpResponse()
 		:Super()
 		,ResponseCode(INDEX_NONE)
-		,Content(NewObject<USimpleHttpContent>())
+		,Content(nullptr)
 	{}
 
 	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, Category = "SimpleHttpBase|SimpleHttpResponse")
@@ -98,16 +105,277 @@ struct SIMPLEHTTP_API FSimpleHttpResponse :public FSimpleHttpBase
 	TObjectPtr<USimpleHttpContent> Content;
 };
 
+/*What a downloaded file must be before it is written, see FSimpleHttpRequestOptions::ExpectedContents*/
+USTRUCT(BlueprintType)
+struct SIMPLEHTTP_API FSimpleHttpExpectedContent
+{
+	GENERATED_USTRUCT_BODY()
+
+	FSimpleHttpExpectedContent()
+		:Size(0)
+	{}
+
+	/*"md5:", "sha1:", "blake3:" or "xxhash64:" followed by the hex digest. Empty skips the hash.*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SimpleHttpBase|ExpectedContent")
+	FString Hash;
+
+	/*Body size in bytes. 0 skips the size.*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SimpleHttpBase|ExpectedContent", meta = (ClampMin = "0"))
+	int64 Size;
+};
+
+USTRUCT(BlueprintType)
+struct SIMPLEHTTP_API FSimpleHttpRequestOptions
+{
+	GENERATED_USTRUCT_BODY()
+
+	FSimpleHttpRequestOptions()
+		:MaxProgressEventsPerSecond(0.f)
+		,ProgressByteInterval(0)
+		,MaxBatchSize(100)
+		,MaxConnectionsPerHost(0)
+		,UploadPipelineDepth(64)
+		,bAggregateResults(false)
+		,ResultChunkSize(0)
+		,bKeepResultBodies(false)
+		,bInteractive(false)
+		,bVerifyHashHeaders(false)
+		,bMountPaks(false)
+		,PakMountOrder(4)
+		,StreamBufferBytes(1024 * 1024)
+	{}
+
+	/*Progress of each request is delivered at most this many times per second, the end of a transfer always is. 0 delivers every event.*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SimpleHttpBase|RequestOptions")
+	float MaxProgressEventsPerSecond;
+
+	/*Progress is delivered again only after this many more bytes have moved. 0 delivers every event.*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SimpleHttpBase|RequestOptions")
+	int64 ProgressByteInterval;
+
+	/*Only these response headers are delivered. Empty delivers every header.*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SimpleHttpBase|RequestOptions")
+	TArray<FString> HeaderFilter;
+
+	/*Multiple deletes and in-memory gets are packed into POSTs to this endpoint. Empty sends one request per URL.*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SimpleHttpBase|RequestOptions")
+	FString BatchEndpoint;
+
+	/*Most operations packed into one batch request.*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SimpleHttpBase|RequestOptions", meta = (ClampMin = "1"))
+	int32 MaxBatchSize;
+
+	/*Requests of a multiple request running against one host at once, the rest queue and reuse the kept-alive connections. 0 starts them all.*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SimpleHttpBase|RequestOptions", meta = (ClampMin = "0"))
+	int32 MaxConnectionsPerHost;
+
+	/*Uploads of a folder kept in flight while the folder is still being scanned, the scan waits for them beyond this.*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SimpleHttpBase|RequestOptions", meta = (ClampMin = "1"))
+	int32 UploadPipelineDepth;
+
+	/*Results are gathered into FSimpleHttpResultRecord arrays for the result batch agents, the per request completion agents are not fired.*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SimpleHttpBase|RequestOptions")
+	bool bAggregateResults;
+
+	/*Records per aggregated delivery. 0 delivers them all at once when the handle completes.*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SimpleHttpBase|RequestOptions", meta = (ClampMin = "0", EditCondition = "bAggregateResults"))
+	int32 ResultChunkSize;
+
+	/*Records keep their response and its body until they are delivered. Off, a record is only code, length, URL and error, and bodies are released as each operation completes.*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SimpleHttpBase|RequestOptions", meta = (EditCondition = "bAggregateResults"))
+	bool bKeepResultBodies;
+
+	/*Someone is waiting on this handle, it is never held back by SimpleHTTP.FrameBudgetMs.*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SimpleHttpBase|RequestOptions")
+	bool bInteractive;
+
+	/*Downloads to local of these URLs are checked before their file is written, a mismatch fails the request with Failed_Integrity and writes nothing.*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SimpleHttpBase|RequestOptions")
+	TMap<FString, FSimpleHttpExpectedContent> ExpectedContents;
+
+	/*Downloads to local are also checked against a Content-MD5 or Digest header when the server sends one.*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SimpleHttpBase|RequestOptions")
+	bool bVerifyHashHeaders;
+
+	/*Downloaded .pak containers are checked and mounted as soon as each one is on disk, with its .utoc and .ucas when those are downloaded too.*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SimpleHttpBase|RequestOptions")
+	bool bMountPaks;
+
+	/*Mounted containers with a higher order win. Project paks mount at 4, patches usually well above.*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SimpleHttpBase|RequestOptions", meta = (EditCondition = "bMountPaks"))
+	int32 PakMountOrder;
+
+	/*Stream events received but not yet delivered are kept up to this many bytes, beyond it the oldest are dropped.*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SimpleHttpBase|RequestOptions", meta = (ClampMin = "1024"))
+	int64 StreamBufferBytes;
+};
+
+USTRUCT(BlueprintType)
+struct SIMPLEHTTP_API FSimpleHttpProgressEvent
+{
+	GENERATED_USTRUCT_BODY()
+
+	FSimpleHttpProgressEvent()
+		:BytesToSend(0)
+		,BytesSent(0)
+		,BytesReceived(0)
+	{}
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "SimpleHttpBase|ProgressEvent")
+	FName Handle;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "SimpleHttpBase|ProgressEvent")
+	int64 BytesToSend;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "SimpleHttpBase|ProgressEvent")
+	int64 BytesSent;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "SimpleHttpBase|ProgressEvent")
+	int64 BytesReceived;
+};
+
+USTRUCT(BlueprintType)
+struct SIMPLEHTTP_API FSimpleHttpHeaderEvent
+{
+	GENERATED_USTRUCT_BODY()
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "SimpleHttpBase|HeaderEvent")
+	FName Handle;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "SimpleHttpBase|HeaderEvent")
+	FString HeaderName;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "SimpleHttpBase|HeaderEvent")
+	FString HeaderValue;
+};
+
+/*One finished operation of an aggregated handle, see FSimpleHttpRequestOptions::bAggregateResults*/
+USTRUCT(BlueprintType)
+struct SIMPLEHTTP_API FSimpleHttpResultRecord
+{
+	GENERATED_USTRUCT_BODY()
+
+	FSimpleHttpResultRecord()
+		:ResponseCode(0)
+		,ContentLength(0)
+		,ElapsedTime(0.f)
+		,bSucceeded(false)
+	{}
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "SimpleHttpBase|ResultRecord")
+	FString URL;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "SimpleHttpBase|ResultRecord")
+	int32 ResponseCode;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "SimpleHttpBase|ResultRecord")
+	int64 ContentLength;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "SimpleHttpBase|ResultRecord")
+	float ElapsedTime;
+
+	/*Connected and answered with a 2xx code*/
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "SimpleHttpBase|ResultRecord")
+	bool bSucceeded;
+
+	/*Why the operation failed, empty when it succeeded*/
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "SimpleHttpBase|ResultRecord")
+	FString Error;
+
+	/*Only with FSimpleHttpRequestOptions::bKeepResultBodies and only made for blueprint agents, shares the body with the response*/
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "SimpleHttpBase|ResultRecord")
+	TObjectPtr<USimpleHttpContent> Content;
+
+	/*Only with FSimpleHttpRequestOptions::bKeepResultBodies, C++ reads the response through the view*/
+	FSimpleHttpResponseView Response;
+};
+
+/*One downloaded container of a handle is ready or has failed, see FSimpleHttpRequestOptions::bMountPaks*/
+USTRUCT(BlueprintType)
+struct SIMPLEHTTP_API FSimpleHttpPakMountEvent
+{
+	GENERATED_USTRUCT_BODY()
+
+	FSimpleHttpPakMountEvent()
+		:bMounted(false)
+	{}
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "SimpleHttpBase|PakMountEvent")
+	FName Handle;
+
+	/*Local path of the .pak*/
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "SimpleHttpBase|PakMountEvent")
+	FString PakFile;
+
+	/*Its content can be loaded from now on*/
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "SimpleHttpBase|PakMountEvent")
+	bool bMounted;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "SimpleHttpBase|PakMountEvent")
+	FString Error;
+};
+
+/*A server-sent event or a received chunk of an open stream, see GetStream*/
+USTRUCT(BlueprintType)
+struct SIMPLEHTTP_API FSimpleHttpStreamEvent
+{
+	GENERATED_USTRUCT_BODY()
+
+	FSimpleHttpStreamEvent()
+		:Dropped(0)
+	{}
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "SimpleHttpBase|StreamEvent")
+	FName Handle;
+
+	/*Event type, "message" when the server names none. Empty for chunks.*/
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "SimpleHttpBase|StreamEvent")
+	FString Event;
+
+	/*Last event id the server sent*/
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "SimpleHttpBase|StreamEvent")
+	FString Id;
+
+	/*Data lines of the event joined by line breaks*/
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "SimpleHttpBase|StreamEvent")
+	FString Data;
+
+	/*Bytes as received when the stream is not read as server-sent events*/
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "SimpleHttpBase|StreamEvent")
+	TArray<uint8> Chunk;
+
+	/*Events lost right before this one because they were not delivered in time, see StreamBufferBytes*/
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "SimpleHttpBase|StreamEvent")
+	int32 Dropped;
+};
+
 //BP
 DECLARE_DYNAMIC_DELEGATE_ThreeParams(FSimpleHttpSingleRequestCompleteDelegate,const FSimpleHttpRequest ,Request,const FSimpleHttpResponse , Response,bool ,bConnectedSuccessfully);
 DECLARE_DYNAMIC_DELEGATE_ThreeParams(FSimpleHttpSingleRequestProgressDelegate,const FSimpleHttpRequest , Request, int64, BytesSent, int64, BytesReceived);
 DECLARE_DYNAMIC_DELEGATE_ThreeParams(FSimpleHttpSingleRequestHeaderReceivedDelegate, const FSimpleHttpRequest , Request, const FString , HeaderName, const FString , NewHeaderValue);
 DECLARE_DYNAMIC_DELEGATE(FAllRequestCompleteDelegate);
+DECLARE_DYNAMIC_DELEGATE_OneParam(FSimpleHttpProgressEventDelegate, const FSimpleHttpProgressEvent &, Event);
+DECLARE_DYNAMIC_DELEGATE_OneParam(FSimpleHttpHeaderEventDelegate, const FSimpleHttpHeaderEvent &, Event);
+DECLARE_DYNAMIC_DELEGATE_OneParam(FSimpleHttpResultBatchDelegate, const TArray<FSimpleHttpResultRecord> &, Results);
+DECLARE_DYNAMIC_DELEGATE_OneParam(FSimpleHttpPakMountDelegate, const FSimpleHttpPakMountEvent &, Event);
+DECLARE_DYNAMIC_DELEGATE_OneParam(FSimpleHttpStreamEventDelegate, const FSimpleHttpStreamEvent &, Event);
 
 //C++
 DECLARE_DELEGATE_ThreeParams(FSimpleSingleCompleteDelegate, const FSimpleHttpRequest &, const FSimpleHttpResponse &, bool);
 DECLARE_DELEGATE_ThreeParams(FSimpleSingleRequestProgressDelegate, const FSimpleHttpRequest &, int64, int64);
 DECLARE_DELEGATE_ThreeParams(FSimpleSingleRequestHeaderReceivedDelegate, const FSimpleHttpRequest &, const FString &, const FString &);
+DECLARE_DELEGATE_OneParam(FSimpleProgressEventDelegate, const FSimpleHttpProgressEvent &);
+DECLARE_DELEGATE_OneParam(FSimpleHeaderEventDelegate, const FSimpleHttpHeaderEvent &);
+DECLARE_DELEGATE_OneParam(FSimpleResultBatchDelegate, const TArray<FSimpleHttpResultRecord> &);
+DECLARE_DELEGATE_OneParam(FSimplePakMountDelegate, const FSimpleHttpPakMountEvent &);
+DECLARE_DELEGATE_OneParam(FSimpleStreamEventDelegate, const FSimpleHttpStreamEvent &);
+
+//C++ only, the response is handed over as a view and is never decoded unless asked for
+DECLARE_DELEGATE_ThreeParams(FSimpleSingleCompleteViewDelegate, const FSimpleHttpRequest &, const FSimpleHttpResponseView &, bool);
+
+//C++ only, fired on the game thread once the body has been decoded into the requested struct on a worker thread.
+//The struct is null when the request failed or the body did not match.
+DECLARE_DELEGATE_FourParams(FSimpleSingleCompleteStructDelegate, const FSimpleHttpRequest &, const FSimpleHttpResponseView &, TSharedPtr<FStructOnScope, ESPMode::ThreadSafe>, bool);
 
 USTRUCT(BlueprintType)
 struct SIMPLEHTTP_API FSimpleHttpBpResponseDelegate
@@ -125,12 +393,38 @@ struct SIMPLEHTTP_API FSimpleHttpBpResponseDelegate
 
 	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, Category = "SimpleHTTP|HTTPResponseDelegate")
 	FAllRequestCompleteDelegate							AllRequestCompleteDelegate;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, Category = "SimpleHTTP|HTTPResponseDelegate")
+	FSimpleHttpProgressEventDelegate					SimpleHttpProgressEventDelegate;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, Category = "SimpleHTTP|HTTPResponseDelegate")
+	FSimpleHttpHeaderEventDelegate						SimpleHttpHeaderEventDelegate;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, Category = "SimpleHTTP|HTTPResponseDelegate")
+	FSimpleHttpResultBatchDelegate						SimpleHttpResultBatchDelegate;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, Category = "SimpleHTTP|HTTPResponseDelegate")
+	FSimpleHttpPakMountDelegate							SimpleHttpPakMountDelegate;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, Category = "SimpleHTTP|HTTPResponseDelegate")
+	FSimpleHttpStreamEventDelegate						SimpleHttpStreamEventDelegate;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SimpleHTTP|HTTPResponseDelegate")
+	FSimpleHttpRequestOptions							RequestOptions;
 };
 
 struct SIMPLEHTTP_API FSimpleHttpResponseDelegate
 {
 	FSimpleSingleCompleteDelegate						SimpleCompleteDelegate;
+	FSimpleSingleCompleteViewDelegate					SimpleCompleteViewDelegate;
+	FSimpleSingleCompleteStructDelegate					SimpleCompleteStructDelegate;
 	FSimpleSingleRequestProgressDelegate				SimpleSingleRequestProgressDelegate;
 	FSimpleSingleRequestHeaderReceivedDelegate			SimpleSingleRequestHeaderReceivedDelegate;
 	FSimpleDelegate										AllTasksCompletedDelegate;
+	FSimpleProgressEventDelegate						SimpleProgressEventDelegate;
+	FSimpleHeaderEventDelegate							SimpleHeaderEventDelegate;
+	FSimpleResultBatchDelegate							SimpleResultBatchDelegate;
+	FSimplePakMountDelegate								SimplePakMountDelegate;
+	FSimpleStreamEventDelegate							SimpleStreamEventDelegate;
+	FSimpleHttpRequestOptions							RequestOptions;
 };
\ No newline at end of file
@@ -51,6 +51,8 @@ public class SimpleHTTP : ModuleRules
 			new string[]
             {
                 "CoreUObject",
+                "Json",
+                "JsonUtilities",
 				// ... add private dependencies that you statically link with here ...	
 			}
 			);
@@ -65,6 +67,9 @@ public class SimpleHTTP : ModuleRules
             });
         }
 
+        //Deflates directory uploads while they are sent, FCompression only works on whole buffers
+        AddEngineThirdPartyPrivateStaticDependencies(Target, "zlib");
+
         DynamicallyLoadedModuleNames.AddRange(
 			new string[]
 			{
@@ -0,0 +1,4 @@
+// Copyright (C) RenZhai.2020.All Rights Reserved.
+#include "Modules/ModuleManager.h"
+
+IMPLEMENT_MODULE(FDefaultModuleImpl, SimpleHTTPLoadTest)
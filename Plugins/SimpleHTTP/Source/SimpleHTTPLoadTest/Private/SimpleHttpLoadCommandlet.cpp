@@ -0,0 +1,423 @@
+// Copyright (C) RenZhai.2020.All Rights Reserved.
+#include "SimpleHttpLoadCommandlet.h"
+#include "SimpleHTTPManage.h"
+#include "Core/SimpleHttpStats.h"
+#include "Tests/SimpleHttpLoopbackServer.h"
+#include "Interfaces/IHttpResponse.h"
+#include "Dom/JsonObject.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonWriter.h"
+#include "Serialization/JsonSerializer.h"
+#include "Containers/Ticker.h"
+#include "Math/RandomStream.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "HAL/PlatformMemory.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogSimpleHttpLoad, Log, All);
+
+namespace SimpleHTTP
+{
+	namespace LoadTest
+	{
+		/*Requests still out when the duration ends get this long to come back*/
+		static const double DrainSeconds = 30.0;
+
+		struct FMixEntry
+		{
+			FMixEntry()
+				:Weight(1.f)
+			{}
+
+			FString Verb;
+			FString Path;
+			float Weight;
+
+			/*Sent by POST and PUT*/
+			FString Body;
+			TSharedPtr<const TArray<uint8>, ESPMode::ThreadSafe> BodyBytes;
+
+			FString GetName() const { return Verb + TEXT(" ") + Path; }
+		};
+
+		struct FState
+		{
+			FState()
+				:TotalWeight(0.f)
+				,Sent(0)
+				,Succeeded(0)
+				,Failed(0)
+				,InFlight(0)
+				,Random(FPlatformTime::Cycles())
+			{}
+
+			TArray<FMixEntry> Mix;
+			float TotalWeight;
+			FString BaseURL;
+
+			/*A user has one request out at a time, the id tells a late second completion from the current one*/
+			TArray<uint64> UserRequestIds;
+			TArray<bool> UserBusy;
+
+			uint64 Sent;
+			uint64 Succeeded;
+			uint64 Failed;
+			int32 InFlight;
+
+			FSimpleHttpLatencyHistogram Latency;
+			TArray<FSimpleHttpLatencyHistogram> EntryLatencies;
+
+			FRandomStream Random;
+		};
+
+		static TArray<FMixEntry> GetDefaultMix()
+		{
+			TArray<FMixEntry> Mix;
+
+			auto Add = [&Mix](const TCHAR *Verb, const TCHAR *Path, float Weight, int32 BodySize)
+			{
+				FMixEntry &Entry = Mix.AddDefaulted_GetRef();
+				Entry.Verb = Verb;
+				Entry.Path = Path;
+				Entry.Weight = Weight;
+				Entry.Body = FString::ChrN(BodySize, TEXT('x'));
+			};
+
+			Add(TEXT("GET"), TEXT("/bytes/1024/small"), 6.f, 0);
+			Add(TEXT("GET"), TEXT("/bytes/262144/medium"), 2.f, 0);
+			Add(TEXT("GET"), TEXT("/delay/20"), 2.f, 0);
+			Add(TEXT("POST"), TEXT("/echo"), 1.f, 512);
+			Add(TEXT("PUT"), TEXT("/upload/load"), 1.f, 64 * 1024);
+
+			return Mix;
+		}
+
+		static bool LoadScript(const FString &Filename, TArray<FMixEntry> &OutMix)
+		{
+			FString Json;
+			if (!FFileHelper::LoadFileToString(Json, *Filename))
+			{
+				UE_LOG(LogSimpleHttpLoad, Error, TEXT("Could not read script %s."), *Filename);
+				return false;
+			}
+
+			TSharedPtr<FJsonObject> JsonObject;
+			const TArray<TSharedPtr<FJsonValue>>* Requests = nullptr;
+			if (!FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(Json), JsonObject) || !JsonObject.IsValid() ||
+				!JsonObject->TryGetArrayField(TEXT("requests"), Requests))
+			{
+				UE_LOG(LogSimpleHttpLoad, Error, TEXT("Script %s has no requests array."), *Filename);
+				return false;
+			}
+
+			for (const auto &Tmp : *Requests)
+			{
+				const TSharedPtr<FJsonObject>* Request = nullptr;
+				if (!Tmp->TryGetObject(Request))
+				{
+					continue;
+				}
+
+				FMixEntry &Entry = OutMix.AddDefaulted_GetRef();
+				Entry.Verb = (*Request)->GetStringField(TEXT("verb")).ToUpper();
+				Entry.Path = (*Request)->GetStringField(TEXT("path"));
+				(*Request)->TryGetStringField(TEXT("body"), Entry.Body);
+
+				double Weight = 1.0;
+				(*Request)->TryGetNumberField(TEXT("weight"), Weight);
+				Entry.Weight = FMath::Max((float)Weight, 0.f);
+			}
+
+			return OutMix.Num() > 0;
+		}
+
+		static int32 PickEntry(FState &State)
+		{
+			float Pick = State.Random.FRandRange(0.f, State.TotalWeight);
+			for (int32 i = 0; i < State.Mix.Num(); ++i)
+			{
+				Pick -= State.Mix[i].Weight;
+				if (Pick <= 0.f)
+				{
+					return i;
+				}
+			}
+
+			return State.Mix.Num() - 1;
+		}
+
+		static void Complete(const TSharedRef<FState> &State, int32 User, uint64 RequestId, int32 EntryIndex, double IssueTime, bool bSucceeded)
+		{
+			if (!State->UserBusy[User] || State->UserRequestIds[User] != RequestId)
+			{
+				return;
+			}
+
+			State->UserBusy[User] = false;
+			State->InFlight--;
+
+			const double Latency = FPlatformTime::Seconds() - IssueTime;
+			State->Latency.Add(Latency);
+			State->EntryLatencies[EntryIndex].Add(Latency);
+
+			bSucceeded ? ++State->Succeeded : ++State->Failed;
+		}
+
+		static void Issue(const TSharedRef<FState> &State, int32 User)
+		{
+			const int32 EntryIndex = PickEntry(*State);
+			const FMixEntry &Entry = State->Mix[EntryIndex];
+			const FString URL = State->BaseURL + Entry.Path;
+
+			const uint64 RequestId = ++State->UserRequestIds[User];
+			const double IssueTime = FPlatformTime::Seconds();
+
+			State->UserBusy[User] = true;
+			State->InFlight++;
+			State->Sent++;
+
+			FSimpleHttpResponseDelegate Delegate;
+			Delegate.SimpleCompleteViewDelegate.BindLambda([State, User, RequestId, EntryIndex, IssueTime](const FSimpleHttpRequest &Request, const FSimpleHttpResponseView &Response, bool bConnectedSuccessfully)
+			{
+				Complete(State, User, RequestId, EntryIndex, IssueTime, bConnectedSuccessfully && EHttpResponseCodes::IsOk(Response.GetResponseCode()));
+			});
+
+			bool bStarted = false;
+			if (Entry.Verb == TEXT("GET"))
+			{
+				bStarted = SIMPLE_HTTP.GetObjectToMemory(Delegate, URL);
+			}
+			else if (Entry.Verb == TEXT("POST"))
+			{
+				bStarted = SIMPLE_HTTP.PostRequest(*URL, *Entry.Body, Delegate);
+			}
+			else if (Entry.Verb == TEXT("PUT"))
+			{
+				bStarted = SIMPLE_HTTP.PutObjectFromSharedBuffer(Delegate, URL, Entry.BodyBytes.ToSharedRef());
+			}
+			else if (Entry.Verb == TEXT("DELETE"))
+			{
+				bStarted = SIMPLE_HTTP.DeleteObject(Delegate, URL);
+			}
+
+			if (!bStarted)
+			{
+				Complete(State, User, RequestId, EntryIndex, IssueTime, false);
+			}
+		}
+
+		static TSharedRef<FJsonObject> LatencyToJson(const FSimpleHttpLatencyHistogram &Latency)
+		{
+			TSharedRef<FJsonObject> JsonObject = MakeShared<FJsonObject>();
+			JsonObject->SetNumberField(TEXT("count"), (double)Latency.Num());
+			JsonObject->SetNumberField(TEXT("p50"), Latency.GetPercentile(50.0) * 1000.0);
+			JsonObject->SetNumberField(TEXT("p90"), Latency.GetPercentile(90.0) * 1000.0);
+			JsonObject->SetNumberField(TEXT("p95"), Latency.GetPercentile(95.0) * 1000.0);
+			JsonObject->SetNumberField(TEXT("p99"), Latency.GetPercentile(99.0) * 1000.0);
+			JsonObject->SetNumberField(TEXT("p999"), Latency.GetPercentile(99.9) * 1000.0);
+			JsonObject->SetNumberField(TEXT("max"), Latency.GetMax() * 1000.0);
+			JsonObject->SetNumberField(TEXT("mean"), Latency.GetMean() * 1000.0);
+
+			return JsonObject;
+		}
+	}
+}
+
+USimpleHttpLoadCommandlet::USimpleHttpLoadCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = false;
+	LogToConsole = true;
+
+	HelpDescription = TEXT("Drives virtual users through SimpleHTTP and reports throughput, errors, latency percentiles and memory growth.");
+	HelpUsage = TEXT("-run=SimpleHttpLoad [-Users=16] [-Rate=100] [-Duration=30] [-URL=http://host:port] [-Port=8978] [-Script=Mix.json] [-Report=Result.json] [-MaxErrorRate=0.0]");
+}
+
+int32 USimpleHttpLoadCommandlet::Main(const FString &Params)
+{
+	using namespace SimpleHTTP::LoadTest;
+
+	int32 Users = 16;
+	float Rate = 100.f;
+	float Duration = 30.f;
+	float MaxErrorRate = 0.f;
+	uint32 Port = 8978;
+	FString ScriptFilename;
+	FString ReportFilename = FPaths::ProjectSavedDir() / TEXT("SimpleHTTP/LoadTest.json");
+
+	FParse::Value(*Params, TEXT("Users="), Users);
+	FParse::Value(*Params, TEXT("Rate="), Rate);
+	FParse::Value(*Params, TEXT("Duration="), Duration);
+	FParse::Value(*Params, TEXT("MaxErrorRate="), MaxErrorRate);
+	FParse::Value(*Params, TEXT("Port="), Port);
+	FParse::Value(*Params, TEXT("Script="), ScriptFilename);
+	FParse::Value(*Params, TEXT("Report="), ReportFilename);
+
+	Users = FMath::Max(Users, 1);
+
+	TSharedRef<FState> State = MakeShared<FState>();
+	State->UserBusy.Init(false, Users);
+	State->UserRequestIds.Init(0, Users);
+
+	if (ScriptFilename.IsEmpty())
+	{
+		State->Mix = GetDefaultMix();
+	}
+	else if (!LoadScript(ScriptFilename, State->Mix))
+	{
+		return 1;
+	}
+
+	for (auto &Tmp : State->Mix)
+	{
+		State->TotalWeight += Tmp.Weight;
+
+		FTCHARToUTF8 UTF8Converter(*Tmp.Body);
+		Tmp.BodyBytes = MakeShared<TArray<uint8>, ESPMode::ThreadSafe>((const uint8*)UTF8Converter.Get(), UTF8Converter.Length());
+	}
+	State->EntryLatencies.SetNum(State->Mix.Num());
+
+	if (State->TotalWeight <= 0.f)
+	{
+		UE_LOG(LogSimpleHttpLoad, Error, TEXT("The request mix has no weight."));
+		return 1;
+	}
+
+#if WITH_SIMPLEHTTP_LOOPBACK_SERVER
+	TSharedPtr<SimpleHTTP::FSimpleHttpLoopbackServer> Server;
+#endif
+	if (!FParse::Value(*Params, TEXT("URL="), State->BaseURL))
+	{
+#if WITH_SIMPLEHTTP_LOOPBACK_SERVER
+		Server = SimpleHTTP::FSimpleHttpLoopbackServer::Start(Port);
+		if (!Server.IsValid())
+		{
+			return 1;
+		}
+
+		State->BaseURL = Server->GetURL(FString());
+#else
+		UE_LOG(LogSimpleHttpLoad, Error, TEXT("-URL= is required, this build has no loopback server."));
+		return 1;
+#endif
+	}
+	State->BaseURL.RemoveFromEnd(TEXT("/"));
+
+	UE_LOG(LogSimpleHttpLoad, Display, TEXT("%d users, %.1f requests/s, %.1fs against %s."), Users, Rate, Duration, *State->BaseURL);
+
+	const uint64 StartMemory = FPlatformMemory::GetStats().UsedPhysical;
+	uint64 PeakMemory = StartMemory;
+
+	const double StartTime = FPlatformTime::Seconds();
+	double LastTime = StartTime;
+	double LastReportTime = StartTime;
+	double Tokens = 0.0;
+	double EndTime = StartTime;
+
+	while (true)
+	{
+		const double CurrentTime = FPlatformTime::Seconds();
+		const float DeltaTime = (float)(CurrentTime - LastTime);
+		LastTime = CurrentTime;
+
+		if (CurrentTime - StartTime < Duration)
+		{
+			//Token bucket, at most one second of burst
+			if (Rate > 0.f)
+			{
+				Tokens = FMath::Min(Tokens + Rate * DeltaTime, (double)FMath::Max(Rate, 1.f));
+			}
+
+			for (int32 i = 0; i < Users && (Rate <= 0.f || Tokens >= 1.0); ++i)
+			{
+				if (!State->UserBusy[i])
+				{
+					Issue(State, i);
+					Tokens -= 1.0;
+				}
+			}
+
+			EndTime = CurrentTime;
+		}
+		else if (State->InFlight == 0 || CurrentTime - StartTime > Duration + DrainSeconds)
+		{
+			break;
+		}
+
+		FTSTicker::GetCoreTicker().Tick(DeltaTime);
+		FSimpleHttpManage::Get()->Tick(DeltaTime);
+
+		if (CurrentTime - LastReportTime >= 1.0)
+		{
+			LastReportTime = CurrentTime;
+			PeakMemory = FMath::Max(PeakMemory, FPlatformMemory::GetStats().UsedPhysical);
+
+			UE_LOG(LogSimpleHttpLoad, Display, TEXT("%.0fs: %llu sent, %llu ok, %llu failed, %d in flight."),
+				CurrentTime - StartTime, State->Sent, State->Succeeded, State->Failed, State->InFlight);
+		}
+
+		FPlatformProcess::Sleep(0.001f);
+	}
+
+	if (State->InFlight > 0)
+	{
+		UE_LOG(LogSimpleHttpLoad, Warning, TEXT("%d requests did not come back within %.0fs, they count as failed."), State->InFlight, DrainSeconds);
+		State->Failed += State->InFlight;
+		SIMPLE_HTTP.Cancel();
+	}
+
+	const uint64 EndMemory = FPlatformMemory::GetStats().UsedPhysical;
+	PeakMemory = FMath::Max(PeakMemory, EndMemory);
+
+	const double Seconds = FMath::Max(EndTime - StartTime, SMALL_NUMBER);
+	const uint64 Finished = State->Succeeded + State->Failed;
+	const double ErrorRate = Finished ? (double)State->Failed / Finished : 1.0;
+	const double MB = 1024.0 * 1024.0;
+
+	UE_LOG(LogSimpleHttpLoad, Display, TEXT("Throughput %.1f requests/s, %llu ok, %llu failed, error rate %.2f%%."), Finished / Seconds, State->Succeeded, State->Failed, ErrorRate * 100.0);
+	UE_LOG(LogSimpleHttpLoad, Display, TEXT("Latency p50 %.2fms p90 %.2fms p95 %.2fms p99 %.2fms p99.9 %.2fms max %.2fms."),
+		State->Latency.GetPercentile(50.0) * 1000.0, State->Latency.GetPercentile(90.0) * 1000.0, State->Latency.GetPercentile(95.0) * 1000.0,
+		State->Latency.GetPercentile(99.0) * 1000.0, State->Latency.GetPercentile(99.9) * 1000.0, State->Latency.GetMax() * 1000.0);
+	UE_LOG(LogSimpleHttpLoad, Display, TEXT("Memory %.1fMB at start, %.1fMB at end, %.1fMB peak, %+.1fMB growth."),
+		StartMemory / MB, EndMemory / MB, PeakMemory / MB, ((double)EndMemory - (double)StartMemory) / MB);
+
+	TSharedRef<FJsonObject> Memory = MakeShared<FJsonObject>();
+	Memory->SetNumberField(TEXT("startMB"), StartMemory / MB);
+	Memory->SetNumberField(TEXT("endMB"), EndMemory / MB);
+	Memory->SetNumberField(TEXT("peakMB"), PeakMemory / MB);
+	Memory->SetNumberField(TEXT("growthMB"), ((double)EndMemory - (double)StartMemory) / MB);
+
+	TArray<TSharedPtr<FJsonValue>> Endpoints;
+	for (int32 i = 0; i < State->Mix.Num(); ++i)
+	{
+		TSharedRef<FJsonObject> Endpoint = LatencyToJson(State->EntryLatencies[i]);
+		Endpoint->SetStringField(TEXT("name"), State->Mix[i].GetName());
+		Endpoints.Add(MakeShared<FJsonValueObject>(Endpoint));
+
+		UE_LOG(LogSimpleHttpLoad, Display, TEXT("  %-32s %8llu  p50 %8.2fms  p99 %8.2fms"),
+			*State->Mix[i].GetName(), State->EntryLatencies[i].Num(), State->EntryLatencies[i].GetPercentile(50.0) * 1000.0, State->EntryLatencies[i].GetPercentile(99.0) * 1000.0);
+	}
+
+	TSharedRef<FJsonObject> Report = MakeShared<FJsonObject>();
+	Report->SetNumberField(TEXT("users"), Users);
+	Report->SetNumberField(TEXT("targetRate"), Rate);
+	Report->SetNumberField(TEXT("seconds"), Seconds);
+	Report->SetNumberField(TEXT("sent"), (double)State->Sent);
+	Report->SetNumberField(TEXT("succeeded"), (double)State->Succeeded);
+	Report->SetNumberField(TEXT("failed"), (double)State->Failed);
+	Report->SetNumberField(TEXT("throughput"), Finished / Seconds);
+	Report->SetNumberField(TEXT("errorRate"), ErrorRate);
+	Report->SetObjectField(TEXT("latencyMs"), LatencyToJson(State->Latency));
+	Report->SetArrayField(TEXT("endpoints"), Endpoints);
+	Report->SetObjectField(TEXT("memory"), Memory);
+
+	FString ReportJson;
+	FJsonSerializer::Serialize(Report, TJsonWriterFactory<>::Create(&ReportJson));
+	if (FFileHelper::SaveStringToFile(ReportJson, *ReportFilename))
+	{
+		UE_LOG(LogSimpleHttpLoad, Display, TEXT("Report written to %s."), *ReportFilename);
+	}
+
+	return ErrorRate > MaxErrorRate ? 1 : 0;
+}
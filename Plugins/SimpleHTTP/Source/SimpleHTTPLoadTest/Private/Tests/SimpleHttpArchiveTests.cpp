@@ -0,0 +1,373 @@
+// Copyright (C) RenZhai.2020.All Rights Reserved.
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+#include "Tests/SimpleHttpTestUtils.h"
+#include "Core/SimpleHttpArchive.h"
+#include "Core/SimpleHttpTarStream.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+/**
+ * Directories written by the upload tar stream are extracted again, whole and in uneven pieces, also when a file
+ * changes under the stream, and archives that are cut short, forged or name paths outside the target are refused without touching it.
+ */
+namespace SimpleHTTP
+{
+	namespace ArchiveTests
+	{
+		/*Nested files, a name past the 100 characters of a ustar header, an empty file and directory, and a file of many blocks*/
+		static TArray<FString> MakeSourceDirectory(const FString &Directory)
+		{
+			TArray<FString> Files;
+			Files.Add(TEXT("Root.txt"));
+			Files.Add(TEXT("Sub/Nested/Leaf.txt"));
+			Files.Add(TEXT("Sub/") + FString::ChrN(110, TEXT('n')) + TEXT(".txt"));
+			Files.Add(TEXT("Empty.bin"));
+			Files.Add(TEXT("Large.bin"));
+
+			for (const auto &Tmp : Files)
+			{
+				TArray<uint8> Content;
+				if (Tmp == TEXT("Large.bin"))
+				{
+					Content.SetNumUninitialized(100 * 1024 + 37);
+					for (int32 i = 0; i < Content.Num(); i++)
+					{
+						Content[i] = (uint8)((i * 7) ^ (i >> 9));
+					}
+				}
+				else if (Tmp != TEXT("Empty.bin"))
+				{
+					FTCHARToUTF8 Converted(*Tmp);
+					Content.Append((const uint8*)Converted.Get(), Converted.Length());
+				}
+
+				FFileHelper::SaveArrayToFile(Content, *(Directory / Tmp));
+			}
+
+			IFileManager::Get().MakeDirectory(*(Directory / TEXT("EmptyDir")), true);
+			return Files;
+		}
+
+		/*The whole upload body, as the transport would read it*/
+		static TArray<uint8> ReadTar(const FString &Directory, bool bGzip)
+		{
+			TArray<uint8> Bytes;
+			TSharedPtr<FArchive, ESPMode::ThreadSafe> Stream = CreateDirectoryTarStream(Directory, bGzip);
+			if (Stream.IsValid())
+			{
+				Bytes.SetNumUninitialized(Stream->TotalSize());
+				Stream->Serialize(Bytes.GetData(), Bytes.Num());
+			}
+
+			return Bytes;
+		}
+
+		static bool HasSameFiles(FAutomationTestBase &Test, const FString &Source, const FString &Target, const TArray<FString> &Files)
+		{
+			bool bSame = true;
+			for (const auto &Tmp : Files)
+			{
+				TArray<uint8> Expected;
+				TArray<uint8> Extracted;
+				FFileHelper::LoadFileToArray(Expected, *(Source / Tmp));
+
+				if (!FFileHelper::LoadFileToArray(Extracted, *(Target / Tmp)) || Expected != Extracted)
+				{
+					Test.AddError(FString::Printf(TEXT("[%s] was not extracted as it was written."), *Tmp));
+					bSame = false;
+				}
+			}
+
+			if (!IFileManager::Get().DirectoryExists(*(Target / TEXT("EmptyDir"))))
+			{
+				Test.AddError(TEXT("The empty directory was not extracted."));
+				bSame = false;
+			}
+
+			return bSame;
+		}
+
+		/*Nothing may be left beside the target once an extraction is over*/
+		static bool HasStagingLeft(const FString &Target)
+		{
+			TArray<FString> Found;
+			IFileManager::Get().FindFiles(Found, *(FPaths::GetPath(Target) / TEXT("*")), false, true);
+
+			const FString StagingPrefix = TEXT(".") + FPaths::GetCleanFilename(Target) + TEXT(".");
+			return Found.ContainsByPredicate([&StagingPrefix](const FString &Tmp) { return Tmp.StartsWith(StagingPrefix); });
+		}
+
+		static void AppendU16(TArray<uint8> &Bytes, uint16 Value)
+		{
+			Bytes.Add(Value & 0xFF);
+			Bytes.Add(Value >> 8);
+		}
+
+		static void AppendU32(TArray<uint8> &Bytes, uint32 Value)
+		{
+			AppendU16(Bytes, Value & 0xFFFF);
+			AppendU16(Bytes, Value >> 16);
+		}
+
+		/*The CRC-32 zip stores, bit by bit so the test does not lean on the code it checks*/
+		static uint32 ZipCrc32(const TArray<uint8> &Bytes)
+		{
+			uint32 Crc = 0xFFFFFFFF;
+			for (const uint8 Tmp : Bytes)
+			{
+				Crc ^= Tmp;
+				for (int32 Bit = 0; Bit < 8; Bit++)
+				{
+					Crc = (Crc >> 1) ^ (0xEDB88320 & (0 - (Crc & 1)));
+				}
+			}
+
+			return ~Crc;
+		}
+
+		/*One stored entry whose directory claims DeclaredSize*/
+		static TArray<uint8> MakeStoredZip(const FString &Name, const TArray<uint8> &Content, uint32 DeclaredSize)
+		{
+			FTCHARToUTF8 UTF8Name(*Name);
+			const uint32 Crc = ZipCrc32(Content);
+			TArray<uint8> Zip;
+
+			AppendU32(Zip, 0x04034b50);
+			AppendU16(Zip, 10);
+			AppendU16(Zip, 0);
+			AppendU16(Zip, 0);
+			AppendU32(Zip, 0);
+			AppendU32(Zip, Crc);
+			AppendU32(Zip, Content.Num());
+			AppendU32(Zip, DeclaredSize);
+			AppendU16(Zip, UTF8Name.Length());
+			AppendU16(Zip, 0);
+			Zip.Append((const uint8*)UTF8Name.Get(), UTF8Name.Length());
+			Zip.Append(Content);
+
+			const uint32 DirectoryOffset = Zip.Num();
+			AppendU32(Zip, 0x02014b50);
+			AppendU16(Zip, 10);
+			AppendU16(Zip, 10);
+			AppendU16(Zip, 0);
+			AppendU16(Zip, 0);
+			AppendU32(Zip, 0);
+			AppendU32(Zip, Crc);
+			AppendU32(Zip, Content.Num());
+			AppendU32(Zip, DeclaredSize);
+			AppendU16(Zip, UTF8Name.Length());
+			AppendU16(Zip, 0);
+			AppendU16(Zip, 0);
+			AppendU16(Zip, 0);
+			AppendU16(Zip, 0);
+			AppendU32(Zip, 0);
+			AppendU32(Zip, 0);
+			Zip.Append((const uint8*)UTF8Name.Get(), UTF8Name.Length());
+
+			const uint32 DirectorySize = Zip.Num() - DirectoryOffset;
+			AppendU32(Zip, 0x06054b50);
+			AppendU16(Zip, 0);
+			AppendU16(Zip, 0);
+			AppendU16(Zip, 1);
+			AppendU16(Zip, 1);
+			AppendU32(Zip, DirectorySize);
+			AppendU32(Zip, DirectoryOffset);
+			AppendU16(Zip, 0);
+
+			return Zip;
+		}
+
+		/*Fails with the target left as it was*/
+		static void TestRefused(FAutomationTestBase &Test, const FString &What, TArrayView<const uint8> Body, const FString &Target)
+		{
+			int32 Entries = 0;
+			FString Error;
+			Test.TestFalse(What, Archive::Extract(Body, Target, Entries, Error));
+			Test.TestFalse(FString::Printf(TEXT("%s says why"), *What), Error.IsEmpty());
+			Test.TestFalse(FString::Printf(TEXT("%s leaves no target"), *What), IFileManager::Get().DirectoryExists(*Target));
+			Test.TestFalse(FString::Printf(TEXT("%s leaves no staging"), *What), HasStagingLeft(Target));
+		}
+	}
+}
+
+using namespace SimpleHTTP;
+using namespace SimpleHTTP::ArchiveTests;
+using namespace SimpleHTTP::TestUtils;
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSimpleHttpArchiveTarRoundTripTest, "SimpleHTTP.Archive.TarRoundTrip", TestFlags)
+bool FSimpleHttpArchiveTarRoundTripTest::RunTest(const FString &Parameters)
+{
+	const FString TempDir = GetTempDir(TEXT("TarRoundTrip"));
+	IFileManager::Get().DeleteDirectory(*TempDir, false, true);
+
+	const FString Source = TempDir / TEXT("Source");
+	const TArray<FString> Files = MakeSourceDirectory(Source);
+
+	for (bool bGzip : { false, true })
+	{
+		const TArray<uint8> Tar = ReadTar(Source, bGzip);
+		if (!TestTrue(TEXT("The tar stream was built"), Tar.Num() > 0))
+		{
+			break;
+		}
+
+		//Whole, the way engines without a receive stream hand the body over
+		const FString Whole = TempDir / (bGzip ? TEXT("WholeGzip") : TEXT("Whole"));
+		int32 Entries = 0;
+		FString Error;
+		TestTrue(TEXT("Extracts whole"), Archive::Extract(Tar, Whole, Entries, Error));
+		TestEqual(TEXT("Every file and directory is an entry"), Entries, Files.Num() + 3);
+		HasSameFiles(*this, Source, Whole, Files);
+		TestFalse(TEXT("Staging is moved into place"), HasStagingLeft(Whole));
+
+		//In pieces that never line up with a block or the inflate window
+		const FString Streamed = TempDir / (bGzip ? TEXT("StreamedGzip") : TEXT("Streamed"));
+		Archive::FStreamExtractor Extractor(Streamed);
+
+		const int32 ChunkSizes[] = { 1, 7, 511, 513, 4093 };
+		int32 Offset = 0;
+		for (int32 i = 0; Offset < Tar.Num(); i++)
+		{
+			const int32 ChunkSize = FMath::Min(ChunkSizes[i % UE_ARRAY_COUNT(ChunkSizes)], Tar.Num() - Offset);
+			if (!Extractor.Append(Tar.GetData() + Offset, ChunkSize))
+			{
+				break;
+			}
+
+			Offset += ChunkSize;
+		}
+
+		TestEqual(TEXT("Every byte is taken"), Extractor.GetReceivedBytes(), (int64)Tar.Num());
+		TestFalse(TEXT("Nothing reaches the target before Finish"), IFileManager::Get().DirectoryExists(*Streamed));
+		TestTrue(TEXT("Extracts in pieces"), Extractor.Finish(Entries, Error));
+		HasSameFiles(*this, Source, Streamed, Files);
+		TestFalse(TEXT("Staging is moved into place"), HasStagingLeft(Streamed));
+	}
+
+	IFileManager::Get().DeleteDirectory(*TempDir, false, true);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSimpleHttpArchiveRefusedTest, "SimpleHTTP.Archive.RefusesBrokenArchives", TestFlags)
+bool FSimpleHttpArchiveRefusedTest::RunTest(const FString &Parameters)
+{
+	const FString TempDir = GetTempDir(TEXT("Refused"));
+	IFileManager::Get().DeleteDirectory(*TempDir, false, true);
+
+	const FString Source = TempDir / TEXT("Source");
+	MakeSourceDirectory(Source);
+
+	const FString Target = TempDir / TEXT("Target");
+
+	TArray<uint8> Tar = ReadTar(Source, false);
+	Tar.SetNum(Tar.Num() / 2 + 100);
+	TestRefused(*this, TEXT("A truncated tar"), Tar, Target);
+
+	TArray<uint8> Gzip = ReadTar(Source, true);
+	TArray<uint8> TruncatedGzip(Gzip.GetData(), Gzip.Num() - 8);
+	TestRefused(*this, TEXT("A gzip without its trailer"), TruncatedGzip, Target);
+
+	//The length in the trailer is no longer what anything is sized from, zlib holds the stream to it
+	if (Gzip.Num() >= 4)
+	{
+		FMemory::Memset(Gzip.GetData() + Gzip.Num() - 4, 0xFF, 4);
+	}
+	TestRefused(*this, TEXT("A gzip with a forged ISIZE"), Gzip, Target);
+
+	TArray<uint8> Content;
+	Content.Init('z', 16);
+	TestRefused(*this, TEXT("A zip entry declared past 2GB"), MakeStoredZip(TEXT("Big.bin"), Content, 0x80000000), Target);
+	TestRefused(*this, TEXT("A zip entry outside the target"), MakeStoredZip(TEXT("../Escaped.bin"), Content, Content.Num()), Target);
+	TestFalse(TEXT("Nothing escaped"), FPaths::FileExists(TempDir / TEXT("Escaped.bin")));
+
+	//A byte flipped after the CRC was taken, the entry is written whole before the sum gives it away
+	const FString CorruptName = TEXT("Corrupt.bin");
+	TArray<uint8> CorruptZip = MakeStoredZip(CorruptName, Content, Content.Num());
+	CorruptZip[30 + CorruptName.Len()] ^= 0xFF;
+	TestRefused(*this, TEXT("A zip entry that fails its CRC-32"), CorruptZip, Target);
+
+	const TArray<uint8> Text(reinterpret_cast<const uint8*>("not an archive"), 14);
+	TestRefused(*this, TEXT("A body that is no archive"), Text, Target);
+
+	//A good zip still extracts, so the refusals above are not the builder's doing
+	int32 Entries = 0;
+	FString Error;
+	TestTrue(TEXT("A stored zip extracts"), Archive::Extract(MakeStoredZip(TEXT("Dir/Stored.bin"), Content, Content.Num()), Target, Entries, Error));
+
+	TArray<uint8> Extracted;
+	FFileHelper::LoadFileToArray(Extracted, *(Target / TEXT("Dir/Stored.bin")));
+	TestTrue(TEXT("The stored entry is intact"), Extracted == Content);
+
+	IFileManager::Get().DeleteDirectory(*TempDir, false, true);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSimpleHttpArchiveChangedSourceTest, "SimpleHTTP.Archive.ChangedSourceKeepsTarWhole", TestFlags)
+bool FSimpleHttpArchiveChangedSourceTest::RunTest(const FString &Parameters)
+{
+	const FString TempDir = GetTempDir(TEXT("ChangedSource"));
+	IFileManager::Get().DeleteDirectory(*TempDir, false, true);
+
+	const FString Source = TempDir / TEXT("Source");
+	const TArray<FString> Files = MakeSourceDirectory(Source);
+
+	TSharedPtr<FArchive, ESPMode::ThreadSafe> Stream = CreateDirectoryTarStream(Source, false);
+	if (!TestTrue(TEXT("The tar stream was built"), Stream.IsValid()))
+	{
+		return false;
+	}
+
+	AddExpectedError(TEXT("changed size while it was sent"), EAutomationExpectedErrorFlags::Contains, 2);
+
+	//After the walk one file grows and one goes away
+	const FString Grown = FString::ChrN(8192, TEXT('g'));
+	FFileHelper::SaveStringToFile(Grown, *(Source / TEXT("Root.txt")));
+	IFileManager::Get().Delete(*(Source / TEXT("Sub/Nested/Leaf.txt")));
+
+	TArray<uint8> Tar;
+	Tar.SetNumUninitialized(Stream->TotalSize());
+	Stream->Serialize(Tar.GetData(), Tar.Num());
+	TestTrue(TEXT("The stream is in error so the upload fails"), Stream->IsError());
+
+	const FString Target = TempDir / TEXT("Target");
+	int32 Entries = 0;
+	FString Error;
+	TestTrue(TEXT("The tar is still whole"), Archive::Extract(Tar, Target, Entries, Error));
+	TestEqual(TEXT("A grown file is cut to the size of the walk"), IFileManager::Get().FileSize(*(Target / TEXT("Root.txt"))), (int64)FCString::Strlen(TEXT("Root.txt")));
+	TestEqual(TEXT("A missing file is padded to the size of the walk"), IFileManager::Get().FileSize(*(Target / TEXT("Sub/Nested/Leaf.txt"))), (int64)FCString::Strlen(TEXT("Sub/Nested/Leaf.txt")));
+
+	TArray<uint8> Large;
+	FFileHelper::LoadFileToArray(Large, *(Target / TEXT("Large.bin")));
+	TArray<uint8> SourceLarge;
+	FFileHelper::LoadFileToArray(SourceLarge, *(Source / TEXT("Large.bin")));
+	TestTrue(TEXT("The entries after them are intact"), Large == SourceLarge);
+
+	IFileManager::Get().DeleteDirectory(*TempDir, false, true);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSimpleHttpArchiveSafeEntryNameTest, "SimpleHTTP.Archive.IsSafeEntryName", TestFlags)
+bool FSimpleHttpArchiveSafeEntryNameTest::RunTest(const FString &Parameters)
+{
+	TestTrue(TEXT("A relative path"), Archive::IsSafeEntryName(TEXT("a/b")));
+	TestTrue(TEXT("Dots inside a name"), Archive::IsSafeEntryName(TEXT("a/..b/c..")));
+	TestTrue(TEXT("A directory entry"), Archive::IsSafeEntryName(TEXT("a/")));
+
+	TestFalse(TEXT("Empty"), Archive::IsSafeEntryName(TEXT("")));
+	TestFalse(TEXT(".."), Archive::IsSafeEntryName(TEXT("..")));
+	TestFalse(TEXT("../a"), Archive::IsSafeEntryName(TEXT("../a")));
+	TestFalse(TEXT("a/../../b"), Archive::IsSafeEntryName(TEXT("a/../../b")));
+	TestFalse(TEXT("Backslashes are separators too"), Archive::IsSafeEntryName(TEXT("a\\..\\..\\b")));
+	TestFalse(TEXT("An absolute path"), Archive::IsSafeEntryName(TEXT("/etc/passwd")));
+	TestFalse(TEXT("An absolute Windows path"), Archive::IsSafeEntryName(TEXT("\\Windows\\win.ini")));
+	TestFalse(TEXT("A drive"), Archive::IsSafeEntryName(TEXT("C:/x")));
+	TestFalse(TEXT("A drive relative path"), Archive::IsSafeEntryName(TEXT("C:x")));
+
+	return true;
+}
+
+#endif
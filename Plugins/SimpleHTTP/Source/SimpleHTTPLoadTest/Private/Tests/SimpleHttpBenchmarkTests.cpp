@@ -0,0 +1,466 @@
+// Copyright (C) RenZhai.2020.All Rights Reserved.
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS && WITH_SIMPLEHTTP_LOOPBACK_SERVER
+#include "Tests/SimpleHttpTestUtils.h"
+#include "Tests/SimpleHttpLoopbackServer.h"
+#include "Core/SimpleHttpStats.h"
+#include "Core/SimpleHTTPMethod.h"
+#include "SimpleHTTPManage.h"
+#include "Interfaces/IPluginManager.h"
+#include "Interfaces/IHttpResponse.h"
+#include "Dom/JsonObject.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonWriter.h"
+#include "Serialization/JsonSerializer.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/CommandLine.h"
+#include "Misc/Paths.h"
+#include "SimpleHTTPLog.h"
+
+/**
+ * Throughput and latency of the FHTTP entry points against the loopback server.
+ *
+ * Results are written to Saved/Automation/SimpleHTTP/Benchmarks/<Platform>/<Name>.json.
+ * When Benchmarks/Baselines/<Platform>/<Name>.json exists in the plugin, a run that is slower than it
+ * by more than -SimpleHttpBenchmarkTolerance= (0.25 by default) fails. -SimpleHttpBenchmarkUpdateBaseline
+ * stores the run as the new baseline. -SimpleHttpBenchmarkPort= moves the server off port 8977.
+ */
+namespace SimpleHTTP
+{
+	namespace Benchmark
+	{
+		/*A benchmark that has not finished by then is failed and its requests are cancelled*/
+		static const double TimeoutSeconds = 120.0;
+
+		static TSharedPtr<FSimpleHttpLoopbackServer> GetServer()
+		{
+			return FSimpleHttpLoopbackServer::Get();
+		}
+
+		struct FRun
+		{
+			FRun(const FString &InName, int32 InOperations, int64 InBytesPerOperation)
+				:Name(InName)
+				,Operations(InOperations)
+				,BytesPerOperation(InBytesPerOperation)
+				,StartTime(0.0)
+				,EndTime(0.0)
+				,Succeeded(0)
+				,Failed(0)
+			{}
+
+			FORCEINLINE bool IsDone() const { return Succeeded + Failed >= Operations; }
+
+			void Record(double IssueTime, bool bSucceeded)
+			{
+				const double CurrentTime = FPlatformTime::Seconds();
+				Latency.Add(CurrentTime - IssueTime);
+
+				bSucceeded ? ++Succeeded : ++Failed;
+				if (IsDone())
+				{
+					EndTime = CurrentTime;
+				}
+			}
+
+			FString Name;
+			int32 Operations;
+			int64 BytesPerOperation;
+
+			double StartTime;
+			double EndTime;
+			int32 Succeeded;
+			int32 Failed;
+			FSimpleHttpLatencyHistogram Latency;
+		};
+
+		/*Every completion of the handle counts as one operation, timed from IssueTime*/
+		static FSimpleHttpResponseDelegate MakeDelegate(const TSharedRef<FRun> &Run, double IssueTime)
+		{
+			FSimpleHttpResponseDelegate Delegate;
+			Delegate.SimpleCompleteViewDelegate.BindLambda([Run, IssueTime](const FSimpleHttpRequest &Request, const FSimpleHttpResponseView &Response, bool bConnectedSuccessfully)
+			{
+				Run->Record(IssueTime, bConnectedSuccessfully && EHttpResponseCodes::IsOk(Response.GetResponseCode()));
+			});
+
+			return Delegate;
+		}
+
+		static TSharedRef<FJsonObject> ToJson(const FRun &Run)
+		{
+			const double Seconds = FMath::Max(Run.EndTime - Run.StartTime, SMALL_NUMBER);
+
+			TSharedRef<FJsonObject> Latency = MakeShared<FJsonObject>();
+			Latency->SetNumberField(TEXT("p50"), Run.Latency.GetPercentile(50.0) * 1000.0);
+			Latency->SetNumberField(TEXT("p95"), Run.Latency.GetPercentile(95.0) * 1000.0);
+			Latency->SetNumberField(TEXT("p99"), Run.Latency.GetPercentile(99.0) * 1000.0);
+			Latency->SetNumberField(TEXT("max"), Run.Latency.GetMax() * 1000.0);
+			Latency->SetNumberField(TEXT("mean"), Run.Latency.GetMean() * 1000.0);
+
+			TSharedRef<FJsonObject> Result = MakeShared<FJsonObject>();
+			Result->SetStringField(TEXT("name"), Run.Name);
+			Result->SetStringField(TEXT("platform"), FPlatformProperties::IniPlatformName());
+			Result->SetNumberField(TEXT("operations"), Run.Operations);
+			Result->SetNumberField(TEXT("failed"), Run.Failed);
+			Result->SetNumberField(TEXT("seconds"), Seconds);
+			Result->SetNumberField(TEXT("opsPerSecond"), Run.Operations / Seconds);
+			Result->SetNumberField(TEXT("megabytesPerSecond"), Run.Operations * (double)Run.BytesPerOperation / Seconds / (1024.0 * 1024.0));
+			Result->SetObjectField(TEXT("latencyMs"), Latency);
+
+			return Result;
+		}
+
+		static bool SaveJson(const TSharedRef<FJsonObject> &JsonObject, const FString &Filename)
+		{
+			FString Json;
+			TSharedRef<TJsonWriter<>> JsonWriter = TJsonWriterFactory<>::Create(&Json);
+			FJsonSerializer::Serialize(JsonObject, JsonWriter);
+
+			return FFileHelper::SaveStringToFile(Json, *Filename);
+		}
+
+		static FString GetBaselineFilename(const FString &Name)
+		{
+			TSharedPtr<IPlugin> Plugin = IPluginManager::Get().FindPlugin(TEXT("SimpleHTTP"));
+			if (!Plugin.IsValid())
+			{
+				return FString();
+			}
+
+			return Plugin->GetBaseDir() / TEXT("Benchmarks/Baselines") / FPlatformProperties::IniPlatformName() / Name + TEXT(".json");
+		}
+
+		/*Writes the result and holds it against the stored baseline*/
+		static void Report(FAutomationTestBase &Test, const FRun &Run)
+		{
+			TSharedRef<FJsonObject> Result = ToJson(Run);
+
+			Test.AddInfo(FString::Printf(TEXT("%s: %d ops in %.3fs, %.1f ops/s, %.2f MB/s, p50 %.2fms p95 %.2fms p99 %.2fms, %d failed."),
+				*Run.Name,
+				Run.Operations,
+				Result->GetNumberField(TEXT("seconds")),
+				Result->GetNumberField(TEXT("opsPerSecond")),
+				Result->GetNumberField(TEXT("megabytesPerSecond")),
+				Run.Latency.GetPercentile(50.0) * 1000.0,
+				Run.Latency.GetPercentile(95.0) * 1000.0,
+				Run.Latency.GetPercentile(99.0) * 1000.0,
+				Run.Failed));
+
+			if (Run.Failed > 0)
+			{
+				Test.AddError(FString::Printf(TEXT("%s: %d of %d operations failed."), *Run.Name, Run.Failed, Run.Operations));
+			}
+
+			const FString ResultFilename = FPaths::ProjectSavedDir() / TEXT("Automation/SimpleHTTP/Benchmarks") / FPlatformProperties::IniPlatformName() / Run.Name + TEXT(".json");
+			if (!SaveJson(Result, ResultFilename))
+			{
+				Test.AddWarning(FString::Printf(TEXT("Could not write %s."), *ResultFilename));
+			}
+
+			const FString BaselineFilename = GetBaselineFilename(Run.Name);
+			if (BaselineFilename.IsEmpty())
+			{
+				return;
+			}
+
+			if (FParse::Param(FCommandLine::Get(), TEXT("SimpleHttpBenchmarkUpdateBaseline")))
+			{
+				if (Run.Failed == 0 && SaveJson(Result, BaselineFilename))
+				{
+					Test.AddInfo(FString::Printf(TEXT("Baseline updated %s."), *BaselineFilename));
+				}
+				return;
+			}
+
+			FString BaselineJson;
+			if (!FFileHelper::LoadFileToString(BaselineJson, *BaselineFilename))
+			{
+				Test.AddInfo(FString::Printf(TEXT("No baseline for %s, run with -SimpleHttpBenchmarkUpdateBaseline to store one."), *Run.Name));
+				return;
+			}
+
+			TSharedPtr<FJsonObject> Baseline;
+			if (!FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(BaselineJson), Baseline) || !Baseline.IsValid())
+			{
+				Test.AddWarning(FString::Printf(TEXT("Baseline %s is not valid JSON."), *BaselineFilename));
+				return;
+			}
+
+			float Tolerance = 0.25f;
+			FParse::Value(FCommandLine::Get(), TEXT("SimpleHttpBenchmarkTolerance="), Tolerance);
+
+			const double BaselineOpsPerSecond = Baseline->GetNumberField(TEXT("opsPerSecond"));
+			const double OpsPerSecond = Result->GetNumberField(TEXT("opsPerSecond"));
+			if (OpsPerSecond < BaselineOpsPerSecond * (1.0 - Tolerance))
+			{
+				Test.AddError(FString::Printf(TEXT("%s throughput regressed, %.1f ops/s against a baseline of %.1f."), *Run.Name, OpsPerSecond, BaselineOpsPerSecond));
+			}
+
+			const TSharedPtr<FJsonObject>* BaselineLatency = nullptr;
+			if (Baseline->TryGetObjectField(TEXT("latencyMs"), BaselineLatency))
+			{
+				const double BaselineP95 = (*BaselineLatency)->GetNumberField(TEXT("p95"));
+				const double P95 = Run.Latency.GetPercentile(95.0) * 1000.0;
+				if (P95 > BaselineP95 * (1.0 + Tolerance))
+				{
+					Test.AddError(FString::Printf(TEXT("%s p95 latency regressed, %.2fms against a baseline of %.2fms."), *Run.Name, P95, BaselineP95));
+				}
+			}
+		}
+
+		/*Fires the requests of a run on its first update, then waits until all of them are back and removes TempDir*/
+		class FRunCommand : public IAutomationLatentCommand
+		{
+		public:
+			FRunCommand(FAutomationTestBase *InTest, TSharedRef<FRun> InRun, TFunction<void()> InPrepare, TFunction<void(const TSharedRef<FRun>&)> InStart, const FString &InTempDir)
+				:Test(InTest)
+				,Run(InRun)
+				,Prepare(MoveTemp(InPrepare))
+				,Start(MoveTemp(InStart))
+				,TempDir(InTempDir)
+				,bStarted(false)
+			{}
+
+			virtual ~FRunCommand()
+			{
+				if (!TempDir.IsEmpty())
+				{
+					IFileManager::Get().DeleteDirectory(*TempDir, false, true);
+				}
+			}
+
+			virtual bool Update() override
+			{
+				if (!bStarted)
+				{
+					bStarted = true;
+
+					if (Prepare)
+					{
+						Prepare();
+					}
+
+					Run->StartTime = FPlatformTime::Seconds();
+					Start(Run);
+				}
+
+				TestUtils::TickManager();
+
+				if (Run->IsDone())
+				{
+					Report(*Test, *Run);
+					return true;
+				}
+
+				if (FPlatformTime::Seconds() - Run->StartTime > TimeoutSeconds)
+				{
+					Test->AddError(FString::Printf(TEXT("%s timed out with %d of %d operations done."), *Run->Name, Run->Succeeded + Run->Failed, Run->Operations));
+					SIMPLE_HTTP.Cancel();
+					return true;
+				}
+
+				return false;
+			}
+
+		private:
+			FAutomationTestBase *Test;
+			TSharedRef<FRun> Run;
+			TFunction<void()> Prepare;
+			TFunction<void(const TSharedRef<FRun>&)> Start;
+			FString TempDir;
+			bool bStarted;
+		};
+
+		static bool Run(FAutomationTestBase &Test, const FString &Name, int32 Operations, int64 BytesPerOperation, TFunction<void()> Prepare, TFunction<void(const TSharedRef<FRun>&)> Start, const FString &TempDir = FString())
+		{
+			if (!GetServer().IsValid())
+			{
+				Test.AddError(TEXT("Loopback server is not running."));
+				return false;
+			}
+
+			ADD_LATENT_AUTOMATION_COMMAND(FRunCommand(&Test, MakeShared<FRun>(Name, Operations, BytesPerOperation), MoveTemp(Prepare), MoveTemp(Start), TempDir));
+			return true;
+		}
+
+		static FString GetBytesURL(int64 Size, const FString &Name)
+		{
+			return GetServer()->GetURL(FString::Printf(TEXT("/bytes/%lld/%s"), Size, *Name));
+		}
+	}
+}
+
+using namespace SimpleHTTP::Benchmark;
+using namespace SimpleHTTP::TestUtils;
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSimpleHttpBenchmarkURLEncode, "SimpleHTTP.Benchmark.URLEncode", PerfTestFlags)
+bool FSimpleHttpBenchmarkURLEncode::RunTest(const FString &Parameters)
+{
+	const FString Input = TEXT("https://example.com/path with spaces/资源/file name (1).pak?key=value&list=a,b,c");
+	const int32 Batches = 100;
+	const int32 BatchSize = 1000;
+
+	FRun Run(TEXT("URLEncode"), Batches * BatchSize, Input.Len());
+	Run.StartTime = FPlatformTime::Seconds();
+
+	int64 EncodedChars = 0;
+	for (int32 i = 0; i < Batches; ++i)
+	{
+		const double BatchStartTime = FPlatformTime::Seconds();
+		for (int32 j = 0; j < BatchSize; ++j)
+		{
+			EncodedChars += SimpleHTTP::SimpleURLEncodeComponent(*Input).Len();
+		}
+
+		//One sample per batch, a single encode is below the timer resolution
+		Run.Latency.Add((FPlatformTime::Seconds() - BatchStartTime) / BatchSize);
+	}
+
+	Run.EndTime = FPlatformTime::Seconds();
+	Run.Succeeded = Run.Operations;
+
+	TestTrue(TEXT("Encoded output"), EncodedChars > 0);
+	Report(*this, Run);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSimpleHttpBenchmarkSmallGet, "SimpleHTTP.Benchmark.SmallGet", PerfTestFlags)
+bool FSimpleHttpBenchmarkSmallGet::RunTest(const FString &Parameters)
+{
+	const int32 Operations = 500;
+	const int64 Size = 256;
+
+	return Run(*this, TEXT("SmallGet"), Operations, Size, nullptr, [=](const TSharedRef<FRun> &InRun)
+	{
+		for (int32 i = 0; i < Operations; ++i)
+		{
+			SIMPLE_HTTP.GetObjectToMemory(MakeDelegate(InRun, FPlatformTime::Seconds()), GetBytesURL(Size, FString::Printf(TEXT("small%d"), i)));
+		}
+	});
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSimpleHttpBenchmarkLargeGetToMemory, "SimpleHTTP.Benchmark.LargeGetToMemory", PerfTestFlags)
+bool FSimpleHttpBenchmarkLargeGetToMemory::RunTest(const FString &Parameters)
+{
+	const int32 Operations = 4;
+	const int64 Size = 32 * 1024 * 1024;
+
+	return Run(*this, TEXT("LargeGetToMemory"), Operations, Size, nullptr, [=](const TSharedRef<FRun> &InRun)
+	{
+		for (int32 i = 0; i < Operations; ++i)
+		{
+			SIMPLE_HTTP.GetObjectToMemory(MakeDelegate(InRun, FPlatformTime::Seconds()), GetBytesURL(Size, FString::Printf(TEXT("large%d.bin"), i)));
+		}
+	});
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSimpleHttpBenchmarkLargeGetToLocal, "SimpleHTTP.Benchmark.LargeGetToLocal", PerfTestFlags)
+bool FSimpleHttpBenchmarkLargeGetToLocal::RunTest(const FString &Parameters)
+{
+	const int32 Operations = 4;
+	const int64 Size = 32 * 1024 * 1024;
+	const FString SaveDir = GetTempDir(TEXT("LargeGetToLocal"));
+
+	return Run(*this, TEXT("LargeGetToLocal"), Operations, Size,
+		[SaveDir]()
+		{
+			IFileManager::Get().DeleteDirectory(*SaveDir, false, true);
+			IFileManager::Get().MakeDirectory(*SaveDir, true);
+		},
+		[=](const TSharedRef<FRun> &InRun)
+		{
+			for (int32 i = 0; i < Operations; ++i)
+			{
+				SIMPLE_HTTP.GetObjectToLocal(MakeDelegate(InRun, FPlatformTime::Seconds()), GetBytesURL(Size, FString::Printf(TEXT("large%d.bin"), i)), SaveDir);
+			}
+		}, SaveDir);
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSimpleHttpBenchmarkGetObjectsToLocal, "SimpleHTTP.Benchmark.GetObjectsToLocal", PerfTestFlags)
+bool FSimpleHttpBenchmarkGetObjectsToLocal::RunTest(const FString &Parameters)
+{
+	const int32 Operations = 200;
+	const int64 Size = 64 * 1024;
+	const FString SaveDir = GetTempDir(TEXT("GetObjectsToLocal"));
+
+	return Run(*this, TEXT("GetObjectsToLocal"), Operations, Size,
+		[SaveDir]()
+		{
+			IFileManager::Get().DeleteDirectory(*SaveDir, false, true);
+			IFileManager::Get().MakeDirectory(*SaveDir, true);
+		},
+		[=](const TSharedRef<FRun> &InRun)
+		{
+			TArray<FString> URLs;
+			for (int32 i = 0; i < Operations; ++i)
+			{
+				URLs.Add(GetBytesURL(Size, FString::Printf(TEXT("file%d.bin"), i)));
+			}
+
+			SIMPLE_HTTP.GetObjectsToLocal(MakeDelegate(InRun, FPlatformTime::Seconds()), URLs, SaveDir);
+		}, SaveDir);
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSimpleHttpBenchmarkPutObjectFromBuffer, "SimpleHTTP.Benchmark.PutObjectFromBuffer", PerfTestFlags)
+bool FSimpleHttpBenchmarkPutObjectFromBuffer::RunTest(const FString &Parameters)
+{
+	const int32 Operations = 16;
+	const int64 Size = 4 * 1024 * 1024;
+
+	TSharedRef<TArray<uint8>> Buffer = MakeShared<TArray<uint8>>();
+	Buffer->SetNumZeroed(Size);
+
+	return Run(*this, TEXT("PutObjectFromBuffer"), Operations, Size, nullptr, [=](const TSharedRef<FRun> &InRun)
+	{
+		for (int32 i = 0; i < Operations; ++i)
+		{
+			SIMPLE_HTTP.PutObjectFromBuffer(MakeDelegate(InRun, FPlatformTime::Seconds()), GetServer()->GetURL(FString::Printf(TEXT("/upload/buffer%d"), i)), *Buffer);
+		}
+	});
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSimpleHttpBenchmarkPutObjectsFromLocal, "SimpleHTTP.Benchmark.PutObjectsFromLocal", PerfTestFlags)
+bool FSimpleHttpBenchmarkPutObjectsFromLocal::RunTest(const FString &Parameters)
+{
+	const int32 Operations = 200;
+	const int64 Size = 16 * 1024;
+	const FString LocalDir = GetTempDir(TEXT("PutObjectsFromLocal"));
+
+	return Run(*this, TEXT("PutObjectsFromLocal"), Operations, Size,
+		[=]()
+		{
+			IFileManager::Get().DeleteDirectory(*LocalDir, false, true);
+
+			TArray<uint8> Content;
+			Content.SetNumZeroed(Size);
+			for (int32 i = 0; i < Operations; ++i)
+			{
+				FFileHelper::SaveArrayToFile(Content, *(LocalDir / FString::Printf(TEXT("file%d.bin"), i)));
+			}
+		},
+		[=](const TSharedRef<FRun> &InRun)
+		{
+			SIMPLE_HTTP.PutObjectsFromLocal(MakeDelegate(InRun, FPlatformTime::Seconds()), GetServer()->GetURL(TEXT("/upload")), LocalDir);
+		}, LocalDir);
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSimpleHttpBenchmarkPostRequest, "SimpleHTTP.Benchmark.PostRequest", PerfTestFlags)
+bool FSimpleHttpBenchmarkPostRequest::RunTest(const FString &Parameters)
+{
+	const int32 Operations = 500;
+	const FString Param = TEXT("user=benchmark&session=0123456789abcdef&payload=") + FString::ChrN(64, TEXT('x'));
+
+	return Run(*this, TEXT("PostRequest"), Operations, Param.Len(), nullptr, [=](const TSharedRef<FRun> &InRun)
+	{
+		const FString URL = GetServer()->GetURL(TEXT("/echo"));
+		for (int32 i = 0; i < Operations; ++i)
+		{
+			SIMPLE_HTTP.PostRequest(*URL, *Param, MakeDelegate(InRun, FPlatformTime::Seconds()));
+		}
+	});
+}
+
+#endif
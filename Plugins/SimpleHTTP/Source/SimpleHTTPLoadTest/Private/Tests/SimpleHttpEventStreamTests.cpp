@@ -0,0 +1,273 @@
+// Copyright (C) RenZhai.2020.All Rights Reserved.
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+#include "Tests/SimpleHttpTestUtils.h"
+#include "Core/SimpleHttpEventStream.h"
+
+#if WITH_SIMPLEHTTP_LOOPBACK_SERVER
+#include "Tests/SimpleHttpLoopbackServer.h"
+#include "Runtime/Launch/Resources/Version.h"
+#endif
+
+/**
+ * The server-sent event parser fed the way a transport hands bodies over, in pieces that split lines
+ * and line ends anywhere, and the drop policy when the game thread does not take events in time.
+ * Against the loopback server, GetStream delivers a body whether the engine streams it or hands it over at the end.
+ */
+namespace SimpleHTTP
+{
+	namespace EventStreamTests
+	{
+		/*The smallest buffer the stream accepts*/
+		static const int64 MaxBufferedBytes = 1024;
+
+		static TSharedRef<FSimpleHttpEventStream, ESPMode::ThreadSafe> MakeStream(bool bServerSentEvents)
+		{
+			return MakeShared<FSimpleHttpEventStream, ESPMode::ThreadSafe>(bServerSentEvents, MaxBufferedBytes);
+		}
+
+		static void Append(FSimpleHttpEventStream &Stream, const FString &Text)
+		{
+			FTCHARToUTF8 Converted(*Text);
+			Stream.Append((const uint8*)Converted.Get(), Converted.Length());
+		}
+
+		/*Each piece is appended on its own, as separate receive calls*/
+		static TArray<FSimpleHttpStreamEvent> Parse(const TArray<FString> &Pieces)
+		{
+			TSharedRef<FSimpleHttpEventStream, ESPMode::ThreadSafe> Stream = MakeStream(true);
+			for (const auto &Tmp : Pieces)
+			{
+				Append(*Stream, Tmp);
+			}
+
+			TArray<FSimpleHttpStreamEvent> Events;
+			Stream->Dequeue(Events);
+			return Events;
+		}
+
+		static TArray<uint8> MakeChunk(int32 Size)
+		{
+			TArray<uint8> Chunk;
+			Chunk.Init('c', Size);
+			return Chunk;
+		}
+	}
+}
+
+using namespace SimpleHTTP;
+using namespace SimpleHTTP::EventStreamTests;
+using namespace SimpleHTTP::TestUtils;
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSimpleHttpEventStreamParseTest, "SimpleHTTP.EventStream.Parse", TestFlags)
+bool FSimpleHttpEventStreamParseTest::RunTest(const FString &Parameters)
+{
+	//A CRLF split between appends ends one line, not two
+	TArray<FSimpleHttpStreamEvent> Events = Parse({ TEXT("data: a\r"), TEXT("\ndata: b\r"), TEXT("\n\r"), TEXT("\n") });
+	if (TestEqual(TEXT("Split CRLF gives one event"), Events.Num(), 1))
+	{
+		TestEqual(TEXT("Split CRLF keeps both lines"), Events[0].Data, FString(TEXT("a\nb")));
+	}
+
+	//CR alone and LF alone end lines too
+	Events = Parse({ TEXT("data: cr\r\rdata: lf\n\n") });
+	if (TestEqual(TEXT("Every line ending is one"), Events.Num(), 2))
+	{
+		TestEqual(TEXT("CR ends a line"), Events[0].Data, FString(TEXT("cr")));
+		TestEqual(TEXT("LF ends a line"), Events[1].Data, FString(TEXT("lf")));
+	}
+
+	//Data lines are joined, the type and id belong to the event
+	Events = Parse({ TEXT("event: score\nid: 7\ndata: one\nda"), TEXT("ta:two\ndata\n\n"), TEXT("data: next\n\n") });
+	if (TestEqual(TEXT("Multi-line events"), Events.Num(), 2))
+	{
+		TestEqual(TEXT("Data lines are joined"), Events[0].Data, FString(TEXT("one\ntwo\n")));
+		TestEqual(TEXT("Event type"), Events[0].Event, FString(TEXT("score")));
+		TestEqual(TEXT("Event id"), Events[0].Id, FString(TEXT("7")));
+		TestEqual(TEXT("An unnamed event is a message"), Events[1].Event, FString(TEXT("message")));
+		TestEqual(TEXT("The last id carries over"), Events[1].Id, FString(TEXT("7")));
+	}
+
+	//Comments keep the connection alive and are never events
+	Events = Parse({ TEXT(": keep-alive\n\n:"), TEXT("ping\ndata: after\n\n") });
+	if (TestEqual(TEXT("Comments are not events"), Events.Num(), 1))
+	{
+		TestEqual(TEXT("Data around comments"), Events[0].Data, FString(TEXT("after")));
+	}
+
+	//An event without data is not dispatched
+	Events = Parse({ TEXT("event: empty\n\ndata: x\n\n") });
+	if (TestEqual(TEXT("Events without data are skipped"), Events.Num(), 1))
+	{
+		TestEqual(TEXT("The skipped type does not carry over"), Events[0].Event, FString(TEXT("message")));
+	}
+
+	//A line past the buffer is skipped whole, the stream goes on with the next line
+	AddExpectedError(TEXT("line is longer than"), EAutomationExpectedErrorFlags::Contains, 1);
+	Events = Parse({ TEXT("data: ") + FString::ChrN(MaxBufferedBytes, TEXT('x')), FString::ChrN(MaxBufferedBytes, TEXT('x')) + TEXT("\r"), TEXT("\ndata: ok\n\n") });
+	if (TestEqual(TEXT("The overlong line is skipped"), Events.Num(), 1))
+	{
+		TestEqual(TEXT("The line after it is read"), Events[0].Data, FString(TEXT("ok")));
+	}
+
+	//Nothing is dispatched before the blank line
+	Events = Parse({ TEXT("data: pending\n") });
+	TestEqual(TEXT("An unfinished event waits"), Events.Num(), 0);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSimpleHttpEventStreamDropTest, "SimpleHTTP.EventStream.DropsOldest", TestFlags)
+bool FSimpleHttpEventStreamDropTest::RunTest(const FString &Parameters)
+{
+	TSharedRef<FSimpleHttpEventStream, ESPMode::ThreadSafe> Stream = MakeStream(false);
+
+	//Three chunks fit, nothing is dropped
+	const TArray<uint8> Small = MakeChunk(300);
+	for (int32 i = 0; i < 3; i++)
+	{
+		Stream->Append(Small.GetData(), Small.Num());
+	}
+
+	TArray<FSimpleHttpStreamEvent> Events;
+	Stream->Dequeue(Events);
+	TestEqual(TEXT("Chunks that fit are kept"), Events.Num(), 3);
+	TestTrue(TEXT("Nothing is dropped while they fit"), !Events.ContainsByPredicate([](const FSimpleHttpStreamEvent &Tmp) { return Tmp.Dropped != 0; }));
+	TestTrue(TEXT("Chunks are delivered as received"), Events.Num() > 0 && Events[0].Chunk == Small);
+
+	AddExpectedError(TEXT("stream events were dropped"), EAutomationExpectedErrorFlags::Contains, 0);
+
+	//Taking them frees the buffer, the fourth overflows it again and the oldest makes room
+	for (int32 i = 0; i < 4; i++)
+	{
+		Stream->Append(Small.GetData(), Small.Num());
+	}
+
+	Stream->Dequeue(Events);
+	if (TestEqual(TEXT("The oldest are dropped"), Events.Num(), 3))
+	{
+		TestEqual(TEXT("Kept chunks lost nothing before them"), Events[0].Dropped, 0);
+		TestEqual(TEXT("The chunk that overflowed counts what was lost"), Events[2].Dropped, 1);
+	}
+
+	//A server-sent event is counted the same way
+	TSharedRef<FSimpleHttpEventStream, ESPMode::ThreadSafe> EventStream = MakeStream(true);
+	const FString Data = FString::ChrN(200, TEXT('d'));
+	for (int32 i = 0; i < 4; i++)
+	{
+		Append(*EventStream, TEXT("data: ") + Data + TEXT("\n\n"));
+	}
+
+	EventStream->Dequeue(Events);
+	int32 Dropped = 0;
+	for (const auto &Tmp : Events)
+	{
+		Dropped += Tmp.Dropped;
+	}
+
+	TestTrue(TEXT("Undelivered events stay within the buffer"), Events.Num() < 4);
+	TestEqual(TEXT("Every event is kept or counted"), Events.Num() + Dropped, 4);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSimpleHttpEventStreamWholeBodyTest, "SimpleHTTP.EventStream.WholeBodyKeepsAll", TestFlags)
+bool FSimpleHttpEventStreamWholeBodyTest::RunTest(const FString &Parameters)
+{
+	//A body handed over at the end holds far more than the buffer, none of it may count as dropped
+	FString Body;
+	for (int32 i = 0; i < 8; i++)
+	{
+		Body += FString::Printf(TEXT("data: %d %s\n\n"), i, *FString::ChrN(200, TEXT('w')));
+	}
+
+	TSharedRef<FSimpleHttpEventStream, ESPMode::ThreadSafe> Stream = MakeStream(true);
+	FTCHARToUTF8 Converted(*Body);
+	Stream->AppendWhole((const uint8*)Converted.Get(), Converted.Length());
+
+	TArray<FSimpleHttpStreamEvent> Events;
+	Stream->Dequeue(Events);
+	if (TestEqual(TEXT("Every event of the body is kept"), Events.Num(), 8))
+	{
+		TestTrue(TEXT("The first event is there"), Events[0].Data.StartsWith(TEXT("0 ")));
+		TestTrue(TEXT("The last event is there"), Events[7].Data.StartsWith(TEXT("7 ")));
+	}
+	TestTrue(TEXT("Nothing is dropped"), !Events.ContainsByPredicate([](const FSimpleHttpStreamEvent &Tmp) { return Tmp.Dropped != 0; }));
+
+	//Chunks are the body as it is
+	TSharedRef<FSimpleHttpEventStream, ESPMode::ThreadSafe> ChunkStream = MakeStream(false);
+	const TArray<uint8> Chunk = MakeChunk((int32)MaxBufferedBytes * 4);
+	ChunkStream->AppendWhole(Chunk.GetData(), Chunk.Num());
+
+	ChunkStream->Dequeue(Events);
+	TestTrue(TEXT("The whole body is one chunk"), Events.Num() == 1 && Events[0].Chunk == Chunk && Events[0].Dropped == 0);
+
+	return true;
+}
+
+#if WITH_SIMPLEHTTP_LOOPBACK_SERVER
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSimpleHttpEventStreamGetStreamTest, "SimpleHTTP.EventStream.GetStreamDeliversBody", TestFlags)
+bool FSimpleHttpEventStreamGetStreamTest::RunTest(const FString &Parameters)
+{
+	TSharedPtr<FSimpleHttpLoopbackServer> Server = FSimpleHttpLoopbackServer::Get();
+	if (!Server.IsValid())
+	{
+		AddError(TEXT("Loopback server is not running."));
+		return false;
+	}
+
+	struct FStreamRun
+	{
+		FStreamRun()
+			:ReceivedBytes(0)
+			,Dropped(0)
+			,BytesAtCompletion(INDEX_NONE)
+			,bCompleted(false)
+		{}
+
+		int64 ReceivedBytes;
+		int32 Dropped;
+		int64 BytesAtCompletion;
+		bool bCompleted;
+	};
+
+	//Streamed where the engine can, handed over at the end before 5.2, the agents see the same body either way
+	const int64 BodySize = 256 * 1024;
+	TSharedRef<FStreamRun> Run = MakeShared<FStreamRun>();
+
+	FSimpleHttpResponseDelegate Delegate;
+	Delegate.SimpleStreamEventDelegate.BindLambda([Run](const FSimpleHttpStreamEvent &Event)
+	{
+		Run->ReceivedBytes += Event.Chunk.Num();
+		Run->Dropped += Event.Dropped;
+	});
+	Delegate.AllTasksCompletedDelegate.BindLambda([Run]()
+	{
+		Run->bCompleted = true;
+		Run->BytesAtCompletion = Run->ReceivedBytes;
+	});
+
+#if !(ENGINE_MAJOR_VERSION > 5 || (ENGINE_MAJOR_VERSION == 5 && ENGINE_MINOR_VERSION >= 2))
+	AddExpectedError(TEXT("can not read a body while it arrives"), EAutomationExpectedErrorFlags::Contains, 1);
+#endif
+	if (!TestTrue(TEXT("The stream starts"), SIMPLE_HTTP.GetStream(Delegate, Server->GetURL(FString::Printf(TEXT("/bytes/%lld/Stream.bin"), BodySize)), false)))
+	{
+		return false;
+	}
+
+	FAutomationTestBase *TestPtr = this;
+	WaitForManager([Run]() { return Run->bCompleted; }, 30.0, [TestPtr, Run, BodySize]()
+	{
+		TestPtr->TestTrue(TEXT("The handle completed"), Run->bCompleted);
+		TestPtr->TestEqual(TEXT("The whole body reached the stream agent"), Run->ReceivedBytes, BodySize);
+		TestPtr->TestEqual(TEXT("It did so before the handle completed"), Run->BytesAtCompletion, BodySize);
+		TestPtr->TestEqual(TEXT("Nothing is dropped while the game thread keeps up"), Run->Dropped, 0);
+	});
+
+	return true;
+}
+#endif
+
+#endif
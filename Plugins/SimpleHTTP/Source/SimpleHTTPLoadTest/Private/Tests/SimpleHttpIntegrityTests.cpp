@@ -0,0 +1,114 @@
+// Copyright (C) RenZhai.2020.All Rights Reserved.
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+#include "Tests/SimpleHttpTestUtils.h"
+#include "Core/SimpleHttpIntegrity.h"
+#include "Core/SimpleHttpSyntheticResponse.h"
+
+/**
+ * Download checks against published digests of "abc", and the two header forms servers announce them in.
+ */
+namespace SimpleHTTP
+{
+	namespace IntegrityTests
+	{
+		static const TCHAR* MD5OfABC = TEXT("900150983cd24fb0d6963f7d28e17f72");
+		static const TCHAR* SHA1OfABC = TEXT("a9993e364706816aba3e25717850c26c9cd0d89d");
+
+		static TArray<uint8> GetABC()
+		{
+			return TArray<uint8>(reinterpret_cast<const uint8*>("abc"), 3);
+		}
+
+		static FHttpResponsePtr MakeResponse(TMap<FString, FString> &&Headers)
+		{
+			return MakeShared<FSimpleHttpSyntheticResponse, ESPMode::ThreadSafe>(TEXT("http://localhost/abc"), 200, MoveTemp(Headers), GetABC());
+		}
+
+		/*Hex comes back in whichever case the encoder writes, it is compared the way VerifyHash compares it*/
+		static bool HashFromHeadersIs(TMap<FString, FString> &&Headers, const FString &Expected)
+		{
+			return Integrity::GetHashFromHeaders(MakeResponse(MoveTemp(Headers))).Equals(Expected, ESearchCase::IgnoreCase);
+		}
+	}
+}
+
+using namespace SimpleHTTP;
+using namespace SimpleHTTP::IntegrityTests;
+using namespace SimpleHTTP::TestUtils;
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSimpleHttpVerifyHashTest, "SimpleHTTP.Integrity.VerifyHash", TestFlags)
+bool FSimpleHttpVerifyHashTest::RunTest(const FString &Parameters)
+{
+	const TArray<uint8> Content = GetABC();
+	FString Error;
+
+	TestTrue(TEXT("md5 matches"), Integrity::VerifyHash(Content, FString(TEXT("md5:")) + MD5OfABC, Error));
+	TestTrue(TEXT("sha1 matches"), Integrity::VerifyHash(Content, FString(TEXT("sha1:")) + SHA1OfABC, Error));
+	TestTrue(TEXT("Hex and algorithm compare case-insensitively"), Integrity::VerifyHash(Content, FString(TEXT(" MD5 : ")) + FString(MD5OfABC).ToUpper(), Error));
+
+	TestTrue(TEXT("blake3 round trips"), Integrity::VerifyHash(Content, TEXT("blake3:") + Integrity::HashContent(Content, TEXT("blake3")), Error));
+	TestTrue(TEXT("xxhash64 round trips"), Integrity::VerifyHash(Content, TEXT("xxhash64:") + Integrity::HashContent(Content, TEXT("xxhash64")), Error));
+
+	const TArray<uint8> Other(reinterpret_cast<const uint8*>("abd"), 3);
+	Error.Reset();
+	TestFalse(TEXT("A different body fails"), Integrity::VerifyHash(Other, FString(TEXT("md5:")) + MD5OfABC, Error));
+	TestTrue(TEXT("A mismatch names both digests"), Error.Contains(MD5OfABC));
+
+	Error.Reset();
+	TestFalse(TEXT("A hash without an algorithm fails"), Integrity::VerifyHash(Content, MD5OfABC, Error));
+	TestFalse(TEXT("A malformed hash says why"), Error.IsEmpty());
+
+	Error.Reset();
+	TestFalse(TEXT("An unknown algorithm fails"), Integrity::VerifyHash(Content, TEXT("crc32:352441c2"), Error));
+	TestTrue(TEXT("An unknown algorithm is named"), Error.Contains(TEXT("crc32")));
+
+	//Checks gathered for a download, in the order the worker runs them
+	Integrity::FContentCheck Check;
+	TestTrue(TEXT("Nothing to check"), Check.IsEmpty() && Check.Run(Content, Error));
+
+	Check.Size = 4;
+	TestFalse(TEXT("Size is held"), Check.Run(Content, Error));
+
+	Check.Size = 3;
+	Check.Hash = FString(TEXT("sha1:")) + SHA1OfABC;
+	Check.HeaderHash = TEXT("md5:00000000000000000000000000000000");
+	TestFalse(TEXT("The header hash is held too"), Check.Run(Content, Error));
+
+	Check.HeaderHash = FString(TEXT("md5:")) + MD5OfABC;
+	TestTrue(TEXT("Every check passes"), Check.Run(Content, Error));
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSimpleHttpHashFromHeadersTest, "SimpleHTTP.Integrity.GetHashFromHeaders", TestFlags)
+bool FSimpleHttpHashFromHeadersTest::RunTest(const FString &Parameters)
+{
+	const FString MD5 = FString(TEXT("md5:")) + MD5OfABC;
+	const FString SHA1 = FString(TEXT("sha1:")) + SHA1OfABC;
+
+	TestEqual(TEXT("No response"), Integrity::GetHashFromHeaders(nullptr), FString());
+	TestTrue(TEXT("No hash header"), HashFromHeadersIs({}, FString()));
+
+	TestTrue(TEXT("Content-MD5"), HashFromHeadersIs({ { TEXT("Content-MD5"), TEXT(" kAFQmDzST7DWlj99KOF/cg== ") } }, MD5));
+
+	TestTrue(TEXT("Digest sha"), HashFromHeadersIs({ { TEXT("Digest"), TEXT("SHA=qZk+NkcGgWq6PiVxeFDCbJzQ2J0=") } }, SHA1));
+
+	TestTrue(TEXT("Unknown digests are skipped"), HashFromHeadersIs({ { TEXT("Digest"), TEXT("unixsum=30637, md5=kAFQmDzST7DWlj99KOF/cg==") } }, MD5));
+
+	TestTrue(TEXT("Content-MD5 is preferred over Digest"), HashFromHeadersIs({ { TEXT("Digest"), TEXT("sha=qZk+NkcGgWq6PiVxeFDCbJzQ2J0=") }, { TEXT("Content-MD5"), TEXT("kAFQmDzST7DWlj99KOF/cg==") } }, MD5));
+
+	TestTrue(TEXT("A value that is not base64 is ignored"), HashFromHeadersIs({ { TEXT("Content-MD5"), TEXT("not base64!") } }, FString()));
+
+	//What the header announces is what the body is checked against
+	const TArray<uint8> Content = GetABC();
+	FString Error;
+	TestTrue(TEXT("Announced hash verifies"),
+		Integrity::VerifyHash(Content, Integrity::GetHashFromHeaders(MakeResponse({ { TEXT("Digest"), TEXT("sha=qZk+NkcGgWq6PiVxeFDCbJzQ2J0=") } })), Error));
+
+	return true;
+}
+
+#endif
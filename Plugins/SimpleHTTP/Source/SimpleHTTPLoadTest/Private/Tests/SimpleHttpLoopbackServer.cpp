@@ -0,0 +1,176 @@
+// Copyright (C) RenZhai.2020.All Rights Reserved.
+#include "Tests/SimpleHttpLoopbackServer.h"
+
+#if WITH_SIMPLEHTTP_LOOPBACK_SERVER
+#include "HttpServerModule.h"
+#include "IHttpRouter.h"
+#include "HttpPath.h"
+#include "HttpServerRequest.h"
+#include "HttpServerResponse.h"
+#include "Containers/Ticker.h"
+#include "Misc/CommandLine.h"
+#include "Misc/EngineVersionComparison.h"
+#include "SimpleHTTPLog.h"
+
+namespace SimpleHTTP
+{
+	namespace LoopbackServer
+	{
+		template<typename LambdaType>
+		FHttpRequestHandler MakeHandler(LambdaType &&Lambda)
+		{
+#if UE_VERSION_OLDER_THAN(5, 2, 0)
+			return FHttpRequestHandler(Forward<LambdaType>(Lambda));
+#else
+			return FHttpRequestHandler::CreateLambda(Forward<LambdaType>(Lambda));
+#endif
+		}
+
+		/*The path segment that follows Route, "/bytes/1024/a.bin" gives "1024" for "/bytes"*/
+		FString GetRouteArgument(const FHttpServerRequest &Request, const TCHAR *Route)
+		{
+			FString Path = Request.RelativePath.GetPath();
+			if (!Path.RemoveFromStart(Route))
+			{
+				return FString();
+			}
+
+			Path.RemoveFromStart(TEXT("/"));
+
+			FString Argument;
+			FString Rest;
+			return Path.Split(TEXT("/"), &Argument, &Rest) ? Argument : Path;
+		}
+
+		/*The /bytes pattern repeats every 256 bytes, so bodies are copied together from one block*/
+		const TArray<uint8> &GetBytesPattern()
+		{
+			static const TArray<uint8> Pattern = []()
+			{
+				TArray<uint8> Block;
+				Block.SetNumUninitialized(64 * 1024);
+				for (int32 i = 0; i < Block.Num(); ++i)
+				{
+					Block[i] = (uint8)(i * 31);
+				}
+				return Block;
+			}();
+
+			return Pattern;
+		}
+	}
+
+	TSharedPtr<FSimpleHttpLoopbackServer> FSimpleHttpLoopbackServer::Start(uint32 Port)
+	{
+		TSharedPtr<IHttpRouter> Router = FHttpServerModule::Get().GetHttpRouter(Port);
+		if (!Router.IsValid())
+		{
+			UE_LOG(LogSimpleHTTP, Error, TEXT("Loopback server could not bind port %u."), Port);
+			return nullptr;
+		}
+
+		TSharedPtr<FSimpleHttpLoopbackServer> Server = MakeShareable(new FSimpleHttpLoopbackServer(Port, Router));
+		Server->BindRoutes();
+
+		FHttpServerModule::Get().StartAllListeners();
+
+		UE_LOG(LogSimpleHTTP, Log, TEXT("Loopback server listening on %s."), *Server->GetURL(TEXT("/")));
+		return Server;
+	}
+
+	TSharedPtr<FSimpleHttpLoopbackServer> FSimpleHttpLoopbackServer::Get()
+	{
+		static TSharedPtr<FSimpleHttpLoopbackServer> Server;
+		if (!Server.IsValid())
+		{
+			uint32 Port = 8977;
+			FParse::Value(FCommandLine::Get(), TEXT("SimpleHttpBenchmarkPort="), Port);
+
+			Server = Start(Port);
+		}
+
+		return Server;
+	}
+
+	FSimpleHttpLoopbackServer::FSimpleHttpLoopbackServer(uint32 InPort, TSharedPtr<IHttpRouter> InRouter)
+		:Port(InPort)
+		,Router(InRouter)
+	{
+	}
+
+	FSimpleHttpLoopbackServer::~FSimpleHttpLoopbackServer()
+	{
+		for (const auto &Tmp : Routes)
+		{
+			Router->UnbindRoute(Tmp);
+		}
+	}
+
+	FString FSimpleHttpLoopbackServer::GetURL(const FString &Path) const
+	{
+		return FString::Printf(TEXT("http://127.0.0.1:%u%s"), Port, *Path);
+	}
+
+	void FSimpleHttpLoopbackServer::BindRoutes()
+	{
+		using namespace LoopbackServer;
+
+		Routes.Add(Router->BindRoute(FHttpPath(TEXT("/bytes")), EHttpServerRequestVerbs::VERB_GET, MakeHandler(
+			[](const FHttpServerRequest &Request, const FHttpResultCallback &OnComplete)
+			{
+				const int64 Size = FMath::Clamp<int64>(FCString::Atoi64(*GetRouteArgument(Request, TEXT("/bytes"))), 0, MaxBodySize);
+
+				const TArray<uint8> &Pattern = GetBytesPattern();
+
+				TArray<uint8> Body;
+				Body.SetNumUninitialized(Size);
+				for (int64 Offset = 0; Offset < Size; Offset += Pattern.Num())
+				{
+					FMemory::Memcpy(Body.GetData() + Offset, Pattern.GetData(), FMath::Min<int64>(Pattern.Num(), Size - Offset));
+				}
+
+				OnComplete(FHttpServerResponse::Create(MoveTemp(Body), TEXT("application/octet-stream")));
+				return true;
+			})));
+
+		Routes.Add(Router->BindRoute(FHttpPath(TEXT("/upload")), EHttpServerRequestVerbs::VERB_PUT, MakeHandler(
+			[](const FHttpServerRequest &Request, const FHttpResultCallback &OnComplete)
+			{
+				OnComplete(FHttpServerResponse::Create(FString::Printf(TEXT("%d"), Request.Body.Num()), TEXT("text/plain")));
+				return true;
+			})));
+
+		Routes.Add(Router->BindRoute(FHttpPath(TEXT("/echo")), EHttpServerRequestVerbs::VERB_POST, MakeHandler(
+			[](const FHttpServerRequest &Request, const FHttpResultCallback &OnComplete)
+			{
+				TArray<uint8> Body = Request.Body;
+				OnComplete(FHttpServerResponse::Create(MoveTemp(Body), TEXT("application/octet-stream")));
+				return true;
+			})));
+
+		Routes.Add(Router->BindRoute(FHttpPath(TEXT("/status")), EHttpServerRequestVerbs::VERB_GET, MakeHandler(
+			[](const FHttpServerRequest &Request, const FHttpResultCallback &OnComplete)
+			{
+				TUniquePtr<FHttpServerResponse> Response = MakeUnique<FHttpServerResponse>();
+				Response->Code = (EHttpServerResponseCodes)FMath::Clamp(FCString::Atoi(*GetRouteArgument(Request, TEXT("/status"))), 100, 599);
+
+				OnComplete(MoveTemp(Response));
+				return true;
+			})));
+
+		Routes.Add(Router->BindRoute(FHttpPath(TEXT("/delay")), EHttpServerRequestVerbs::VERB_GET, MakeHandler(
+			[](const FHttpServerRequest &Request, const FHttpResultCallback &OnComplete)
+			{
+				const float DelaySeconds = FMath::Max(FCString::Atof(*GetRouteArgument(Request, TEXT("/delay"))), 0.f) / 1000.f;
+
+				FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateLambda([OnComplete](float)
+				{
+					OnComplete(FHttpServerResponse::Ok());
+					return false;
+				}), DelaySeconds);
+
+				return true;
+			})));
+	}
+}
+#endif
@@ -0,0 +1,54 @@
+// Copyright (C) RenZhai.2020.All Rights Reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+
+#if WITH_SIMPLEHTTP_LOOPBACK_SERVER
+#include "HttpRouteHandle.h"
+
+class IHttpRouter;
+
+namespace SimpleHTTP
+{
+	/**
+	 * In-process HTTP server on 127.0.0.1 that benchmarks and load tests run against.
+	 *
+	 * GET  /bytes/<Size>[/<Name>]		Size bytes of a fixed pattern, Name only makes file names distinct.
+	 * PUT  /upload[/...]				Accepts any body, answers with its size.
+	 * POST /echo[/...]					Answers with the request body.
+	 * GET  /status/<Code>				Answers with Code and an empty body.
+	 * GET  /delay/<Milliseconds>		Answers 200 after the delay, without holding the game thread.
+	 *
+	 * Served from the core ticker, so the owning thread has to tick it like the client.
+	 */
+	class FSimpleHttpLoopbackServer
+	{
+	public:
+		/*Null when the port can not be bound*/
+		static TSharedPtr<FSimpleHttpLoopbackServer> Start(uint32 Port);
+
+		/*The server the tests share, started on first use on port 8977 or -SimpleHttpBenchmarkPort=*/
+		static TSharedPtr<FSimpleHttpLoopbackServer> Get();
+
+		~FSimpleHttpLoopbackServer();
+
+		/*Absolute URL of Path on this server*/
+		FString GetURL(const FString &Path) const;
+
+		FORCEINLINE uint32 GetPort() const { return Port; }
+
+		/*Largest body /bytes serves*/
+		static const int64 MaxBodySize = 256 * 1024 * 1024;
+
+	private:
+		FSimpleHttpLoopbackServer(uint32 InPort, TSharedPtr<IHttpRouter> InRouter);
+
+		void BindRoutes();
+
+	private:
+		uint32 Port;
+		TSharedPtr<IHttpRouter> Router;
+		TArray<FHttpRouteHandle> Routes;
+	};
+}
+#endif
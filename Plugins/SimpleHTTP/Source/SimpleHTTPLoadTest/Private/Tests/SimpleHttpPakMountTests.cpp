@@ -0,0 +1,193 @@
+// Copyright (C) RenZhai.2020.All Rights Reserved.
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+#include "Tests/SimpleHttpTestUtils.h"
+#include "Core/SimpleHttpPakMount.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+
+#if WITH_SIMPLEHTTP_LOOPBACK_SERVER
+#include "Tests/SimpleHttpLoopbackServer.h"
+#endif
+
+/**
+ * The structural container checks on files written here, and, against the loopback server,
+ * that a container whose parts fail or are cancelled is reported once and before its handle completes.
+ */
+namespace SimpleHTTP
+{
+	namespace PakMountTests
+	{
+		/*FPakInfo::PakFile_Magic as it is stored*/
+		static const uint8 PakMagic[] = { 0xE1, 0x12, 0x6F, 0x5A };
+
+		/*Size zero bytes with the pak magic at MagicOffset, none when it is negative*/
+		static bool WriteFile(const FString &Filename, int32 Size, int32 MagicOffset)
+		{
+			TArray<uint8> Content;
+			Content.SetNumZeroed(Size);
+			if (MagicOffset >= 0)
+			{
+				FMemory::Memcpy(Content.GetData() + MagicOffset, PakMagic, sizeof(PakMagic));
+			}
+
+			return FFileHelper::SaveArrayToFile(Content, *Filename);
+		}
+
+#if WITH_SIMPLEHTTP_LOOPBACK_SERVER
+		/*A handle is done when AllTasksCompleted fires, by then every container has to be reported*/
+		struct FPakMountRun
+		{
+			FPakMountRun()
+				:bCompleted(false)
+				,EventsAtCompletion(INDEX_NONE)
+			{}
+
+			TArray<FSimpleHttpPakMountEvent> Events;
+			bool bCompleted;
+			int32 EventsAtCompletion;
+		};
+
+		static FSimpleHttpResponseDelegate MakeDelegate(const TSharedRef<FPakMountRun> &Run)
+		{
+			FSimpleHttpResponseDelegate Delegate;
+			Delegate.RequestOptions.bMountPaks = true;
+			Delegate.SimplePakMountDelegate.BindLambda([Run](const FSimpleHttpPakMountEvent &PakMountEvent)
+			{
+				Run->Events.Add(PakMountEvent);
+			});
+			Delegate.AllTasksCompletedDelegate.BindLambda([Run]()
+			{
+				Run->bCompleted = true;
+				Run->EventsAtCompletion = Run->Events.Num();
+			});
+
+			return Delegate;
+		}
+
+		/*Waits for the handle, then holds the run to one unmounted container whose error contains Error*/
+		static void WaitAndCheck(FAutomationTestBase &Test, const TSharedRef<FPakMountRun> &Run, const FString &Error, const FString &TempDir)
+		{
+			FAutomationTestBase *TestPtr = &Test;
+			TestUtils::WaitForManager([Run]() { return Run->bCompleted; }, 30.0, [TestPtr, Run, Error, TempDir]()
+			{
+				TestPtr->TestTrue(TEXT("The handle completed"), Run->bCompleted);
+				TestPtr->TestEqual(TEXT("The container is reported once"), Run->Events.Num(), 1);
+				TestPtr->TestEqual(TEXT("The container is reported before the handle completes"), Run->EventsAtCompletion, 1);
+
+				if (Run->Events.Num() > 0)
+				{
+					TestPtr->TestFalse(TEXT("The container is not mounted"), Run->Events[0].bMounted);
+					TestPtr->TestTrue(FString::Printf(TEXT("[%s] says why"), *Run->Events[0].Error), Run->Events[0].Error.Contains(Error));
+				}
+
+				IFileManager::Get().DeleteDirectory(*TempDir, false, true);
+			});
+		}
+#endif
+	}
+}
+
+using namespace SimpleHTTP;
+using namespace SimpleHTTP::PakMountTests;
+using namespace SimpleHTTP::TestUtils;
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSimpleHttpPakMountVerifyContainerTest, "SimpleHTTP.PakMount.VerifyContainer", TestFlags)
+bool FSimpleHttpPakMountVerifyContainerTest::RunTest(const FString &Parameters)
+{
+	const FString TempDir = GetTempDir(TEXT("VerifyContainer"));
+	IFileManager::Get().DeleteDirectory(*TempDir, false, true);
+
+	TestTrue(TEXT(".utoc is a part"), PakMount::IsContainerPart(TEXT("Chunk1.utoc")));
+	TestFalse(TEXT(".sig is not a part"), PakMount::IsContainerPart(TEXT("Chunk1.sig")));
+	TestEqual(TEXT(".ucas belongs to its .pak"), PakMount::GetPakFilename(TEXT("Chunk1.ucas")), FString(TEXT("Chunk1.pak")));
+
+	FString Error;
+	TestFalse(TEXT("A missing .pak fails"), PakMount::VerifyContainer(TempDir / TEXT("Missing.pak"), Error));
+
+	WriteFile(TempDir / TEXT("Footer.pak"), 4096, 4096 - 221);
+	TestTrue(TEXT("A .pak with a footer passes"), PakMount::VerifyContainer(TempDir / TEXT("Footer.pak"), Error));
+
+	WriteFile(TempDir / TEXT("NoFooter.pak"), 4096, -1);
+	TestFalse(TEXT("A .pak without a footer fails"), PakMount::VerifyContainer(TempDir / TEXT("NoFooter.pak"), Error));
+
+	WriteFile(TempDir / TEXT("Truncated.pak"), 4096, 16);
+	TestFalse(TEXT("A magic far from the end is not a footer"), PakMount::VerifyContainer(TempDir / TEXT("Truncated.pak"), Error));
+
+	WriteFile(TempDir / TEXT("Small.pak"), 64, 40);
+	TestTrue(TEXT("A .pak smaller than the footer search passes"), PakMount::VerifyContainer(TempDir / TEXT("Small.pak"), Error));
+
+	//IoStore parts beside the .pak
+	const FString PakFile = TempDir / TEXT("IoStore.pak");
+	WriteFile(PakFile, 4096, 4000);
+
+	FFileHelper::SaveStringToFile(TEXT("not a table of contents"), *FPaths::ChangeExtension(PakFile, TEXT("utoc")));
+	TestFalse(TEXT("A foreign .utoc fails"), PakMount::VerifyContainer(PakFile, Error));
+
+	TArray<uint8> Toc;
+	Toc.Append(reinterpret_cast<const uint8*>("-==--==--==--==-"), 16);
+	Toc.AddZeroed(128);
+	FFileHelper::SaveArrayToFile(Toc, *FPaths::ChangeExtension(PakFile, TEXT("utoc")));
+	TestFalse(TEXT("A .utoc without its .ucas fails"), PakMount::VerifyContainer(PakFile, Error));
+
+	WriteFile(FPaths::ChangeExtension(PakFile, TEXT("ucas")), 128, -1);
+	TestTrue(TEXT("A whole IoStore container passes"), PakMount::VerifyContainer(PakFile, Error));
+
+	IFileManager::Get().DeleteDirectory(*TempDir, false, true);
+	return true;
+}
+
+#if WITH_SIMPLEHTTP_LOOPBACK_SERVER
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSimpleHttpPakMountFailedPartTest, "SimpleHTTP.PakMount.FailedPartIsReported", TestFlags)
+bool FSimpleHttpPakMountFailedPartTest::RunTest(const FString &Parameters)
+{
+	TSharedPtr<FSimpleHttpLoopbackServer> Server = FSimpleHttpLoopbackServer::Get();
+	if (!Server.IsValid())
+	{
+		AddError(TEXT("Loopback server is not running."));
+		return false;
+	}
+
+	const FString TempDir = GetTempDir(TEXT("FailedPart"));
+	TSharedRef<FPakMountRun> Run = MakeShared<FPakMountRun>();
+
+	SIMPLE_HTTP.GetObjectsToLocal(MakeDelegate(Run),
+		{ Server->GetURL(TEXT("/bytes/64/Chunk1.utoc")), Server->GetURL(TEXT("/status/404/Chunk1.pak")) },
+		TempDir);
+
+	WaitAndCheck(*this, Run, TEXT("not stored"), TempDir);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSimpleHttpPakMountCancelTest, "SimpleHTTP.PakMount.CancelIsReported", TestFlags)
+bool FSimpleHttpPakMountCancelTest::RunTest(const FString &Parameters)
+{
+	TSharedPtr<FSimpleHttpLoopbackServer> Server = FSimpleHttpLoopbackServer::Get();
+	if (!Server.IsValid())
+	{
+		AddError(TEXT("Loopback server is not running."));
+		return false;
+	}
+
+	const FString TempDir = GetTempDir(TEXT("CancelledPart"));
+	TSharedRef<FPakMountRun> Run = MakeShared<FPakMountRun>();
+
+	//One connection, so the .pak is still queued behind the slow .utoc when the handle is cancelled
+	FSimpleHttpResponseDelegate Delegate = MakeDelegate(Run);
+	Delegate.RequestOptions.MaxConnectionsPerHost = 1;
+
+	SIMPLE_HTTP.GetObjectsToLocal(Delegate,
+		{ Server->GetURL(TEXT("/delay/5000/Chunk2.utoc")), Server->GetURL(TEXT("/bytes/64/Chunk2.pak")) },
+		TempDir);
+
+	//Only this handle, other tests may share the manager
+	SIMPLE_HTTP.Cancel(SIMPLE_HTTP.GetHandleByLastExecutionRequest());
+
+	WaitAndCheck(*this, Run, TEXT("cancelled"), TempDir);
+	return true;
+}
+#endif
+
+#endif
@@ -0,0 +1,60 @@
+// Copyright (C) RenZhai.2020.All Rights Reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+#include "SimpleHTTPManage.h"
+#include "Misc/Paths.h"
+#include "Misc/App.h"
+
+/**
+ * What the SimpleHTTP tests share: their flags, their scratch directories and the wait on the manager.
+ */
+namespace SimpleHTTP
+{
+	namespace TestUtils
+	{
+		/*Functional tests, they run in the editor and in clients*/
+		static const EAutomationTestFlags::Type TestFlags = (EAutomationTestFlags::Type)(
+			EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::EngineFilter);
+
+		/*Benchmarks, kept out of the functional runs*/
+		static const EAutomationTestFlags::Type PerfTestFlags = (EAutomationTestFlags::Type)(
+			EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::PerfFilter);
+
+		/*Saved/Automation/SimpleHTTP/Temp/<Name>, the test removes it when it is done*/
+		inline FString GetTempDir(const TCHAR *Name)
+		{
+			return FPaths::ProjectSavedDir() / TEXT("Automation/SimpleHTTP/Temp") / Name;
+		}
+
+		/*Without PLATFORM_PROJECT the manager is not a tickable object and nothing else ticks it in a test*/
+		inline void TickManager()
+		{
+#ifndef PLATFORM_PROJECT
+			FSimpleHttpManage::Get()->Tick(FApp::GetDeltaTime());
+#endif
+		}
+
+		/*Ticks the manager every frame until IsDone says so or TimeoutSeconds pass, then runs Then*/
+		inline void WaitForManager(TFunction<bool()> IsDone, double TimeoutSeconds, TFunction<void()> Then)
+		{
+			const double StartTime = FPlatformTime::Seconds();
+			ADD_LATENT_AUTOMATION_COMMAND(FFunctionLatentCommand([IsDone, TimeoutSeconds, Then, StartTime]()
+			{
+				TickManager();
+
+				if (!IsDone() && FPlatformTime::Seconds() - StartTime < TimeoutSeconds)
+				{
+					return false;
+				}
+
+				Then();
+				return true;
+			}));
+		}
+	}
+}
+#endif
@@ -0,0 +1,163 @@
+// Copyright (C) RenZhai.2020.All Rights Reserved.
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+#include "Tests/SimpleHttpTestUtils.h"
+#include "Core/SimpleHTTPMethod.h"
+
+/**
+ * The vector encoder against a plain byte loop written from the documented character sets.
+ * Every byte value is tried at every position of buffers around the 16 byte block, so a lane
+ * the vector path gets wrong shows up whichever side of a block edge it falls on.
+ */
+namespace SimpleHTTP
+{
+	namespace URLEncodingTests
+	{
+		static bool IsUnreserved(uint8 Byte)
+		{
+			return (Byte >= 'A' && Byte <= 'Z') || (Byte >= 'a' && Byte <= 'z') || (Byte >= '0' && Byte <= '9')
+				|| Byte == '-' || Byte == '_' || Byte == '.' || Byte == '~';
+		}
+
+		static bool IsHex(uint8 Byte)
+		{
+			return (Byte >= '0' && Byte <= '9') || (Byte >= 'A' && Byte <= 'F') || (Byte >= 'a' && Byte <= 'f');
+		}
+
+		static FString ReferenceEncode(const TArray<uint8> &Bytes, ESimpleURLEncoding Encoding)
+		{
+			static const TCHAR* HexChars = TEXT("0123456789ABCDEF");
+
+			FString Result;
+			for (int32 i = 0; i < Bytes.Num(); ++i)
+			{
+				const uint8 Byte = Bytes[i];
+
+				bool bKeep = IsUnreserved(Byte);
+				if (Encoding == ESimpleURLEncoding::URL)
+				{
+					bKeep |= FCString::Strchr(TEXT("+=:/#@?&"), (TCHAR)Byte) != nullptr && Byte != 0;
+					bKeep |= Byte == '%' && i + 2 < Bytes.Num() && IsHex(Bytes[i + 1]) && IsHex(Bytes[i + 2]);
+				}
+
+				if (bKeep)
+				{
+					Result.AppendChar((TCHAR)Byte);
+				}
+				else if (Byte == ' ' && Encoding == ESimpleURLEncoding::Form)
+				{
+					Result.AppendChar(TEXT('+'));
+				}
+				else if (Byte != 0)
+				{
+					Result.AppendChar(TEXT('%'));
+					Result.AppendChar(HexChars[Byte >> 4]);
+					Result.AppendChar(HexChars[Byte & 0xF]);
+				}
+			}
+
+			return Result;
+		}
+
+		/*Encodes through both output widths and holds them, and the predicted length, against the reference*/
+		static bool CheckParity(FAutomationTestBase &Test, const TArray<uint8> &Bytes, ESimpleURLEncoding Encoding)
+		{
+			const FString Expected = ReferenceEncode(Bytes, Encoding);
+			const UTF8CHAR* Input = reinterpret_cast<const UTF8CHAR*>(Bytes.GetData());
+
+			const int32 Length = GetURLEncodedLength(Input, Bytes.Num(), Encoding);
+
+			TArray<TCHAR> Wide;
+			Wide.SetNumZeroed(Bytes.Num() * 3 + 1);
+			const int32 WideLength = URLEncodeTo(Input, Bytes.Num(), Encoding, Wide.GetData());
+
+			TArray<ANSICHAR> Narrow;
+			Narrow.SetNumZeroed(Bytes.Num() * 3 + 1);
+			const int32 NarrowLength = URLEncodeTo(Input, Bytes.Num(), Encoding, Narrow.GetData());
+
+			const bool bMatch = Length == Expected.Len()
+				&& WideLength == Expected.Len()
+				&& NarrowLength == Expected.Len()
+				&& Expected.Equals(FString(WideLength, Wide.GetData()), ESearchCase::CaseSensitive)
+				&& Expected.Equals(FString(NarrowLength, Narrow.GetData()), ESearchCase::CaseSensitive);
+
+			if (!bMatch)
+			{
+				FString Hex = BytesToHex(Bytes.GetData(), Bytes.Num());
+				Test.AddError(FString::Printf(TEXT("Encoding %d of %s: expected %s (%d), length %d, wide %d, narrow %d."),
+					(int32)Encoding, *Hex, *Expected, Expected.Len(), Length, WideLength, NarrowLength));
+			}
+
+			return bMatch;
+		}
+	}
+}
+
+using namespace SimpleHTTP;
+using namespace SimpleHTTP::URLEncodingTests;
+using namespace SimpleHTTP::TestUtils;
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSimpleHttpURLEncodingParityTest, "SimpleHTTP.URLEncoding.VectorScalarParity", TestFlags)
+bool FSimpleHttpURLEncodingParityTest::RunTest(const FString &Parameters)
+{
+	const ESimpleURLEncoding Encodings[] = { ESimpleURLEncoding::URL, ESimpleURLEncoding::Component, ESimpleURLEncoding::Form };
+	const int32 Lengths[] = { 1, 2, 15, 16, 17, 31, 32, 33, 47, 48, 49 };
+
+	for (ESimpleURLEncoding Encoding : Encodings)
+	{
+		//One byte value at a time in a run of kept characters that are not hex digits
+		for (int32 Length : Lengths)
+		{
+			for (int32 Position = 0; Position < Length; ++Position)
+			{
+				for (int32 Value = 0; Value < 256; ++Value)
+				{
+					TArray<uint8> Bytes;
+					Bytes.Init('z', Length);
+					Bytes[Position] = (uint8)Value;
+
+					if (!CheckParity(*this, Bytes, Encoding))
+					{
+						return false;
+					}
+				}
+			}
+		}
+
+		//Every byte value side by side, starting at each offset into a block
+		for (int32 Offset = 0; Offset < 16; ++Offset)
+		{
+			TArray<uint8> Bytes;
+			Bytes.Init('z', Offset);
+			for (int32 Value = 0; Value < 256; ++Value)
+			{
+				Bytes.Add((uint8)Value);
+			}
+
+			if (!CheckParity(*this, Bytes, Encoding))
+			{
+				return false;
+			}
+		}
+
+		//Escapes that a whole URL keeps, across a block edge
+		for (int32 Offset = 12; Offset < 20; ++Offset)
+		{
+			TArray<uint8> Bytes;
+			Bytes.Init('z', Offset);
+			Bytes.Append(reinterpret_cast<const uint8*>("%2Fa%zz%4"), 9);
+			Bytes.Append(reinterpret_cast<const uint8*>("abcdefghijklmnop"), 16);
+
+			if (!CheckParity(*this, Bytes, Encoding))
+			{
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+#endif
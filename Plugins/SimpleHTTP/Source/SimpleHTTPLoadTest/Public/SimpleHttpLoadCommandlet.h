@@ -0,0 +1,30 @@
+// Copyright (C) RenZhai.2020.All Rights Reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "SimpleHttpLoadCommandlet.generated.h"
+
+/**
+ * Drives virtual users through the SimpleHTTP API and reports throughput, errors, latency percentiles and memory growth.
+ *
+ * UnrealEditor-Cmd <Project> -run=SimpleHttpLoad [-Users=16] [-Rate=100] [-Duration=30] [-URL=http://host:port]
+ *     [-Port=8978] [-Script=Mix.json] [-Report=Result.json] [-MaxErrorRate=0.0]
+ *
+ * Without -URL the requests go to the in-process loopback server.
+ * -Rate is the target across all users in requests per second, 0 lets every user send as soon as its last request is back.
+ * The script is {"requests":[{"verb":"GET","path":"/bytes/1024/a","weight":5,"body":"..."},...]}, a request is
+ * picked by weight each time a user is free. Paths are relative to -URL.
+ * The commandlet fails when the error rate, a fraction from 0 to 1, goes above -MaxErrorRate. By default any failed
+ * request fails the run, pass -MaxErrorRate=0.01 or similar against a server that is expected to drop some.
+ */
+UCLASS()
+class USimpleHttpLoadCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	USimpleHttpLoadCommandlet();
+
+	virtual int32 Main(const FString &Params) override;
+};
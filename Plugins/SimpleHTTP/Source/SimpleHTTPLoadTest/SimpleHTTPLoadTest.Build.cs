@@ -0,0 +1,36 @@
+// // Copyright (C) RenZhai.2020.All Rights Reserved.
+
+using UnrealBuildTool;
+
+public class SimpleHTTPLoadTest : ModuleRules
+{
+	public SimpleHTTPLoadTest(ReadOnlyTargetRules Target) : base(Target)
+	{
+		PCHUsage = ModuleRules.PCHUsageMode.UseExplicitOrSharedPCHs;
+
+		PrivateDependencyModuleNames.AddRange(
+			new string[]
+			{
+				"Core",
+				"CoreUObject",
+				"Engine",
+				"HTTP",
+				"Json",
+				"SimpleHTTP"
+			}
+			);
+
+		//In-process server for the benchmarks and load tests, never shipped
+		bool bWithLoopbackServer = Target.Configuration != UnrealTargetConfiguration.Shipping;
+		if (bWithLoopbackServer)
+		{
+			PrivateDependencyModuleNames.AddRange(
+			new string[]
+			{
+				"HTTPServer",
+				"Projects"
+			});
+		}
+		PrivateDefinitions.Add("WITH_SIMPLEHTTP_LOOPBACK_SERVER=" + (bWithLoopbackServer ? "1" : "0"));
+	}
+}